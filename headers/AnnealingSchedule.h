@@ -0,0 +1,172 @@
+#ifndef ANNEALING_SCHEDULE_H
+#define ANNEALING_SCHEDULE_H
+
+#include <vector>
+#include <string>
+#include <utility>
+
+/**
+ * Enum class representing the cooling schedules of Simulated Annealing.
+ */
+enum class CoolingSchedule {
+    GEOMETRIC,  ///< T <- coolingFactor * T after every epoch.
+    LUNDY_MEES, ///< T <- T / (1 + beta * T), beta chosen to reach the final temperature when the budget is used up.
+    ADAPTIVE    ///< T steered towards an acceptance rate that decays from INITIAL_RATE to FINAL_RATE over the budget.
+};
+
+/**
+ * Temperature control of one annealing chain. The chain runs epochs of a fixed number of proposals at
+ * a constant temperature (a homogeneous Markov chain); the schedule only changes the temperature between
+ * epochs, from the acceptance rate of the epoch that just ended and the share of the run's budget (time or
+ * iterations, whichever runs out first) used so far.
+ *
+ * Acceptance rates count uphill moves only: downhill and neutral moves are always accepted, so they say
+ * nothing about the temperature. The temperatures are calibrated from uphill moves sampled on the start
+ * tour (Ben-Ameur): the initial temperature accepts them at the mean rate INITIAL_ACCEPTANCE, the final one
+ * accepts the smallest of them with probability FINAL_ACCEPTANCE. The epoch length is epochFactor proposals
+ * per city.
+ *
+ * The geometric and the Lundy-Mees schedules reheat when the chain is frozen: after REHEAT_EPOCHS epochs
+ * without a new best of the chain, at the final temperature or below FROZEN_RATE acceptance, the temperature
+ * is raised to the calibrated one accepting REHEAT_ACCEPTANCE of the sampled uphill moves. The adaptive
+ * schedule raises the temperature by itself whenever the acceptance rate falls below its target.
+ *
+ * Every epoch is recorded in a trace of (seconds, temperature, acceptance rate, cost). When the trace holds
+ * TRACE_CAPACITY entries every other one is dropped and only every second epoch is recorded from then on,
+ * so long runs keep an evenly thinned trace of bounded size.
+ */
+class AnnealingSchedule {
+public:
+    static constexpr int DEFAULT_EPOCH_FACTOR = 10;    ///< Proposals per city and epoch unless set otherwise.
+    static constexpr int CALIBRATION_SAMPLES = 200;    ///< Random moves sampled to calibrate the temperatures.
+    static constexpr double INITIAL_ACCEPTANCE = 0.03; ///< Share of the sampled uphill moves accepted at the start.
+    static constexpr double FINAL_ACCEPTANCE = 0.01;   ///< Probability of accepting the smallest sampled uphill move at the end.
+    static constexpr double INITIAL_RATE = 0.03;       ///< Uphill acceptance rate targeted by the adaptive schedule at the start.
+    static constexpr double FINAL_RATE = 0.0003;       ///< Uphill acceptance rate targeted by the adaptive schedule at the deadline.
+    static constexpr double FROZEN_RATE = 0.001;       ///< Uphill acceptance rate below which a chain counts as frozen.
+    static constexpr int REHEAT_EPOCHS = 50;           ///< Epochs without a new best before a frozen chain is reheated.
+    static constexpr double REHEAT_ACCEPTANCE = 0.01;  ///< Share of the sampled uphill moves accepted after a reheat.
+    static constexpr int TRACE_CAPACITY = 4096;        ///< Largest number of trace entries kept.
+
+    /**
+     * State of the chain at the end of one epoch.
+     */
+    struct EpochRecord {
+        double time = 0.0;           ///< Seconds since the start of the run.
+        double temperature = 0.0;    ///< Temperature of the epoch.
+        double acceptanceRate = 0.0; ///< Share of the epoch's uphill proposals that were accepted.
+        int cost = 0;                ///< Cost of the current tour at the end of the epoch.
+    };
+
+private:
+    CoolingSchedule type;              ///< The cooling schedule.
+    double coolingFactor;              ///< Factor of the geometric schedule.
+    long long epochLength;             ///< Proposals per epoch.
+    double initialTemperature;         ///< Calibrated start temperature.
+    double finalTemperature;           ///< Calibrated end temperature.
+    double reheatTemperature;          ///< Calibrated temperature of a reheated chain.
+    double temperature;                ///< Temperature of the current epoch.
+    long long epochCount;              ///< Epochs completed.
+    int stagnantEpochs;                ///< Epochs since the last new best.
+    int reheatCount;                   ///< Reheats since the start.
+    int traceStride;                   ///< Epochs per trace entry, doubled whenever the trace is thinned.
+    std::vector<EpochRecord> trace;    ///< Thinned per-epoch trace.
+
+public:
+    /**
+     * Constructor for AnnealingSchedule.
+     * @param type The cooling schedule.
+     * @param coolingFactor Factor of the geometric schedule, in (0, 1).
+     * @param cities The number of cities, scaling the epoch length.
+     * @param epochFactor Proposals per city and epoch.
+     */
+    AnnealingSchedule(CoolingSchedule type, double coolingFactor, int cities, int epochFactor = DEFAULT_EPOCH_FACTOR);
+
+    /**
+     * Calibrates the temperatures and starts the first epoch at the initial temperature.
+     * @param deltas Cost changes of random moves on the start tour; only the uphill ones are used.
+     */
+    void start(const std::vector<int>& deltas);
+
+    /**
+     * Ends an epoch: records it in the trace and sets the temperature of the next one.
+     * @param elapsed Seconds since the start of the run.
+     * @param progress Share of the run's budget used so far, in [0, 1].
+     * @param uphill Uphill moves proposed during the epoch.
+     * @param accepted Uphill moves accepted during the epoch.
+     * @param improved Whether the chain found a new best during the epoch.
+     * @param cost Cost of the current tour.
+     * @return True if the chain was frozen and has been reheated.
+     */
+    bool endEpoch(double elapsed, double progress, long long uphill, long long accepted, bool improved, int cost);
+
+    /**
+     * Gets the temperature of the current epoch.
+     * @return The temperature.
+     */
+    double getTemperature() const;
+
+    /**
+     * Gets the calibrated start temperature.
+     * @return The temperature.
+     */
+    double getInitialTemperature() const;
+
+    /**
+     * Gets the number of proposals per epoch.
+     * @return The epoch length.
+     */
+    long long getEpochLength() const;
+
+    /**
+     * Gets the number of completed epochs.
+     * @return The count.
+     */
+    long long getEpochCount() const;
+
+    /**
+     * Gets the number of reheats.
+     * @return The count.
+     */
+    int getReheatCount() const;
+
+    /**
+     * Retrieves the per-epoch trace.
+     * @return The recorded epochs, in order of time.
+     */
+    const std::vector<EpochRecord>& getTrace() const;
+
+    /**
+     * Computes the temperature at which sampled uphill moves are accepted at a given mean rate, by bisection.
+     * @param deltas Cost changes of sampled moves; only the uphill ones are used.
+     * @param acceptance The mean acceptance probability of the uphill moves, in (0, 1).
+     * @return The temperature, 1 if no move is uphill.
+     */
+    static double acceptanceTemperature(const std::vector<int>& deltas, double acceptance);
+
+    /**
+     * Computes the temperatures accepting uphill moves with given probabilities.
+     * @param deltas Cost changes of sampled moves; only the uphill ones are used.
+     * @param hotAcceptance Probability of the hot temperature accepting the mean uphill move.
+     * @param coldAcceptance Probability of the cold temperature accepting the smallest uphill move.
+     * @return The pair (hot, cold), cold never above hot.
+     */
+    static std::pair<double, double> temperatureRange(const std::vector<int>& deltas, double hotAcceptance, double coldAcceptance);
+
+    /**
+     * Parses the short name of a cooling schedule, as used on the command line.
+     * @param name "geometric", "lundy-mees" or "adaptive".
+     * @return The cooling schedule.
+     * @throws std::invalid_argument If the name is unknown.
+     */
+    static CoolingSchedule parseSchedule(const std::string& name);
+
+    /**
+     * Retrieves the short name of a cooling schedule, the inverse of parseSchedule().
+     * @param type The cooling schedule.
+     * @return The short name.
+     */
+    static std::string scheduleName(CoolingSchedule type);
+};
+
+#endif
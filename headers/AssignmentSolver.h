@@ -0,0 +1,43 @@
+#ifndef ASSIGNMENT_SOLVER_H
+#define ASSIGNMENT_SOLVER_H
+
+#include <vector>
+
+/**
+ * Hungarian algorithm with shortest augmenting paths for the linear assignment problem on a square
+ * row-major cost matrix, used as the relaxation of the ATSP: row i assigned to column j means city j
+ * follows city i. Forbidden arcs, such as a city following itself, are given FORBIDDEN_COST.
+ *
+ * The dual potentials are kept by the caller with index 0 as the auxiliary row and column of the classic
+ * formulation, so a solution can be repaired incrementally: when a row is freed by forbidding its arc,
+ * one augment() call of O(n^2) re-assigns it with the duals of the previous solution.
+ */
+class AssignmentSolver {
+public:
+    static constexpr long long FORBIDDEN_COST = 1LL << 40; ///< Cost of an arc that may not be assigned.
+
+    /**
+     * Assigns a free row with one shortest augmenting path. The duals must be feasible for costs and the
+     * assigned rows must be optimal for them, as after earlier augment() calls with the same costs or after
+     * forbidding the arc of the freed row.
+     * @param costs Row-major size x size cost matrix.
+     * @param size Number of rows and columns.
+     * @param row The free row.
+     * @param assignment Column of every row, -1 for free rows; updated.
+     * @param rowDual Potentials of the size + 1 rows, index 0 auxiliary; updated.
+     * @param columnDual Potentials of the size + 1 columns, index 0 auxiliary; updated.
+     * @return The cost of all assigned rows.
+     */
+    static long long augment(const std::vector<long long>& costs, int size, int row, std::vector<int>& assignment,
+                             std::vector<long long>& rowDual, std::vector<long long>& columnDual);
+
+    /**
+     * Solves the assignment problem from scratch, in O(n^3).
+     * @param costs Row-major size x size cost matrix.
+     * @param size Number of rows and columns.
+     * @return Column of every row in an optimal assignment.
+     */
+    static std::vector<int> solve(const std::vector<long long>& costs, int size);
+};
+
+#endif
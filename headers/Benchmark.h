@@ -0,0 +1,75 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+
+#include "ExperimentRunner.h"
+
+/**
+ * Statistics over the seeds of one configuration (algorithm, time limit, cooling factor) on one instance.
+ */
+struct BenchmarkGroup {
+    std::string instanceName;               ///< NAME of the instance.
+    ExperimentAlgorithm algorithm;          ///< The solver.
+    double timeLimit = 0.0;                 ///< Time limit in seconds, 0 for untimed solvers.
+    double coolingFactor = 0.0;             ///< Cooling factor, Simulated Annealing only.
+    long long reference = -1;               ///< Cost the gaps are relative to.
+    bool referenceIsOptimum = false;        ///< True if reference is the known optimum, false if it is the best cost of all runs.
+    int runs = 0;                           ///< Successful runs.
+    int failedRuns = 0;                     ///< Runs that ended with an error.
+    double bestGap = 0.0;                   ///< Smallest gap to the reference in percent.
+    double meanGap = 0.0;                   ///< Mean gap to the reference in percent.
+    double worstGap = 0.0;                  ///< Largest gap to the reference in percent.
+    double iterationsPerSecond = 0.0;       ///< Mean solver iterations per wall-clock second.
+    std::vector<double> targetGaps;         ///< Target gaps in percent.
+    std::vector<std::vector<double>> timesToTarget; ///< Per target, sorted seconds until runs first reached it; runs that never did are left out.
+};
+
+/**
+ * Aggregation and reporting of benchmark runs: quality per wall-clock second rather than single runs.
+ * A run reaches a target gap g at the first improvement whose cost is at most reference * (1 + g / 100);
+ * the sorted times of a target form its time-to-target distribution.
+ */
+class Benchmark {
+public:
+    /**
+     * Groups results by instance and configuration and computes their statistics.
+     * @param results Results of ExperimentRunner::run.
+     * @param targetGaps Target gaps in percent for the time-to-target distributions.
+     * @return One group per instance and configuration, in the order of the results.
+     */
+    static std::vector<BenchmarkGroup> summarize(const std::vector<ExperimentResult>& results, const std::vector<double>& targetGaps);
+
+    /**
+     * Finds when a run first found a tour of at most the target cost.
+     * @param result The run.
+     * @param targetCost The target cost.
+     * @return Seconds since the start of the run, or -1 if it never reached the target.
+     */
+    static double timeToTarget(const ExperimentResult& result, long long targetCost);
+
+    /**
+     * Writes one CSV row per group and target gap, with the minimum, median, mean and maximum time to target.
+     * @param out The stream to write to.
+     * @param groups The groups.
+     */
+    static void writeCsv(std::ostream& out, const std::vector<BenchmarkGroup>& groups);
+
+    /**
+     * Writes the groups as JSON, including the full time-to-target distributions.
+     * @param out The stream to write to.
+     * @param groups The groups.
+     */
+    static void writeJson(std::ostream& out, const std::vector<BenchmarkGroup>& groups);
+
+    /**
+     * Prints a short human-readable table of the groups.
+     * @param out The stream to write to.
+     * @param groups The groups.
+     */
+    static void printSummary(std::ostream& out, const std::vector<BenchmarkGroup>& groups);
+};
+
+#endif
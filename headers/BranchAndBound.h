@@ -0,0 +1,177 @@
+#ifndef BRANCH_AND_BOUND_H
+#define BRANCH_AND_BOUND_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <utility>
+#include <cstddef>
+
+#include "DistanceMatrix.h"
+#include "ThreadPool.h"
+#include "AssignmentSolver.h"
+
+/**
+ * Class implementing an exact branch-and-bound solver for the Asymmetric Traveling Salesman Problem (ATSP).
+ * The lower bound of a node is the optimal assignment problem (AP) relaxation under the node's arc constraints,
+ * solved with the Hungarian algorithm of AssignmentSolver. A node whose assignment splits into several subtours is
+ * branched on its shortest subtour (Carpaneto-Toth scheme): child r excludes the r-th free arc of the subtour and
+ * includes the arcs before it, so the children partition the parent's solution space.
+ * Every child inherits its parent's assignment and dual variables. Excluding an assigned arc only frees one row,
+ * so the child's relaxation is re-solved with a single O(n^2) augmenting path instead of from scratch.
+ * Nodes are kept in a best-first pool expanded concurrently by the thread pool. The pool is bounded in memory:
+ * when it is full the nodes with the weakest bounds are dropped and their bound is remembered, so the reported
+ * lower bound and gap stay valid even if optimality can no longer be proven.
+ */
+class BranchAndBound {
+private:
+    /**
+     * A subproblem: the arc constraints leading to it and the solution of its assignment relaxation.
+     */
+    struct Node {
+        std::vector<std::pair<int, int>> excluded; ///< Arcs that may not be used.
+        std::vector<std::pair<int, int>> included; ///< Arcs that must be used.
+        std::vector<int> assignment;               ///< Successor of every city in the relaxation.
+        std::vector<long long> rowDual;            ///< Hungarian potentials of the rows, index 0 is auxiliary.
+        std::vector<long long> columnDual;         ///< Hungarian potentials of the columns, index 0 is auxiliary.
+        long long bound = 0;                       ///< Cost of the relaxation, a lower bound for the subproblem.
+        long long sequence = 0;                    ///< Creation order, breaks ties between equal bounds.
+
+        /**
+         * Estimates the memory held by the node.
+         * @return The size in bytes.
+         */
+        std::size_t memoryUsage() const;
+    };
+
+    std::shared_ptr<const DistanceMatrix> distanceMatrix; ///< Shared matrix of edge weights between cities.
+    int matrixSize;                                       ///< Number of cities in the matrix.
+    double maxTime;                                       ///< Time limit in seconds.
+    ThreadPool* threadPool;                               ///< Pool expanding nodes, not owned, may be nullptr.
+    std::size_t memoryCap;                                ///< Largest allowed node pool in bytes.
+    std::vector<int> bestTour;                            ///< Best tour found, the start city is repeated at the end.
+    long long bestCost;                                   ///< Cost of the best tour.
+    long long lowerBound;                                 ///< Proven lower bound on the optimal cost.
+    long long nodeCount;                                  ///< Number of relaxations solved.
+    double bestTourTimestamp;                             ///< Seconds from the start until bestTour was found.
+    std::vector<std::pair<double, int>> improvementHistory; ///< (seconds, cost) of every new best tour of the last run.
+
+    /**
+     * Builds the cost matrix of a node: the instance's matrix with forbidden entries set to FORBIDDEN_COST.
+     * @param node The node whose constraints are applied.
+     * @param costs Output row-major matrix of matrixSize * matrixSize entries.
+     */
+    void buildCosts(const Node& node, std::vector<long long>& costs) const;
+
+    /**
+     * Solves the root relaxation from scratch.
+     * @return The root node.
+     */
+    Node solveRoot() const;
+
+    /**
+     * Creates the children of a node by branching on its shortest subtour.
+     * @param parent The node to expand.
+     * @param costs Scratch buffer for the children's cost matrices.
+     * @return The children with a finite bound, in branching order.
+     */
+    std::vector<Node> branch(const Node& parent, std::vector<long long>& costs) const;
+
+    /**
+     * Splits an assignment into its cycles.
+     * @param assignment Successor of every city.
+     * @return The cycles, each listed from its smallest city.
+     */
+    static std::vector<std::vector<int>> findCycles(const std::vector<int>& assignment);
+
+public:
+    static constexpr long long FORBIDDEN_COST = AssignmentSolver::FORBIDDEN_COST; ///< Cost of arcs excluded by the constraints.
+    static constexpr std::size_t DEFAULT_MEMORY_CAP = std::size_t(1) << 30;       ///< Default node pool limit, 1 GiB.
+    static constexpr double REPORT_INTERVAL = 1.0;                               ///< Seconds between progress reports.
+
+    /**
+     * Constructor for the BranchAndBound class.
+     * @param matrix The shared matrix of edge weights between cities.
+     * @param maxTime Time limit in seconds, the best tour and the bound reached so far are kept when it expires.
+     * @param pool Thread pool expanding nodes, nullptr to run on the calling thread.
+     * @param memoryCapBytes Largest allowed node pool in bytes.
+     */
+    BranchAndBound(std::shared_ptr<const DistanceMatrix> matrix, double maxTime, ThreadPool* pool = nullptr,
+                   std::size_t memoryCapBytes = DEFAULT_MEMORY_CAP);
+
+    /**
+     * Seeds the search with a known tour, typically from GreedyAlgorithm, TabuSearch or SimulatedAnnealing.
+     * Nodes whose bound reaches its cost are pruned. Without an incumbent solve() starts from a greedy tour.
+     * @param tour The tour, open or with the start city repeated at the end.
+     * @param cost The cost of the tour.
+     */
+    void setIncumbent(const std::vector<int>& tour, int cost);
+
+    /**
+     * Runs the search until optimality is proven, the pool is exhausted or the time limit expires,
+     * printing the lower bound and gap every REPORT_INTERVAL seconds.
+     */
+    void solve();
+
+    /**
+     * Retrieves the best tour found.
+     * @return A vector representing the tour, the start city is repeated at the end.
+     */
+    std::vector<int> getBestTour() const;
+
+    /**
+     * Retrieves the cost of the best tour found.
+     * @return The cost of the best tour.
+     */
+    int getBestCost() const;
+
+    /**
+     * Retrieves the proven lower bound on the optimal cost.
+     * @return The lower bound, equal to the best cost when optimality was proven.
+     */
+    long long getLowerBound() const;
+
+    /**
+     * Retrieves the relative gap between the best tour and the lower bound.
+     * @return The gap in percent of the best cost, 0 when optimality was proven.
+     */
+    double getGap() const;
+
+    /**
+     * Checks whether the best tour was proven optimal.
+     * @return True if the lower bound reached the best cost.
+     */
+    bool isOptimal() const;
+
+    /**
+     * Retrieves the number of relaxations solved by the last run.
+     * @return The node count.
+     */
+    long long getNodeCount() const;
+
+    /**
+     * Retrieves the time when the best tour was found.
+     * @return The timestamp in seconds since the start of the search, 0 for the incumbent.
+     */
+    double getBestTourTimestamp() const;
+
+    /**
+     * Retrieves every improvement of the best tour during the last run, for time-to-target statistics.
+     * @return Pairs of (seconds since the start, cost), in order of time with strictly decreasing cost.
+     */
+    std::vector<std::pair<double, int>> getImprovementHistory() const;
+
+    /**
+     * Retrieves the number of vertices in the adjacency matrix.
+     * @return The size of the adjacency matrix.
+     */
+    int getMatrixSize() const;
+
+    /**
+     * Saves the results (number of vertices and the best tour) to a file.
+     * @param fileName The name of the file to save the results to.
+     */
+    void saveResultToFile(const std::string& fileName) const;
+};
+
+#endif
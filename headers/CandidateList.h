@@ -0,0 +1,68 @@
+#ifndef CANDIDATE_LIST_H
+#define CANDIDATE_LIST_H
+
+#include <vector>
+
+#include "DistanceMatrix.h"
+
+/**
+ * Class holding, for every city, its k nearest successors (cheapest outgoing arcs) and its k nearest
+ * predecessors (cheapest incoming arcs), sorted by distance. Both lists are stored flat, k entries
+ * per city. Built once per loaded matrix, it lets the neighbourhoods look only at moves that create
+ * at least one short arc, which turns O(n^2) scans into O(n * k).
+ */
+class CandidateList {
+private:
+    int dimension;                 ///< Number of cities.
+    int candidateCount;            ///< Number of candidates kept per city (k).
+    std::vector<int> successorList;   ///< successorList[city * k + r] is the r-th nearest successor of city.
+    std::vector<int> predecessorList; ///< predecessorList[city * k + r] is the r-th nearest predecessor of city.
+
+    /**
+     * Selects the k cheapest entries of a row of weights, ignoring the city itself.
+     * @param weights Weights indexed by city.
+     * @param city The city the row belongs to.
+     * @param target Output array of k cities, nearest first.
+     */
+    void selectNearest(const int* weights, int city, int* target) const;
+
+public:
+    /**
+     * Constructor for CandidateList.
+     * @param matrix The distance matrix. Its transposed copy is used for the predecessors when available.
+     * @param candidatesPerCity The number of candidates kept per city, clamped to n - 1.
+     */
+    CandidateList(const DistanceMatrix& matrix, int candidatesPerCity);
+
+    /**
+     * Returns the nearest successors of a city.
+     * @param city The city.
+     * @return Pointer to size() cities, nearest first.
+     */
+    const int* successors(int city) const {
+        return successorList.data() + static_cast<std::size_t>(city) * candidateCount;
+    }
+
+    /**
+     * Returns the nearest predecessors of a city.
+     * @param city The city.
+     * @return Pointer to size() cities, nearest first.
+     */
+    const int* predecessors(int city) const {
+        return predecessorList.data() + static_cast<std::size_t>(city) * candidateCount;
+    }
+
+    /**
+     * Retrieves the number of candidates kept per city.
+     * @return k.
+     */
+    int size() const;
+
+    /**
+     * Retrieves the number of cities.
+     * @return The dimension of the instance.
+     */
+    int getDimension() const;
+};
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef CONSTRUCTION_HEURISTIC_H
+#define CONSTRUCTION_HEURISTIC_H
+
+#include <vector>
+#include <string>
+#include <memory>
+
+#include "DistanceMatrix.h"
+#include "ThreadPool.h"
+
+/**
+ * Enum class representing the construction heuristics that build a start tour from scratch.
+ */
+enum class ConstructionType {
+    NEAREST_NEIGHBOR,   ///< Nearest unvisited city from every start city (GreedyAlgorithm).
+    GREEDY_EDGE,        ///< Cheapest arcs first, as long as they keep the tour a set of paths.
+    CHEAPEST_INSERTION, ///< Insert the city with the cheapest insertion into the partial tour.
+    FARTHEST_INSERTION, ///< Insert the city farthest from the partial tour at its cheapest position.
+    PATCHING            ///< Karp's patching of the cycles of the assignment problem relaxation.
+};
+
+/**
+ * Interface of a construction heuristic: builds a complete tour from the distance matrix alone,
+ * used as the initial solution of the improvement solvers.
+ */
+class ConstructionHeuristic {
+protected:
+    std::shared_ptr<const DistanceMatrix> distanceMatrix; ///< Shared matrix of edge weights between cities.
+    int matrixSize;                                       ///< Number of cities in the matrix.
+
+public:
+    /**
+     * Constructor for ConstructionHeuristic.
+     * @param matrix The shared matrix of edge weights between cities.
+     */
+    explicit ConstructionHeuristic(std::shared_ptr<const DistanceMatrix> matrix);
+
+    virtual ~ConstructionHeuristic() = default;
+
+    /**
+     * Retrieves the type of the heuristic.
+     * @return The construction type.
+     */
+    virtual ConstructionType getType() const = 0;
+
+    /**
+     * Retrieves a human readable name of the heuristic.
+     * @return The name.
+     */
+    virtual std::string getName() const = 0;
+
+    /**
+     * Builds a tour.
+     * @return The closed tour, the start city is repeated at the end; empty if the matrix is empty.
+     */
+    virtual std::vector<int> build() const = 0;
+
+    /**
+     * Calculates the cost of a closed tour.
+     * @param tour The tour, the start city is repeated at the end.
+     * @return The total cost of the tour.
+     */
+    int tourCost(const std::vector<int>& tour) const;
+
+    /**
+     * Creates a heuristic of the given type.
+     * @param type The construction type.
+     * @param matrix The shared matrix of edge weights between cities.
+     * @param pool Thread pool used by heuristics that run in parallel, may be nullptr.
+     * @return The heuristic.
+     */
+    static std::unique_ptr<ConstructionHeuristic> create(ConstructionType type, std::shared_ptr<const DistanceMatrix> matrix,
+                                                         ThreadPool* pool = nullptr);
+
+    /**
+     * Parses the short name of a construction type, as used on the command line.
+     * @param name One of "nn", "greedy-edge", "cheapest", "farthest" or "patching".
+     * @return The construction type.
+     * @throws std::invalid_argument If the name is unknown.
+     */
+    static ConstructionType parseType(const std::string& name);
+
+    /**
+     * Retrieves the short name of a construction type, the inverse of parseType().
+     * @param type The construction type.
+     * @return The short name.
+     */
+    static std::string typeName(ConstructionType type);
+};
+
+/**
+ * Nearest neighbour from every start city (or from evenly spread start cities), see GreedyAlgorithm.
+ */
+class NearestNeighborConstruction : public ConstructionHeuristic {
+private:
+    ThreadPool* threadPool; ///< Pool building the tours of different start cities, may be nullptr.
+    int startCities;        ///< Number of start cities, 0 for all.
+
+public:
+    /**
+     * Constructor for NearestNeighborConstruction.
+     * @param matrix The shared matrix of edge weights between cities.
+     * @param pool Thread pool building the tours of different start cities, may be nullptr.
+     * @param startCities Number of start cities, 0 for all.
+     */
+    NearestNeighborConstruction(std::shared_ptr<const DistanceMatrix> matrix, ThreadPool* pool = nullptr, int startCities = 0);
+
+    ConstructionType getType() const override;
+    std::string getName() const override;
+    std::vector<int> build() const override;
+};
+
+/**
+ * Greedy edge matching: arcs are taken in order of weight while every city keeps at most one successor
+ * and one predecessor and no cycle closes early (checked with union-find over the path fragments).
+ * The arcs to the k nearest successors of every city are considered first; the fragments left over are
+ * joined by the same rule over all arcs from a fragment's last to another fragment's first city.
+ * This avoids sorting all n^2 arcs: O(n^2 log k) for the candidates plus O(f^2 log f) for f fragments.
+ */
+class GreedyEdgeConstruction : public ConstructionHeuristic {
+private:
+    int candidateCount; ///< Nearest successors per city considered in the first phase.
+
+public:
+    /**
+     * Constructor for GreedyEdgeConstruction.
+     * @param matrix The shared matrix of edge weights between cities.
+     * @param candidateCount Nearest successors per city considered in the first phase.
+     */
+    explicit GreedyEdgeConstruction(std::shared_ptr<const DistanceMatrix> matrix, int candidateCount = 10);
+
+    ConstructionType getType() const override;
+    std::string getName() const override;
+    std::vector<int> build() const override;
+};
+
+/**
+ * Insertion heuristics growing a cycle from the best pair of cities. Every city outside the tour keeps its
+ * cheapest insertion arc; after an insertion only the cities whose arc was split are rescanned, all others
+ * just compare the two new arcs, so a build takes O(n^2) plus the priority queue operations.
+ * Cheapest insertion always inserts the city with the cheapest insertion (min-priority queue, starting from
+ * the cheapest 2-cycle); farthest insertion inserts the city whose nearest tour city is farthest away
+ * (max-priority queue, starting from the most expensive 2-cycle) at its cheapest position.
+ */
+class InsertionConstruction : public ConstructionHeuristic {
+private:
+    bool farthest; ///< True for farthest insertion, false for cheapest insertion.
+
+public:
+    /**
+     * Constructor for InsertionConstruction.
+     * @param matrix The shared matrix of edge weights between cities.
+     * @param farthest True for farthest insertion, false for cheapest insertion.
+     */
+    InsertionConstruction(std::shared_ptr<const DistanceMatrix> matrix, bool farthest);
+
+    ConstructionType getType() const override;
+    std::string getName() const override;
+    std::vector<int> build() const override;
+};
+
+/**
+ * Karp's patching heuristic: solves the assignment problem relaxation (Hungarian algorithm, O(n^3)), whose
+ * solution is a set of cycles with a cost that is a lower bound of the optimum, and then repeatedly patches
+ * the largest cycle with the next largest one through the cheapest exchange of one arc of each.
+ * Usually within a few percent of the optimum on asymmetric instances.
+ */
+class PatchingConstruction : public ConstructionHeuristic {
+private:
+    /**
+     * Solves the assignment problem with the city itself forbidden as successor.
+     * @return Successor of every city in the optimal assignment.
+     */
+    std::vector<int> solveAssignment() const;
+
+public:
+    using ConstructionHeuristic::ConstructionHeuristic;
+
+    ConstructionType getType() const override;
+    std::string getName() const override;
+    std::vector<int> build() const override;
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+/**
+ * Class representing the edge weights of an ATSP instance as one contiguous, cache-aligned block.
+ * Rows are stored row-major and padded to a multiple of the cache line, so every row starts on a
+ * 64-byte boundary. An optional transposed copy gives the same contiguous access to columns.
+ * Once filled, the matrix is meant to be shared read-only (std::shared_ptr<const DistanceMatrix>)
+ * between all solvers instead of being copied into each of them.
+ */
+class DistanceMatrix {
+public:
+    static constexpr std::size_t ALIGNMENT = 64;                          ///< Alignment of every row in bytes.
+    static constexpr int ROW_PADDING = ALIGNMENT / sizeof(int);           ///< Row length granularity in elements.
+
+private:
+    int dimension;                   ///< Number of cities.
+    int rowStride;                   ///< Distance between the starts of two consecutive rows, in elements.
+    std::shared_ptr<int> weights;    ///< Row-major weights, owner of the aligned storage.
+    std::shared_ptr<int> transposed; ///< Column-major copy of the weights, empty until buildTransposed() is called.
+
+    /**
+     * Allocates a zero-filled, aligned block able to hold dimension x rowStride elements.
+     * @return Shared owner of the allocated block.
+     */
+    std::shared_ptr<int> allocate() const;
+
+public:
+    /**
+     * Constructs a zero-filled matrix of the given dimension, to be filled through rowData().
+     * @param dimension The number of cities.
+     */
+    explicit DistanceMatrix(int dimension = 0);
+
+    /**
+     * Constructs the matrix from a nested adjacency matrix.
+     * @param rows The adjacency matrix, rows[from][to] is the weight of the edge from -> to.
+     */
+    explicit DistanceMatrix(const std::vector<std::vector<int>>& rows);
+
+    /**
+     * Constructs the matrix on existing storage, e.g. a memory-mapped cache file, without copying it.
+     * The storage must use the row layout of this class (stride() elements per row, ALIGNMENT-aligned).
+     * @param dimension The number of cities.
+     * @param storage Row-major weights, kept alive by the matrix.
+     * @param transposedStorage Column-major copy in the same layout, nullptr to build it later.
+     */
+    DistanceMatrix(int dimension, std::shared_ptr<int> storage, std::shared_ptr<int> transposedStorage = nullptr);
+
+    /**
+     * Computes the padded row length used for a dimension.
+     * @param dimension The number of cities.
+     * @return The row stride in elements.
+     */
+    static int strideFor(int dimension);
+
+    /**
+     * Returns the weight of the edge between two cities.
+     * @param from The source city.
+     * @param to The destination city.
+     * @return The weight of the edge from -> to.
+     */
+    int operator()(int from, int to) const {
+        return weights.get()[static_cast<std::size_t>(from) * rowStride + to];
+    }
+
+    /**
+     * Returns a pointer to the first element of a row, aligned to ALIGNMENT bytes.
+     * @param from The source city.
+     * @return Pointer to the weights of all edges leaving the city.
+     */
+    const int* row(int from) const {
+        return weights.get() + static_cast<std::size_t>(from) * rowStride;
+    }
+
+    /**
+     * Returns a writable pointer to a row. Intended only for filling the matrix before it is shared.
+     * @param from The source city.
+     * @return Pointer to the weights of all edges leaving the city.
+     */
+    int* rowData(int from) {
+        return weights.get() + static_cast<std::size_t>(from) * rowStride;
+    }
+
+    /**
+     * Returns a pointer to the first element of a column of the transposed copy.
+     * Requires buildTransposed() to have been called.
+     * @param to The destination city.
+     * @return Pointer to the weights of all edges entering the city.
+     */
+    const int* column(int to) const {
+        return transposed.get() + static_cast<std::size_t>(to) * rowStride;
+    }
+
+    /**
+     * Builds (or rebuilds) the transposed copy from the current weights.
+     */
+    void buildTransposed();
+
+    /**
+     * Checks whether the transposed copy is available.
+     * @return True if column() may be used.
+     */
+    bool hasTransposed() const;
+
+    /**
+     * Retrieves the number of cities.
+     * @return The dimension of the matrix.
+     */
+    int size() const;
+
+    /**
+     * Retrieves the padded row length.
+     * @return The number of elements between the starts of two consecutive rows.
+     */
+    int stride() const;
+
+    /**
+     * Checks whether the matrix holds no cities.
+     * @return True if the dimension is zero.
+     */
+    bool empty() const;
+};
+
+#endif
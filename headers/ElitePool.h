@@ -0,0 +1,101 @@
+#ifndef ELITE_POOL_H
+#define ELITE_POOL_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+
+#include "RandomGenerator.h"
+
+/**
+ * Fixed-size pool of the best tours found by concurrently running solvers, shared without locks.
+ * Every slot is a sequence lock: a writer claims a slot by moving its sequence number to an odd value
+ * with a compare-and-swap, copies its tour in and publishes it with the next even value; readers copy
+ * a slot optimistically and retry (or move on to another slot) when the sequence number changed meanwhile.
+ * No thread ever waits for another one, and the memory is allocated once: capacity tours of n cities.
+ * Tours are stored rotated to start at city 0, so the same cycle published twice is recognised by its
+ * cost and 64-bit fingerprint and kept only once.
+ */
+class ElitePool {
+private:
+    /**
+     * One stored tour.
+     */
+    struct Slot {
+        std::atomic<unsigned> sequence{0};       ///< Even while stable, odd while a writer copies a tour in.
+        std::atomic<int> cost;                   ///< Cost of the tour, INT_MAX while the slot is empty.
+        std::atomic<std::uint64_t> fingerprint{0}; ///< Hash of the rotated tour, for duplicate detection.
+        std::unique_ptr<std::atomic<int>[]> cities; ///< The open tour, starting at city 0.
+    };
+
+    int tourSize;                         ///< Number of cities of the stored tours.
+    int capacity;                         ///< Number of slots.
+    std::unique_ptr<Slot[]> slots;        ///< The slots.
+    std::atomic<int> bestCost;            ///< Lowest cost ever published, read without touching the slots.
+    std::atomic<long long> acceptedCount; ///< Number of publications that entered the pool.
+
+    /**
+     * Copies a slot if it holds a tour and no writer interferes.
+     * @param slot The slot.
+     * @param tour Output, the open tour.
+     * @param cost Output, its cost.
+     * @return True on success, false if the slot is empty or was being written.
+     */
+    bool readSlot(const Slot& slot, std::vector<int>& tour, int& cost) const;
+
+public:
+    /**
+     * Constructor for ElitePool.
+     * @param capacity Number of tours kept, at least 1.
+     * @param tourSize Number of cities of the tours.
+     */
+    ElitePool(int capacity, int tourSize);
+
+    /**
+     * Offers a tour to the pool. It replaces the most expensive stored tour if it is cheaper and not
+     * stored already.
+     * @param tour The open tour, in any rotation.
+     * @param cost Its cost.
+     * @return True if the tour entered the pool.
+     */
+    bool publish(const std::vector<int>& tour, int cost);
+
+    /**
+     * Draws a stored tour by binary tournament: the cheaper of two random slots, favouring good tours
+     * while still spreading the workers over the pool.
+     * @param generator Random stream of the calling worker.
+     * @param tour Output, the open tour starting at city 0.
+     * @param cost Output, its cost.
+     * @return True if a tour was copied, false if the pool is empty.
+     */
+    bool sample(RandomGenerator& generator, std::vector<int>& tour, int& cost) const;
+
+    /**
+     * Copies the cheapest stored tour.
+     * @param tour Output, the open tour starting at city 0.
+     * @param cost Output, its cost.
+     * @return True if a tour was copied, false if the pool is empty.
+     */
+    bool best(std::vector<int>& tour, int& cost) const;
+
+    /**
+     * Retrieves the lowest cost published so far, without copying a tour.
+     * @return The cost, INT_MAX if nothing was published.
+     */
+    int getBestCost() const;
+
+    /**
+     * Retrieves the number of publications that entered the pool.
+     * @return The count.
+     */
+    long long getAcceptedCount() const;
+
+    /**
+     * Retrieves the number of slots.
+     * @return The capacity.
+     */
+    int getCapacity() const;
+};
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef EXPERIMENT_RUNNER_H
+#define EXPERIMENT_RUNNER_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <ostream>
+#include <utility>
+
+#include "TsplibLoader.h"
+#include "Neighborhood.h"
+#include "CandidateList.h"
+#include "ThreadPool.h"
+#include "ConstructionHeuristic.h"
+#include "MemeticAlgorithm.h"
+#include "TabuMemory.h"
+#include "AnnealingSchedule.h"
+#include "StopCriterion.h"
+
+/**
+ * Solvers available to batch experiments.
+ */
+enum class ExperimentAlgorithm {
+    GREEDY,              ///< Nearest neighbour from every start city.
+    TABU_SEARCH,         ///< Tabu Search.
+    SIMULATED_ANNEALING, ///< Simulated Annealing, optionally with parallel chains or tempering.
+    HELD_KARP,           ///< Exact Held-Karp dynamic programming.
+    BRANCH_AND_BOUND,    ///< Exact Branch and Bound with assignment problem bounds.
+    PORTFOLIO,           ///< Tabu Search and Simulated Annealing workers sharing an elite pool on the solver threads.
+    MEMETIC              ///< Steady-state memetic algorithm building offspring batches on the solver threads.
+};
+
+/**
+ * Settings of a batch experiment, usually parsed from the command line. The experiment runs every
+ * combination of instance, algorithm, time limit, cooling factor and seed; parameters an algorithm
+ * does not use are not varied for it.
+ */
+struct ExperimentConfig {
+    std::vector<std::string> instancePaths;         ///< TSPLIB files to solve.
+    std::vector<ExperimentAlgorithm> algorithms;    ///< Solvers to run on every instance.
+    std::vector<double> timeLimits = {60.0};        ///< Time limits in seconds.
+    long long iterationLimit = 0;                   ///< Iterations (proposals of sa) ending tabu, sa and portfolio runs, 0 for none.
+    long long stallIterations = 0;                  ///< Iterations without a new best ending tabu, sa and portfolio runs, 0 for none.
+    long long targetCost = StopLimits::NO_TARGET;   ///< Cost ending tabu, sa and portfolio runs once reached, NO_TARGET for none.
+    bool targetOptimum = false;                     ///< Whether the target is the known optimum of each instance.
+    std::vector<double> coolingFactors = {0.85};    ///< Cooling factors of Simulated Annealing (also in the portfolio).
+    std::vector<unsigned> seeds = {1};              ///< Seeds, one run of each stochastic solver per seed.
+    int threadCount = 0;                            ///< Total worker threads, 0 for one per hardware thread.
+    int concurrentJobs = 0;                         ///< Jobs run at the same time, 0 for one per worker thread.
+    std::vector<NeighborhoodType> neighborhoodTypes = {NeighborhoodType::SWAP, NeighborhoodType::OR_OPT}; ///< Move types of the metaheuristics.
+    int candidateListSize = 10;                     ///< Nearest neighbours kept per city, 0 disables the candidate lists.
+    bool localSearch = false;                       ///< Whether tours are polished with the VND local search.
+    bool useConstruction = false;                   ///< Whether Tabu Search and Simulated Annealing start from construction.
+    ConstructionType construction = ConstructionType::NEAREST_NEIGHBOR; ///< Start tour heuristic, used when useConstruction is set.
+    int annealingChains = 1;                        ///< Parallel Simulated Annealing chains.
+    int temperingReplicas = 1;                      ///< Parallel tempering rungs, 1 for the cooling schedule.
+    CoolingSchedule coolingSchedule = CoolingSchedule::ADAPTIVE; ///< Cooling schedule of Simulated Annealing.
+    int epochFactor = AnnealingSchedule::DEFAULT_EPOCH_FACTOR; ///< Proposals per city in an epoch of Simulated Annealing.
+    TabuAttribute tabuAttribute = TabuAttribute::ARC; ///< Attribute made tabu by Tabu Search.
+    int tabuTenure = TabuMemory::REACTIVE_TENURE;   ///< Tabu tenure in iterations, 0 for the reactive tenure.
+    bool reactiveTabu = false;                      ///< Whether Tabu Search runs in intensification and diversification phases.
+    int tabuStagnation = 0;                         ///< Iterations without improvement that end a phase, 0 for twice the cities.
+    int populationSize = MemeticAlgorithm::DEFAULT_POPULATION_SIZE; ///< Population of the memetic algorithm.
+    CrossoverType crossover = CrossoverType::EDGE_ASSEMBLY; ///< Crossover of the memetic algorithm.
+    long memoryLimitMB = 1024L;                     ///< Memory the exact solvers may use, in MiB.
+    bool compactCache = false;                      ///< Whether new matrix caches are narrowed to 16 bits when the weights fit.
+    std::string outputPath;                         ///< CSV file of the results, empty for standard output.
+    bool showHelp = false;                          ///< Set by --help.
+};
+
+/**
+ * One run of the experiment matrix.
+ */
+struct ExperimentJob {
+    int instance;                  ///< Index into the loaded instances.
+    ExperimentAlgorithm algorithm; ///< The solver.
+    double timeLimit;              ///< Time limit in seconds.
+    double coolingFactor;          ///< Cooling factor, used by Simulated Annealing and the portfolio only.
+    unsigned seed;                 ///< Seed of the run.
+};
+
+/**
+ * Outcome of one job.
+ */
+struct ExperimentResult {
+    ExperimentJob job;         ///< The job that was run.
+    std::string instanceName;  ///< NAME of the instance.
+    int dimension = 0;         ///< Number of cities.
+    long long bestCost = -1;   ///< Cost of the best tour, -1 if the job failed.
+    long long optimum = -1;    ///< Known optimum of the instance, -1 if unknown.
+    double timeToBest = 0.0;   ///< Seconds until the best tour was found.
+    long long iterations = 0;  ///< Iterations, proposals or nodes of the solver.
+    double wallTime = 0.0;     ///< Wall-clock duration of the job in seconds.
+    bool provedOptimal = false; ///< True if an exact solver proved the tour optimal.
+    std::string error;         ///< Error message of a failed job, empty on success.
+    std::string stopReason;    ///< Why a tabu, sa or portfolio run stopped, empty for the other solvers.
+    std::vector<std::pair<double, int>> improvements; ///< (seconds, cost) of every new best tour of the run.
+};
+
+/**
+ * Non-interactive experiment runner. Loads every instance once, expands the configuration into
+ * (instance x algorithm x parameters x seed) jobs and runs them concurrently on a job pool. The
+ * remaining worker threads are split evenly into one solver pool per concurrent job, so every job's
+ * parallel sections get the same number of helpers whatever runs beside it. Solver console output
+ * is suppressed while the jobs run; progress is reported on std::cerr.
+ */
+class ExperimentRunner {
+private:
+    ExperimentConfig config;                                       ///< Settings of the experiment.
+    std::vector<TsplibInstance> instances;                         ///< Loaded instances, indexed by ExperimentJob::instance.
+    std::vector<std::shared_ptr<const CandidateList>> candidates;  ///< Candidate lists of the instances, may be empty.
+
+    /**
+     * Expands the configuration into the job list. Deterministic solvers run once per instance
+     * (Greedy, Held-Karp) or once per time limit (Branch and Bound) with the first seed.
+     * @return The jobs, grouped by instance and algorithm.
+     */
+    std::vector<ExperimentJob> buildJobs() const;
+
+    /**
+     * Runs a single job. Solver exceptions are caught and stored in the result.
+     * @param job The job.
+     * @param solverPool Pool of the job's slot for the solvers' parallel sections, nullptr to run them serially.
+     * @return The result.
+     */
+    ExperimentResult runJob(const ExperimentJob& job, ThreadPool* solverPool) const;
+
+public:
+    /**
+     * Constructor for ExperimentRunner.
+     * @param config Settings of the experiment.
+     */
+    explicit ExperimentRunner(ExperimentConfig config);
+
+    /**
+     * Parses the command line. Values of list options may be comma separated or given by repeating
+     * the option; seeds also accept ranges such as 1..30. Throws std::invalid_argument on unknown
+     * options or invalid values.
+     * @param argc Number of arguments.
+     * @param argv The arguments, argv[0] being the program name.
+     * @return The configuration.
+     */
+    static ExperimentConfig parseArguments(int argc, char* argv[]);
+
+    /**
+     * Returns the command line help text.
+     * @return The usage message.
+     */
+    static std::string usage();
+
+    /**
+     * Looks up the best known tour cost of a TSPLIB ATSP instance.
+     * @param instanceName The NAME of the instance, e.g. ftv170.
+     * @return The optimum, or -1 if the instance is not in the table.
+     */
+    static long long knownOptimum(const std::string& instanceName);
+
+    /**
+     * Returns the command line name of an algorithm.
+     * @param algorithm The algorithm.
+     * @return The name, e.g. sa.
+     */
+    static std::string algorithmName(ExperimentAlgorithm algorithm);
+
+    /**
+     * Loads the instances and runs all jobs. Throws std::runtime_error if an instance cannot be loaded.
+     * @return One result per job, in job order.
+     */
+    std::vector<ExperimentResult> run();
+
+    /**
+     * Writes results as CSV with a header row; gap_percent is relative to the known optimum.
+     * @param out The stream to write to.
+     * @param results The results.
+     */
+    static void writeCsv(std::ostream& out, const std::vector<ExperimentResult>& results);
+};
+
+#endif
@@ -3,25 +3,32 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+
+#include "DistanceMatrix.h"
+#include "CandidateList.h"
+#include "ThreadPool.h"
+#include "RandomGenerator.h"
 
 /**
  * Class implementing the Greedy Algorithm for solving the Asymmetric Traveling Salesman Problem (ATSP).
  * The algorithm starts at each city, builds a tour greedily by selecting the nearest unvisited neighbor,
  * and returns the best tour among all starting points.
+ * One construction costs O(n^2): visited cities are masked out of the current row, so choosing the next
+ * city is a branch-free min reduction the compiler vectorises. The start cities run in parallel on the
+ * thread pool, and setStartCities() bounds them for large instances.
  */
 class GreedyAlgorithm {
-private:
-    std::vector<std::vector<int>> distanceMatrix; ///< Adjacency matrix representing edge weights between cities.
-    int matrixSize;                               ///< Number of cities in the matrix.
-    std::vector<int> bestTour;                    ///< Best tour found by the algorithm.
-    int bestCost;                                 ///< Cost of the best tour.
+public:
+    static constexpr int RANDOMIZED_CHOICES = 3; ///< Cheapest unvisited successors the randomized construction chooses from.
 
-    /**
-     * Builds a greedy solution starting from a specific city.
-     * @param startCity The city from which to start the greedy algorithm.
-     * @return The greedy tour starting from the given city.
-     */
-    std::vector<int> solveFromCity(int startCity);
+private:
+    std::shared_ptr<const DistanceMatrix> distanceMatrix; ///< Shared matrix of edge weights between cities.
+    int matrixSize;                                       ///< Number of cities in the matrix.
+    std::vector<int> bestTour;                            ///< Best tour found by the algorithm.
+    int bestCost;                                         ///< Cost of the best tour.
+    ThreadPool* threadPool;                               ///< Pool building the tours of the start cities, not owned, may be nullptr.
+    int startCityCount;                                   ///< Number of start cities tried by solve(), 0 for all.
 
     /**
      * Calculates the total cost of a given tour.
@@ -33,16 +40,48 @@ private:
 public:
     /**
      * Constructor for the GreedyAlgorithm class.
-     * @param matrix The adjacency matrix representing edge weights between cities.
+     * @param matrix The shared matrix of edge weights between cities.
+     * @param pool Thread pool building the tours of different start cities, nullptr to build them on the calling thread.
+     */
+    GreedyAlgorithm(std::shared_ptr<const DistanceMatrix> matrix, ThreadPool* pool = nullptr);
+
+    /**
+     * Limits the number of start cities tried by solve(). The starts are spread evenly over the cities.
+     * @param count Number of start cities, 0 (or at least the number of cities) to try every city.
      */
-    GreedyAlgorithm(const std::vector<std::vector<int>>& matrix);
+    void setStartCities(int count);
 
     /**
      * Solves the ATSP using the greedy algorithm.
-     * Starts from each city and selects the best tour.
+     * Starts from each city (or from the cities selected by setStartCities()) and selects the best tour;
+     * ties go to the lowest start city, so the result does not depend on the number of threads.
      */
     void solve();
 
+    /**
+     * Builds a greedy solution starting from a specific city in O(n^2). Safe to call from several threads.
+     * @param startCity The city from which to start the greedy algorithm.
+     * @return The closed greedy tour starting from the given city.
+     */
+    std::vector<int> solveFromCity(int startCity) const;
+
+    /**
+     * Builds a randomized greedy solution: every step moves to one of the choices cheapest unvisited cities,
+     * drawn uniformly, so repeated calls give different tours of near-greedy quality (a restricted candidate
+     * list as in GRASP). O(n^2 * choices). Safe to call from several threads with separate generators.
+     * @param startCity The city from which to start.
+     * @param generator Random stream drawing the choices.
+     * @param choices Number of cheapest unvisited cities to choose from, 1 gives solveFromCity().
+     * @return The closed tour starting from the given city.
+     */
+    std::vector<int> solveRandomizedFromCity(int startCity, RandomGenerator& generator, int choices = RANDOMIZED_CHOICES) const;
+
+    /**
+     * Polishes the best tour with the LocalSearch (VND) engine. Call after solve().
+     * @param candidates Candidate lists restricting the local search, nullptr for full neighbourhoods.
+     */
+    void improveWithLocalSearch(const CandidateList* candidates = nullptr);
+
     /**
      * Retrieves the best tour found by the algorithm.
      * @return A vector representing the best tour.
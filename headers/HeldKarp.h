@@ -0,0 +1,87 @@
+#ifndef HELD_KARP_H
+#define HELD_KARP_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+#include "DistanceMatrix.h"
+#include "ThreadPool.h"
+
+/**
+ * Class implementing the exact Held-Karp dynamic programming algorithm for the Asymmetric Traveling Salesman Problem (ATSP).
+ * With city 0 fixed as the start, cost(S, j) is the cheapest path from 0 through all cities of the subset S ending in j.
+ * The table only stores the entries with j in S, packed by subset mask, which halves the memory of the usual
+ * 2^(n-1) * (n-1) layout. Subsets of the same size depend only on the previous size, so every layer is computed in
+ * parallel on the thread pool. Time is O(2^n * n^2), so the solver is meant for instances of up to about 25 cities
+ * and refuses instances whose table would exceed the memory cap.
+ */
+class HeldKarp {
+private:
+    std::shared_ptr<const DistanceMatrix> distanceMatrix; ///< Shared matrix of edge weights between cities.
+    int matrixSize;                                       ///< Number of cities in the matrix.
+    ThreadPool* threadPool;                               ///< Pool computing the subset layers, not owned, may be nullptr.
+    std::size_t memoryCap;                                ///< Largest allowed DP table in bytes.
+    std::vector<int> bestTour;                            ///< Optimal tour, the start city is repeated at the end.
+    int bestCost;                                         ///< Cost of the optimal tour.
+
+    /**
+     * Computes the position of the first entry of a subset in the packed table, which is the total number
+     * of set bits of all smaller masks.
+     * @param mask The subset of the cities 1..n-1, bit i standing for city i + 1.
+     * @return The offset of the subset's entries.
+     */
+    static std::size_t subsetOffset(std::uint32_t mask);
+
+public:
+    static constexpr std::size_t DEFAULT_MEMORY_CAP = std::size_t(1) << 30; ///< Default table limit, 1 GiB.
+
+    /**
+     * Constructor for the HeldKarp class.
+     * @param matrix The shared matrix of edge weights between cities.
+     * @param pool Thread pool computing the subset layers, nullptr to run on the calling thread.
+     * @param memoryCapBytes Largest allowed DP table in bytes.
+     */
+    HeldKarp(std::shared_ptr<const DistanceMatrix> matrix, ThreadPool* pool = nullptr, std::size_t memoryCapBytes = DEFAULT_MEMORY_CAP);
+
+    /**
+     * Computes the number of bytes the DP table needs for an instance.
+     * @param dimension The number of cities.
+     * @return The table size in bytes.
+     */
+    static std::size_t requiredMemory(int dimension);
+
+    /**
+     * Solves the instance to optimality.
+     * Throws std::runtime_error if the DP table would exceed the memory cap.
+     */
+    void solve();
+
+    /**
+     * Retrieves the optimal tour.
+     * @return A vector representing the tour, the start city is repeated at the end.
+     */
+    std::vector<int> getBestTour() const;
+
+    /**
+     * Retrieves the cost of the optimal tour.
+     * @return The optimal cost.
+     */
+    int getBestCost() const;
+
+    /**
+     * Retrieves the number of vertices in the adjacency matrix.
+     * @return The size of the adjacency matrix.
+     */
+    int getMatrixSize() const;
+
+    /**
+     * Saves the results (number of vertices and the optimal tour) to a file.
+     * @param fileName The name of the file to save the results to.
+     */
+    void saveResultToFile(const std::string& fileName) const;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include <vector>
+#include <memory>
+
+#include "DistanceMatrix.h"
+#include "MoveEvaluator.h"
+#include "Neighborhood.h"
+#include "CandidateList.h"
+
+/**
+ * Class implementing a variable neighbourhood descent (VND) that takes any tour to a local optimum.
+ * For every active city it tries swap, or-opt (segments of 1-3 cities) and reversal-free 3-opt
+ * segment exchange moves anchored at the city's position, in that order, applies the best improving
+ * move of the first neighbourhood that has one and starts over from swap. Don't-look bits keep a city
+ * passive until one of its tour neighbours is touched by an applied move, so after the first pass
+ * only the surroundings of recent changes are revisited. Since a city only sees the moves anchored at
+ * its own position, the descent ends with sweeps over all positions until one finds no improving move,
+ * so the result is a local optimum of all three neighbourhoods (of their candidate moves, with candidate lists).
+ * optimize() keeps no state between calls and may be used concurrently from several threads.
+ */
+class LocalSearch {
+private:
+    MoveEvaluator evaluator;                                   ///< O(1) move evaluation on the instance's matrix.
+    std::vector<std::unique_ptr<Neighborhood>> neighborhoods; ///< Neighbourhoods in VND order.
+
+    /**
+     * Collects the cities at the ends of the arcs a move removes, which are the cities whose
+     * surroundings change when the move is applied.
+     * @param tour The tour before the move.
+     * @param move The move.
+     * @param cities Output array of 6 cities, duplicates possible.
+     */
+    static void collectEndpoints(const std::vector<int>& tour, const Move& move, int cities[6]);
+
+public:
+    /**
+     * Constructor for LocalSearch.
+     * @param matrix The distance matrix of the instance, it must outlive the local search.
+     * @param candidates Candidate lists restricting the neighbourhoods, nullptr for full rows.
+     */
+    explicit LocalSearch(const DistanceMatrix& matrix, const CandidateList* candidates = nullptr);
+
+    /**
+     * Improves a tour in place until no neighbourhood contains an improving move for any active city.
+     * @param tour An open tour of all cities (no repeated start city).
+     * @return The total cost reduction, 0 if the tour was already a local optimum.
+     */
+    int optimize(std::vector<int>& tour) const;
+
+    /**
+     * Improves a closed tour, whose first city is repeated at the end, as produced by GreedyAlgorithm.
+     * @param tour The closed tour, still closed after the call.
+     * @return The total cost reduction.
+     */
+    int optimizeClosedTour(std::vector<int>& tour) const;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * Class giving read-only access to the contents of a whole file without copying it.
+ * On POSIX systems the file is memory-mapped, so pages are only read from disk (or the page cache)
+ * when they are touched; elsewhere the file is read into a buffer once. Mappings start on a page boundary.
+ */
+class MappedFile {
+private:
+    const char* bytes;        ///< First byte of the file contents, nullptr for an empty file.
+    std::size_t length;       ///< Size of the file in bytes.
+    bool mapped;              ///< True if bytes points to a memory mapping that has to be unmapped.
+    std::vector<char> buffer; ///< Storage of the contents when the file could not be mapped.
+
+public:
+    /**
+     * Opens and maps a file. Throws std::runtime_error if it cannot be opened.
+     * @param path The path of the file.
+     * @param copyOnWrite Map the pages writable; changes stay private to the process and never reach the file.
+     */
+    explicit MappedFile(const std::string& path, bool copyOnWrite = false);
+
+    /**
+     * Destructor. Unmaps the file.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Returns the file contents.
+     * @return Pointer to the first byte, valid for the lifetime of the object.
+     */
+    const char* data() const;
+
+    /**
+     * Returns the file contents for modification. Only valid if the file was opened with copyOnWrite.
+     * @return Pointer to the first byte.
+     */
+    char* mutableData();
+
+    /**
+     * Returns the size of the file.
+     * @return The size in bytes.
+     */
+    std::size_t size() const;
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef MATRIX_CACHE_H
+#define MATRIX_CACHE_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "TsplibLoader.h"
+
+/**
+ * Binary cache of parsed instances, stored next to the source file as "<source>.cache".
+ *
+ * The file starts with a fixed 192-byte header holding the dimension, the element type, the instance's
+ * header strings and the size, modification time and checksum of the source file, followed by the raw
+ * matrix. By default the matrix and its transposed copy are stored as int32 in the in-memory row layout,
+ * starting on a 64-byte boundary, so a load is a single copy-on-write mmap with no parsing or copying.
+ *
+ * Compact caches, an opt-in for size-constrained storage, narrow the matrix to int16 or uint16 when every
+ * off-diagonal weight fits into 16 bits, keeping the diagonal (in TSPLIB ATSP files usually one large
+ * sentinel value) in the header. They take half the space of the matrix alone, but are widened into a
+ * fresh matrix and transposed again on every load, which costs O(n^2).
+ *
+ * A cache is used when the source's size and modification time match the header, or, if only the time
+ * differs (the file was copied or touched), when its checksum still matches.
+ */
+class MatrixCache {
+private:
+    /**
+     * Element type of the stored matrix.
+     */
+    enum class ElementType : std::uint32_t {
+        INT32 = 0,  ///< Full weights, row layout with padding, zero-copy loads.
+        INT16 = 1,  ///< Narrowed signed weights, dimension x dimension without padding.
+        UINT16 = 2  ///< Narrowed unsigned weights, dimension x dimension without padding.
+    };
+
+    /**
+     * On-disk header, followed directly by the matrix data.
+     */
+    struct Header {
+        char magic[8];                 ///< File signature, MAGIC.
+        std::uint32_t version;         ///< Format version, VERSION.
+        ElementType elementType;       ///< Element type of the data.
+        std::uint32_t dimension;       ///< Number of cities.
+        std::uint32_t rowStride;       ///< Row stride of INT32 data in elements.
+        std::uint64_t sourceSize;      ///< Size of the source file in bytes.
+        std::int64_t sourceModified;   ///< Modification time of the source file.
+        std::uint64_t sourceChecksum;  ///< Checksum of the source file contents.
+        std::int32_t diagonal;         ///< Value of every diagonal entry for narrowed data.
+        std::uint32_t hasTransposed;   ///< 1 if INT32 data is followed by the transposed copy.
+        char name[48];                 ///< NAME of the instance.
+        char type[16];                 ///< TYPE of the instance.
+        char edgeWeightType[16];       ///< EDGE_WEIGHT_TYPE of the instance.
+        char edgeWeightFormat[32];     ///< EDGE_WEIGHT_FORMAT of the instance.
+        char reserved[24];             ///< Zero, pads the header to a multiple of 64 bytes.
+    };
+    static_assert(sizeof(Header) == 192, "Cache header must keep the data 64-byte aligned");
+
+    static constexpr char MAGIC[8] = {'A', 'T', 'S', 'P', 'M', 'T', 'X', '\0'}; ///< File signature.
+    static constexpr std::uint32_t VERSION = 2;                                  ///< Current format version, 1 narrowed by default.
+
+    /**
+     * Computes a 64-bit checksum (FNV-1a over 8-byte words) of a block of memory.
+     * @param data The first byte.
+     * @param size The number of bytes.
+     * @return The checksum.
+     */
+    static std::uint64_t checksum(const char* data, std::size_t size);
+
+    /**
+     * Reads the modification time of a file in the file system's clock ticks.
+     * @param path The path of the file.
+     * @return The modification time.
+     */
+    static std::int64_t modificationTime(const std::string& path);
+
+public:
+    /**
+     * Returns the path of the cache belonging to a source file.
+     * @param sourcePath The path of the TSPLIB file.
+     * @return The cache path.
+     */
+    static std::string cachePath(const std::string& sourcePath);
+
+    /**
+     * Loads an instance from the cache of a source file if it exists and is up to date.
+     * @param sourcePath The path of the TSPLIB file.
+     * @param instance Output, filled only on success; parseSeconds holds the load time.
+     * @return True if the instance was loaded from the cache.
+     */
+    static bool load(const std::string& sourcePath, TsplibInstance& instance);
+
+    /**
+     * Writes the cache of a source file. The file is written under a temporary name and renamed,
+     * so concurrent loads never see a partial cache. Throws std::runtime_error if it cannot be written.
+     * @param sourcePath The path of the TSPLIB file the instance was parsed from.
+     * @param instance The parsed instance; its transposed copy is stored too when it has been built.
+     * @param compact Whether to narrow the weights to 16 bits when they fit, trading zero-copy loads for size.
+     */
+    static void store(const std::string& sourcePath, const TsplibInstance& instance, bool compact = false);
+
+    /**
+     * Loads an instance from its cache, or parses the TSPLIB file and writes the cache for the next load.
+     * A cache that cannot be written is reported on std::cerr and skipped. The transposed copy of the
+     * matrix is always built. Throws std::runtime_error if the source cannot be parsed.
+     * @param sourcePath The path of the TSPLIB file.
+     * @param compact Whether a newly written cache is narrowed to 16 bits when the weights fit.
+     * @return The loaded instance.
+     */
+    static TsplibInstance loadOrParse(const std::string& sourcePath, bool compact = false);
+};
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef MEMETIC_ALGORITHM_H
+#define MEMETIC_ALGORITHM_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <utility>
+#include <cstdint>
+
+#include "DistanceMatrix.h"
+#include "ThreadPool.h"
+#include "CandidateList.h"
+#include "LocalSearch.h"
+#include "RandomGenerator.h"
+
+/**
+ * Enum class representing the crossover operators of the memetic algorithm.
+ */
+enum class CrossoverType {
+    EDGE_ASSEMBLY, ///< Edge assembly crossover (EAX) on directed arcs.
+    ORDER          ///< Order crossover (OX), keeping the relative order of the cities.
+};
+
+/**
+ * Steady-state memetic algorithm: a population of tours, recombined by an ATSP crossover whose offspring are
+ * polished by LocalSearch before they may replace a population member.
+ *
+ * The population is kept as a structure of arrays: the open tours, the successor of every city, the costs and
+ * a rotation-invariant fingerprint per member, each in one flat array, so a crossover reads two contiguous rows.
+ * The initial population holds greedy tours of evenly spread start cities and randomized greedy tours
+ * (GreedyAlgorithm::solveRandomizedFromCity), all locally optimised.
+ *
+ * Offspring are produced in batches, one per thread: the population is read-only while a batch is built in
+ * parallel, then the offspring are inserted in batch order. An offspring replaces its first parent if it is
+ * better, otherwise the worst member if it beats it; duplicates (equal fingerprints) are dropped. Every batch
+ * slot draws from its own random stream, so a run depends on the seed and the thread count only.
+ *
+ * Directed EAX: every city has one outgoing arc in parent A and one incoming arc in parent B, so alternating
+ * A-arcs forward and B-arcs backward decomposes the union into AB-cycles, the cycles of the permutation
+ * u -> predB(succA(u)). Exchanging the arcs of one AB-cycle turns A into a set of subtours with every degree
+ * intact; the subtours are then joined, smallest first, by the cheapest exchange of one arc of each, looking
+ * at candidate-list arcs first. Several AB-cycles are tried and the cheapest offspring is kept.
+ */
+class MemeticAlgorithm {
+public:
+    static constexpr int DEFAULT_POPULATION_SIZE = 30; ///< Population size unless set with setPopulationSize().
+    static constexpr int EAX_TRIALS = 4;               ///< AB-cycles tried per EAX offspring.
+
+private:
+    /**
+     * Buffers of one batch slot, reused across generations.
+     */
+    struct OffspringWorkspace {
+        RandomGenerator generator;       ///< Random stream of the slot.
+        std::vector<int> tour;           ///< The offspring, an open tour.
+        int cost = 0;                    ///< Its cost after the local search.
+        int parent = 0;                  ///< Index of the first parent, replaced if the offspring is better.
+        std::vector<int> successors;     ///< Successor array under construction.
+        std::vector<int> predecessors;   ///< Predecessor array under construction.
+        std::vector<int> bestSuccessors; ///< Successors of the cheapest EAX trial.
+        std::vector<int> cycleOf;        ///< AB-cycle of every city, -1 for cities whose A-arc is also in B.
+        std::vector<int> cycleStarts;    ///< A city of every non-trivial AB-cycle.
+        std::vector<int> subtourOf;      ///< Subtour label of every city while subtours are merged.
+        std::vector<int> subtourSizes;   ///< Number of cities of every subtour, 0 once merged away.
+        std::vector<int> subtourStarts;  ///< A city of every subtour.
+        std::vector<char> used;          ///< Cities already placed by the order crossover.
+    };
+
+    std::shared_ptr<const DistanceMatrix> distanceMatrix; ///< Shared matrix of distances between cities.
+    int matrixSize;                                       ///< Number of cities.
+    double maxDuration;                                   ///< Time limit of the run in seconds.
+    ThreadPool* threadPool;                               ///< Pool building the offspring of a batch, nullptr for serial batches.
+    std::shared_ptr<const CandidateList> candidateList;   ///< Candidate lists of the local search and the subtour merge, may be empty.
+    LocalSearch localSearch;                              ///< Local search polishing every offspring.
+    CrossoverType crossover;                              ///< Recombination operator.
+    int populationSize;                                   ///< Number of tours in the population.
+    std::uint64_t seed;                                   ///< Seed of the run.
+
+    std::vector<int> tours;                      ///< populationSize open tours of matrixSize cities, row by row.
+    std::vector<int> successors;                 ///< successors[member * n + city] is the city after city in member's tour.
+    std::vector<int> costs;                      ///< Cost of every member.
+    std::vector<std::uint64_t> fingerprints;     ///< Rotation-invariant hash of every member's arcs.
+
+    std::vector<int> bestTour;                   ///< Best open tour of the run.
+    int bestCost;                                ///< Cost of bestTour.
+    double bestTimestamp;                        ///< Seconds until bestTour was found.
+    std::vector<std::pair<double, int>> improvementHistory; ///< (seconds, cost) of every new best tour.
+    long long offspringCount;                    ///< Offspring produced by the last run.
+    long long acceptedCount;                     ///< Offspring that entered the population.
+
+    /**
+     * Computes the fingerprint of an open tour from its arcs, so every rotation has the same fingerprint.
+     * @param tour The open tour.
+     * @return The fingerprint.
+     */
+    std::uint64_t fingerprint(const std::vector<int>& tour) const;
+
+    /**
+     * Stores a tour in a population slot, with its successors and fingerprint.
+     * @param member The slot.
+     * @param tour The open tour.
+     * @param cost Its cost.
+     */
+    void storeMember(int member, const std::vector<int>& tour, int cost);
+
+    /**
+     * Builds the initial population in parallel and records its best tour.
+     */
+    void initializePopulation();
+
+    /**
+     * Builds one offspring of the batch slot: draws two parents, recombines them and runs the local search.
+     * Reads the population only, so the slots of a batch run concurrently.
+     * @param workspace The slot's buffers and random stream; receives the offspring.
+     */
+    void breed(OffspringWorkspace& workspace) const;
+
+    /**
+     * Directed edge assembly crossover of two members into workspace.tour.
+     * @param first Index of parent A, whose arcs form the base of the offspring.
+     * @param second Index of parent B.
+     * @param workspace The slot's buffers.
+     * @return False if the parents have the same arcs and no offspring was built.
+     */
+    bool edgeAssemblyCrossover(int first, int second, OffspringWorkspace& workspace) const;
+
+    /**
+     * Order crossover of two members into workspace.tour: a random segment of A keeps its positions and the
+     * other cities follow in the order of B.
+     * @param first Index of parent A.
+     * @param second Index of parent B.
+     * @param workspace The slot's buffers.
+     */
+    void orderCrossover(int first, int second, OffspringWorkspace& workspace) const;
+
+    /**
+     * Joins the subtours of a successor array into one tour, always merging the smallest subtour with another
+     * one through the cheapest exchange of one arc of each.
+     * @param workspace The slot's buffers, holding successors and predecessors.
+     * @return The cost change of the merges.
+     */
+    int mergeSubtours(OffspringWorkspace& workspace) const;
+
+    /**
+     * Inserts an offspring into the population if it is new and better than its parent or the worst member.
+     * @param workspace The slot holding the offspring.
+     * @param elapsed Seconds since the start, recorded with a new best tour.
+     */
+    void insertOffspring(const OffspringWorkspace& workspace, double elapsed);
+
+public:
+    /**
+     * Constructor for MemeticAlgorithm.
+     * @param matrix The shared distance matrix.
+     * @param maxTimeInSeconds The time limit of the run.
+     * @param pool Thread pool building the offspring of a batch, nullptr to build them on the calling thread.
+     * @param candidates Candidate lists of the local search and the subtour merge, nullptr for full scans.
+     */
+    MemeticAlgorithm(std::shared_ptr<const DistanceMatrix> matrix, double maxTimeInSeconds, ThreadPool* pool = nullptr,
+                     std::shared_ptr<const CandidateList> candidates = nullptr);
+
+    /**
+     * Runs the memetic algorithm until the time limit.
+     */
+    void solve();
+
+    /**
+     * Sets the number of tours in the population.
+     * @param size The population size, at least 2.
+     */
+    void setPopulationSize(int size);
+
+    /**
+     * Selects the crossover operator, edge assembly by default.
+     * @param type The crossover.
+     */
+    void setCrossover(CrossoverType type);
+
+    /**
+     * Sets the seed of the run, making it reproducible for a given thread count up to the timing of the time limit.
+     * @param value The seed.
+     */
+    void setSeed(std::uint64_t value);
+
+    /**
+     * Gets the best tour of the last run.
+     * @return The closed tour, the start city repeated at the end.
+     */
+    std::vector<int> getBestTour() const;
+
+    /**
+     * Gets the cost of the best tour of the last run.
+     * @return The cost.
+     */
+    int getBestCost() const;
+
+    /**
+     * Gets the time when the best tour was found.
+     * @return Seconds since the start of the run.
+     */
+    double getBestTourTimestamp() const;
+
+    /**
+     * Retrieves every improvement of the best tour during the last run.
+     * @return Pairs of (seconds since the start, cost), in order of time with strictly decreasing cost.
+     */
+    std::vector<std::pair<double, int>> getImprovementHistory() const;
+
+    /**
+     * Gets the number of offspring produced by the last run.
+     * @return The count.
+     */
+    long long getOffspringCount() const;
+
+    /**
+     * Gets the number of offspring that entered the population during the last run.
+     * @return The count.
+     */
+    long long getAcceptedCount() const;
+
+    /**
+     * Saves the results (number of vertices and best tour) to a file.
+     * @param fileName The name of the file to save the results to.
+     */
+    void saveResultsToFile(const std::string& fileName) const;
+
+    /**
+     * Parses the short name of a crossover, as used on the command line.
+     * @param name "eax" or "ox".
+     * @return The crossover type.
+     * @throws std::invalid_argument If the name is unknown.
+     */
+    static CrossoverType parseCrossover(const std::string& name);
+
+    /**
+     * Retrieves the short name of a crossover, the inverse of parseCrossover().
+     * @param type The crossover type.
+     * @return The short name.
+     */
+    static std::string crossoverName(CrossoverType type);
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef MOVE_EVALUATOR_H
+#define MOVE_EVALUATOR_H
+
+#include <vector>
+
+#include "DistanceMatrix.h"
+
+/**
+ * Enum class representing the elementary tour modifications understood by MoveEvaluator.
+ * Insertion and or-opt moves are both expressed as segment exchanges.
+ */
+enum class MoveType {
+    SWAP,            ///< Exchange the cities at positions first and second.
+    SEGMENT_EXCHANGE ///< Exchange the adjacent segments (first, second] and (second, third] without reversing them.
+};
+
+/**
+ * A single tour modification described by tour positions. Tours are open permutations of all
+ * cities (the edge back to the first city is implicit), positions are 0-based.
+ */
+struct Move {
+    MoveType type; ///< Kind of modification.
+    int first;     ///< First position (SWAP: i < j, SEGMENT_EXCHANGE: i < j < k).
+    int second;    ///< Second position.
+    int third;     ///< Third position, used only by SEGMENT_EXCHANGE.
+};
+
+/**
+ * Class computing the cost change of a Move in constant time and applying accepted moves in place.
+ * Every move touches at most four arcs, so the delta only depends on the cities next to the
+ * modified positions and never requires a full tour evaluation.
+ */
+class MoveEvaluator {
+private:
+    const DistanceMatrix& matrix; ///< Distance matrix of the instance being solved.
+
+public:
+    /**
+     * Constructor for MoveEvaluator.
+     * @param matrix The distance matrix of the instance, it must outlive the evaluator.
+     */
+    explicit MoveEvaluator(const DistanceMatrix& matrix);
+
+    /**
+     * Creates a move exchanging the cities at two positions.
+     * @param i First position.
+     * @param j Second position, different from i.
+     * @return The swap move.
+     */
+    static Move swap(int i, int j);
+
+    /**
+     * Creates a move that removes the city at one position and reinserts it so that it ends at another.
+     * Both positions must be in [1, n - 1]; the city at position 0 is never moved.
+     * @param from Position of the city to move.
+     * @param to Position the city occupies after the move, different from from.
+     * @return The equivalent segment exchange move.
+     */
+    static Move insertion(int from, int to);
+
+    /**
+     * Creates an or-opt move relocating a segment, without reversing it, right after another position.
+     * @param start Position of the first city of the segment, at least 1.
+     * @param length Number of cities in the segment.
+     * @param target Position after which the segment is placed, outside [start - 1, start + length - 1].
+     * @return The equivalent segment exchange move.
+     */
+    static Move orOpt(int start, int length, int target);
+
+    /**
+     * Creates a reversal-free 3-opt move exchanging the adjacent segments (i, j] and (j, k].
+     * @param i Position before the first segment.
+     * @param j Position ending the first segment.
+     * @param k Position ending the second segment, at most n - 1.
+     * @return The segment exchange move.
+     */
+    static Move segmentExchange(int i, int j, int k);
+
+    /**
+     * Computes the cost change caused by a move in O(1).
+     * @param tour The current tour.
+     * @param move The move to evaluate.
+     * @return New tour cost minus current tour cost.
+     */
+    int delta(const std::vector<int>& tour, const Move& move) const;
+
+    /**
+     * Computes the cost changes of all swaps (i, j), j = i + 1 .. n - 1, at once. The non-adjacent swaps
+     * are evaluated by TourKernels::swapDeltas, eight or sixteen at a time; results equal delta().
+     * @param tour The current tour.
+     * @param arcWeights arcWeights[p] is the weight of the arc leaving position p (see computeArcWeights).
+     * @param i The row, the first position of the swaps.
+     * @param deltas Output, deltas[j - i - 1] is the cost change of the swap (i, j).
+     */
+    void swapRowDeltas(const std::vector<int>& tour, const std::vector<int>& arcWeights, int i, int* deltas) const;
+
+    /**
+     * Lists the weights of the arcs of a tour, the input of swapRowDeltas.
+     * @param tour The tour.
+     * @param arcWeights Output, arcWeights[p] is the weight of tour[p] -> tour[(p + 1) % n].
+     */
+    void computeArcWeights(const std::vector<int>& tour, std::vector<int>& arcWeights) const;
+
+    /**
+     * Applies a move to the tour in place.
+     * @param tour The tour to modify.
+     * @param move The move to apply.
+     */
+    void apply(std::vector<int>& tour, const Move& move) const;
+
+    /**
+     * Applies a move to the tour in place and updates the position index of the cities it moved.
+     * @param tour The tour to modify.
+     * @param positions positions[city] is the index of city in tour; kept consistent with tour.
+     * @param move The move to apply.
+     */
+    void apply(std::vector<int>& tour, std::vector<int>& positions, const Move& move) const;
+
+    /**
+     * Builds the position index of a tour.
+     * @param tour The tour.
+     * @param positions Output, positions[city] is set to the index of city in tour.
+     */
+    static void computePositions(const std::vector<int>& tour, std::vector<int>& positions);
+};
+
+#endif
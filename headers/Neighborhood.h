@@ -0,0 +1,202 @@
+#ifndef NEIGHBORHOOD_H
+#define NEIGHBORHOOD_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+
+#include "MoveEvaluator.h"
+#include "CandidateList.h"
+#include "RandomGenerator.h"
+
+/**
+ * Enum class representing the neighbourhoods available to the local search based solvers.
+ * None of them reverses a segment, so all deltas stay valid on asymmetric instances.
+ */
+enum class NeighborhoodType {
+    SWAP,            ///< Exchange two cities.
+    OR_OPT,          ///< Move a segment of 1 to 3 cities to another place in the tour.
+    SEGMENT_EXCHANGE ///< Reversal-free 3-opt: exchange two adjacent segments of any length.
+};
+
+/**
+ * Interface of a neighbourhood: a family of moves that can be enumerated row by row (so a scan can
+ * be split into blocks for the thread pool) or sampled at random. Moves are scored and applied by
+ * MoveEvaluator in O(1) and O(segment length) respectively.
+ *
+ * With a CandidateList the neighbourhood is restricted to moves that create at least one arc to a
+ * candidate of the city at the row position, so a row holds O(k) moves instead of O(n). Random moves
+ * are then drawn from the candidate moves, with a small share of uniform moves kept for diversity.
+ */
+class Neighborhood {
+protected:
+    const CandidateList* candidates; ///< Candidate lists restricting the moves, nullptr for the full neighbourhood.
+
+    /**
+     * Draws a uniformly chosen move of the full neighbourhood that keeps the city at position 0 in place.
+     * @param size The number of cities in the tour.
+     * @param generator The random number generator of the run.
+     * @return The random move.
+     */
+    virtual Move uniformMove(int size, RandomGenerator& generator) const = 0;
+
+    /**
+     * Draws a move creating an arc to a candidate, or reports that the drawn candidate gave no valid move.
+     * @param tour The current tour.
+     * @param positions Position index of the tour.
+     * @param generator The random number generator of the run.
+     * @param move Output, the drawn move.
+     * @return True if move is valid and keeps the city at position 0 in place.
+     */
+    virtual bool candidateMove(const std::vector<int>& tour, const std::vector<int>& positions,
+                               RandomGenerator& generator, Move& move) const = 0;
+
+public:
+    static constexpr double UNIFORM_MOVE_SHARE = 0.1; ///< Share of uniform random moves when candidate lists are used.
+
+    /**
+     * Constructor for Neighborhood.
+     * @param candidates Candidate lists restricting the moves, nullptr for the full neighbourhood.
+     */
+    explicit Neighborhood(const CandidateList* candidates = nullptr);
+
+    virtual ~Neighborhood() = default;
+
+    /**
+     * Retrieves the type of the neighbourhood.
+     * @return The neighbourhood type.
+     */
+    virtual NeighborhoodType getType() const = 0;
+
+    /**
+     * Retrieves a human readable name of the neighbourhood.
+     * @return The name.
+     */
+    virtual std::string getName() const = 0;
+
+    /**
+     * Counts (or, with candidate lists, estimates) the moves enumerated for one row, used to balance scan blocks.
+     * @param size The number of cities in the tour.
+     * @param row The row index in [0, size).
+     * @return The number of moves in the row.
+     */
+    virtual long long countMovesInRow(int size, int row) const = 0;
+
+    /**
+     * Calls visit for every move of the rows [firstRow, lastRow), always in the same order.
+     * @param tour The current tour.
+     * @param positions Position index of the tour, only read when candidate lists are used.
+     * @param firstRow The first row.
+     * @param lastRow One past the last row.
+     * @param visit Function receiving each move.
+     */
+    virtual void forEachMove(const std::vector<int>& tour, const std::vector<int>& positions, int firstRow, int lastRow,
+                             const std::function<void(const Move&)>& visit) const = 0;
+
+    /**
+     * Draws a random move that keeps the city at position 0 in place. Requires at least 5 cities.
+     * @param tour The current tour.
+     * @param positions Position index of the tour, only read when candidate lists are used.
+     * @param generator The random number generator of the run.
+     * @return The random move.
+     */
+    Move randomMove(const std::vector<int>& tour, const std::vector<int>& positions, RandomGenerator& generator) const;
+
+    /**
+     * Checks whether the neighbourhood is restricted by candidate lists.
+     * @return True if a CandidateList is used.
+     */
+    bool usesCandidates() const;
+
+    /**
+     * Creates a neighbourhood of the given type.
+     * @param type The neighbourhood type.
+     * @param candidates Candidate lists restricting the moves, nullptr for the full neighbourhood.
+     * @return The neighbourhood.
+     */
+    static std::unique_ptr<Neighborhood> create(NeighborhoodType type, const CandidateList* candidates = nullptr);
+
+    /**
+     * Creates one neighbourhood for each of the given types.
+     * @param types The neighbourhood types.
+     * @param candidates Candidate lists restricting the moves, nullptr for the full neighbourhoods.
+     * @return The neighbourhoods, in the order of types.
+     */
+    static std::vector<std::unique_ptr<Neighborhood>> createAll(const std::vector<NeighborhoodType>& types,
+                                                                const CandidateList* candidates = nullptr);
+};
+
+/**
+ * Neighbourhood exchanging the cities at positions i < j. With candidate lists, row i holds the swaps
+ * that put a candidate successor right after, or a candidate predecessor right before, the city at i.
+ */
+class SwapNeighborhood : public Neighborhood {
+public:
+    using Neighborhood::Neighborhood;
+
+    NeighborhoodType getType() const override;
+    std::string getName() const override;
+    long long countMovesInRow(int size, int row) const override;
+    void forEachMove(const std::vector<int>& tour, const std::vector<int>& positions, int firstRow, int lastRow,
+                     const std::function<void(const Move&)>& visit) const override;
+
+protected:
+    Move uniformMove(int size, RandomGenerator& generator) const override;
+    bool candidateMove(const std::vector<int>& tour, const std::vector<int>& positions,
+                       RandomGenerator& generator, Move& move) const override;
+};
+
+/**
+ * Neighbourhood relocating a segment of up to maxSegmentLength cities, starting at the row position,
+ * behind any other position of the tour (segment insertion, or-opt). With candidate lists the segment
+ * is only placed right after a candidate predecessor of its first city or right before a candidate
+ * successor of its last city.
+ */
+class OrOptNeighborhood : public Neighborhood {
+private:
+    int maxSegmentLength; ///< Longest segment that is moved.
+
+public:
+    /**
+     * Constructor for OrOptNeighborhood.
+     * @param candidates Candidate lists restricting the moves, nullptr for the full neighbourhood.
+     * @param maxSegmentLength Longest segment that is moved, 1 gives plain node insertion.
+     */
+    explicit OrOptNeighborhood(const CandidateList* candidates = nullptr, int maxSegmentLength = 3);
+
+    NeighborhoodType getType() const override;
+    std::string getName() const override;
+    long long countMovesInRow(int size, int row) const override;
+    void forEachMove(const std::vector<int>& tour, const std::vector<int>& positions, int firstRow, int lastRow,
+                     const std::function<void(const Move&)>& visit) const override;
+
+protected:
+    Move uniformMove(int size, RandomGenerator& generator) const override;
+    bool candidateMove(const std::vector<int>& tour, const std::vector<int>& positions,
+                       RandomGenerator& generator, Move& move) const override;
+};
+
+/**
+ * Neighbourhood exchanging the adjacent segments (i, j] and (j, k] for all i < j < k, where i is the row.
+ * This is the only 3-opt reconnection that keeps every segment's orientation. It has O(n^3) moves;
+ * with candidate lists both new arcs tour[i] -> tour[j + 1] and tour[k] -> tour[i + 1] must be
+ * candidate arcs, which leaves O(n * k^2) moves.
+ */
+class SegmentExchangeNeighborhood : public Neighborhood {
+public:
+    using Neighborhood::Neighborhood;
+
+    NeighborhoodType getType() const override;
+    std::string getName() const override;
+    long long countMovesInRow(int size, int row) const override;
+    void forEachMove(const std::vector<int>& tour, const std::vector<int>& positions, int firstRow, int lastRow,
+                     const std::function<void(const Move&)>& visit) const override;
+
+protected:
+    Move uniformMove(int size, RandomGenerator& generator) const override;
+    bool candidateMove(const std::vector<int>& tour, const std::vector<int>& positions,
+                       RandomGenerator& generator, Move& move) const override;
+};
+
+#endif
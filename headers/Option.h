@@ -4,13 +4,30 @@
  */
 enum class Option { 
     LOAD_DATA,               ///< Load problem data or cost tables from a file or other sources.
-    STOP_CRITERION,          ///< Set the stop criterion for the algorithms (e.g., time limit or iteration count).
+    STOP_CRITERION,          ///< Set the stop criterion: time limit, iteration limit, iterations without improvement and target cost.
     GREEDY_ALGORITHM,        ///< Run the Greedy Algorithm to solve the problem.
     RUN_TABU_SEARCH,         ///< Run the Tabu Search algorithm to solve the problem.
     SET_TEMP_CHANGE_FACTOR,  ///< Set the cooling factor for the Simulated Annealing algorithm.
     RUN_SIMULATED_ANNEALING, ///< Run the Simulated Annealing algorithm to solve the problem.
     SAVE_TO_FILE,            ///< Save the results of the computation to a file.
     LOAD_COST_TABELS,        ///< Load pre-defined cost tables for testing or benchmarking.
+    SET_THREAD_COUNT,        ///< Set the number of worker threads used by the parallel algorithms.
+    SET_NEIGHBORHOODS,       ///< Select the neighbourhoods (move types) used by Tabu Search and Simulated Annealing.
+    SET_CANDIDATE_LIST_SIZE, ///< Set the number of nearest neighbours kept per city to prune the neighbourhoods.
+    SET_LOCAL_SEARCH,        ///< Enable or disable local search post-optimisation of the solvers' tours.
+    SET_ANNEALING_CHAINS,    ///< Set the number of parallel Simulated Annealing chains and their restart period.
+    SET_PARALLEL_TEMPERING,  ///< Set the number of replicas of the parallel tempering Simulated Annealing mode.
+    RUN_HELD_KARP,           ///< Solve the problem exactly with the Held-Karp dynamic programming algorithm.
+    SET_EXACT_MEMORY_LIMIT,  ///< Set the memory limit of the exact solvers.
+    RUN_BRANCH_AND_BOUND,    ///< Solve the problem with branch and bound, seeded with the best tour found so far.
+    SET_RANDOM_SEED,         ///< Set the seed of Tabu Search and Simulated Annealing, making their runs reproducible.
+    SET_CONSTRUCTION,        ///< Select the construction heuristic building the start tours of Tabu Search and Simulated Annealing.
+    RUN_PORTFOLIO,           ///< Run Tabu Search and Simulated Annealing workers concurrently, sharing an elite pool of tours.
+    RUN_MEMETIC,             ///< Run the memetic algorithm: crossover of a population of tours, polished by local search.
+    SET_MEMETIC,             ///< Set the population size and the crossover of the memetic algorithm.
+    SET_TABU_MEMORY,         ///< Select the tabu attribute (arcs or positions) and the fixed or reactive tabu tenure.
+    SET_REACTIVE_TABU,       ///< Enable the intensification and diversification phases of Tabu Search and set their stagnation limit.
+    SET_ANNEALING_SCHEDULE,  ///< Select the cooling schedule of Simulated Annealing and the length of its epochs.
     EXIT,                    ///< Exit the program.
     INVALID_INPUT            ///< Represents an invalid or unrecognized input option.
 };
@@ -0,0 +1,190 @@
+#ifndef PORTFOLIO_SOLVER_H
+#define PORTFOLIO_SOLVER_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <utility>
+#include <cstdint>
+
+#include "DistanceMatrix.h"
+#include "ThreadPool.h"
+#include "Neighborhood.h"
+#include "CandidateList.h"
+#include "ElitePool.h"
+#include "StopCriterion.h"
+
+/**
+ * Solvers run by the workers of the portfolio.
+ */
+enum class PortfolioWorker {
+    TABU_SEARCH,        ///< Tabu Search with a serial neighbourhood scan.
+    SIMULATED_ANNEALING ///< A single Simulated Annealing chain.
+};
+
+/**
+ * Cooperative portfolio: Tabu Search and Simulated Annealing workers run side by side on the thread pool
+ * (worker 0 on the calling thread) until a common deadline, alternating between the two solvers. Worker 0
+ * starts from the best Greedy tour, the others from greedy tours of evenly spread start cities. The workers
+ * share an ElitePool: every new best tour of a worker is published immediately, and a worker that has not
+ * improved for the stagnation period continues from a tour drawn from the pool.
+ *
+ * Every worker gets the proposal budget and no-improvement window of the run's limits on its own. A worker
+ * reaching the target cost raises a cancel flag shared by all workers, which stops the others as well.
+ */
+class PortfolioSolver {
+public:
+    /**
+     * Outcome of one worker.
+     */
+    struct WorkerResult {
+        PortfolioWorker solver;   ///< The solver of the worker.
+        int bestCost;             ///< Cost of its best tour.
+        double bestTimestamp;     ///< Seconds until it found that tour.
+        long long iterations;     ///< Tabu Search iterations or Simulated Annealing proposals.
+        StopReason stopReason;    ///< Why the worker stopped.
+    };
+
+    static constexpr int DEFAULT_ELITE_CAPACITY = 8; ///< Tours kept in the elite pool unless set with setEliteCapacity().
+
+private:
+    std::shared_ptr<const DistanceMatrix> distanceMatrix; ///< Shared matrix of distances between cities.
+    StopLimits stopLimits;                                ///< Limits of the run; the time limit includes building the start tours.
+    double coolingFactor;                                 ///< Cooling factor of the Simulated Annealing workers.
+    ThreadPool* threadPool;                               ///< Pool running workers 1..n-1, nullptr for a single Tabu Search worker.
+    std::vector<NeighborhoodType> neighborhoodTypes;      ///< Move types of the workers.
+    std::shared_ptr<const CandidateList> candidateList;   ///< Candidate lists of the workers, may be empty.
+    int workerCount;                                      ///< Requested number of workers, 0 for one per thread.
+    int eliteCapacity;                                    ///< Tours kept in the elite pool.
+    double stagnationPeriod;                              ///< Seconds without improvement before a worker pulls an elite tour, 0 for a tenth of the run.
+    std::uint64_t seed;                                   ///< Seed of the run; worker i draws from stream i.
+    bool localSearchEnabled;                              ///< Whether the workers polish their final tours with local search.
+
+    std::vector<int> bestTour;                            ///< Best closed tour of the last run.
+    int bestCost;                                         ///< Cost of bestTour.
+    double bestTimestamp;                                 ///< Seconds until bestTour was found.
+    std::vector<std::pair<double, int>> improvementHistory; ///< (seconds, cost) of every new best over all workers.
+    std::vector<WorkerResult> workerResults;              ///< Outcome of every worker of the last run.
+    long long eliteAccepted;                              ///< Tours that entered the elite pool during the last run.
+    StopReason stopReason;                                ///< Why the worker with the best tour stopped.
+
+public:
+    /**
+     * Constructor for PortfolioSolver.
+     * @param matrix The shared distance matrix.
+     * @param maxTimeInSeconds The time limit of the run.
+     * @param coolingFactor Cooling factor of the Simulated Annealing workers.
+     * @param pool Thread pool running the additional workers, nullptr for a single Tabu Search worker; the first
+     *             Simulated Annealing worker needs at least one pool thread.
+     * @param neighborhoodTypes Move types of the workers.
+     * @param candidates Candidate lists of the workers, nullptr for full neighbourhoods.
+     */
+    PortfolioSolver(std::shared_ptr<const DistanceMatrix> matrix, double maxTimeInSeconds, double coolingFactor, ThreadPool* pool,
+                    const std::vector<NeighborhoodType>& neighborhoodTypes = {NeighborhoodType::SWAP, NeighborhoodType::OR_OPT},
+                    std::shared_ptr<const CandidateList> candidates = nullptr);
+
+    /**
+     * Runs the portfolio until the time limit.
+     */
+    void solve();
+
+    /**
+     * Sets the limits ending the run, replacing the time limit given to the constructor.
+     * @param limits Time limit of the run, and per worker the optional iteration budget and no-improvement
+     *               window; the target cost stops all workers.
+     */
+    void setStopLimits(const StopLimits& limits);
+
+    /**
+     * Sets the number of workers, capped at one per pool thread plus the calling thread.
+     * @param count Number of workers, 0 for one per thread.
+     */
+    void setWorkerCount(int count);
+
+    /**
+     * Sets the number of tours kept in the elite pool.
+     * @param capacity Number of tours, at least 1.
+     */
+    void setEliteCapacity(int capacity);
+
+    /**
+     * Sets how long a worker may go without a new best before it continues from an elite tour.
+     * @param seconds The stagnation period, 0 for a tenth of the time limit.
+     */
+    void setStagnationPeriod(double seconds);
+
+    /**
+     * Sets the seed of the run, the workers draw from independent streams of it.
+     * @param value The seed.
+     */
+    void setSeed(std::uint64_t value);
+
+    /**
+     * Enables or disables the local search polishing the final tour of every worker.
+     * @param enabled Whether to run the local search.
+     */
+    void setLocalSearch(bool enabled);
+
+    /**
+     * Gets the best tour of the last run.
+     * @return The closed tour, the start city repeated at the end.
+     */
+    std::vector<int> getBestTour() const;
+
+    /**
+     * Gets the cost of the best tour of the last run.
+     * @return The cost.
+     */
+    int getBestCost() const;
+
+    /**
+     * Gets the time when the best tour was found.
+     * @return Seconds since the start of the run.
+     */
+    double getBestTourTimestamp() const;
+
+    /**
+     * Retrieves every improvement of the best tour over all workers during the last run.
+     * @return Pairs of (seconds since the start, cost), in order of time with strictly decreasing cost.
+     */
+    std::vector<std::pair<double, int>> getImprovementHistory() const;
+
+    /**
+     * Retrieves the outcome of every worker of the last run.
+     * @return One result per worker, in worker order.
+     */
+    std::vector<WorkerResult> getWorkerResults() const;
+
+    /**
+     * Gets the total number of iterations and proposals of all workers of the last run.
+     * @return The sum over the workers.
+     */
+    long long getIterationCount() const;
+
+    /**
+     * Gets the number of tours that entered the elite pool during the last run.
+     * @return The count.
+     */
+    long long getEliteAcceptedCount() const;
+
+    /**
+     * Gets why the worker with the best tour of the last run stopped.
+     * @return The stop reason.
+     */
+    StopReason getStopReason() const;
+
+    /**
+     * Saves the results (number of vertices and best tour) to a file.
+     * @param fileName The name of the file to save the results to.
+     */
+    void saveResultsToFile(const std::string& fileName) const;
+
+    /**
+     * Retrieves a human readable name of a worker's solver.
+     * @param solver The solver.
+     * @return The name.
+     */
+    static std::string workerName(PortfolioWorker solver);
+};
+
+#endif
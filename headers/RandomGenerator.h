@@ -0,0 +1,120 @@
+#ifndef RANDOM_GENERATOR_H
+#define RANDOM_GENERATOR_H
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+/**
+ * Class implementing the xoshiro256** pseudo-random generator, the random source of every solver.
+ * It is seeded explicitly, so a run can be reproduced from its seed, and parallel searches draw from
+ * independent streams: stream(i) is the generator advanced by i * 2^128 steps, so streams of the
+ * same seed never overlap. State updates are a few shifts and xors, much cheaper than std::mt19937.
+ * Satisfies UniformRandomBitGenerator, so it also works with std::shuffle and the std distributions.
+ */
+class RandomGenerator {
+private:
+    std::uint64_t state[4]; ///< Generator state, never all zero.
+
+    static std::uint64_t rotateLeft(std::uint64_t value, int shift) {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+public:
+    using result_type = std::uint64_t;
+
+    /**
+     * Constructor for RandomGenerator.
+     * @param seed The seed; the state is expanded from it with SplitMix64.
+     */
+    explicit RandomGenerator(std::uint64_t seed = 0);
+
+    /**
+     * Creates a seed from std::random_device, for runs that do not need to be reproducible.
+     * @return The seed.
+     */
+    static std::uint64_t randomSeed();
+
+    /**
+     * Advances the generator by 2^128 steps.
+     */
+    void jump();
+
+    /**
+     * Returns an independent stream of this generator, for the index-th thread or parallel search.
+     * @param index Index of the stream, stream 0 continues this generator's own sequence.
+     * @return A copy advanced by index * 2^128 steps.
+     */
+    RandomGenerator stream(int index) const;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * Draws the next 64 random bits.
+     * @return The random value.
+     */
+    result_type operator()() {
+        const std::uint64_t result = rotateLeft(state[1] * 5, 7) * 9;
+        const std::uint64_t shifted = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= shifted;
+        state[3] = rotateLeft(state[3], 45);
+        return result;
+    }
+
+    /**
+     * Draws a uniform integer in [0, bound) without modulo bias (Lemire's multiply-and-reject method:
+     * a division is only needed in the rare case the product lands in the biased low range).
+     * @param bound The exclusive upper bound, at least 1.
+     * @return The random value.
+     */
+    std::uint32_t below(std::uint32_t bound) {
+        std::uint64_t product = static_cast<std::uint64_t>(static_cast<std::uint32_t>((*this)() >> 32)) * bound;
+        std::uint32_t low = static_cast<std::uint32_t>(product);
+        if (low < bound) {
+            const std::uint32_t threshold = static_cast<std::uint32_t>(-bound) % bound;
+            while (low < threshold) {
+                product = static_cast<std::uint64_t>(static_cast<std::uint32_t>((*this)() >> 32)) * bound;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<std::uint32_t>(product >> 32);
+    }
+
+    /**
+     * Draws a uniform integer in [low, high].
+     * @param low The smallest value.
+     * @param high The largest value, at least low.
+     * @return The random value.
+     */
+    int between(int low, int high) {
+        return low + static_cast<int>(below(static_cast<std::uint32_t>(high - low) + 1));
+    }
+
+    /**
+     * Draws a uniform double in [0, 1) with 53 random bits.
+     * @return The random value.
+     */
+    double uniform() {
+        return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+    }
+
+    /**
+     * Shuffles a range with the Fisher-Yates algorithm. Unlike std::shuffle the result only depends on
+     * the generator, not on the standard library's distributions.
+     * @param first Iterator to the first element.
+     * @param last Iterator past the last element.
+     */
+    template <typename RandomIterator>
+    void shuffle(RandomIterator first, RandomIterator last) {
+        for (auto count = last - first; count > 1; --count) {
+            std::swap(first[count - 1], first[below(static_cast<std::uint32_t>(count))]);
+        }
+    }
+};
+
+#endif
@@ -4,31 +4,132 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+#include <utility>
+
+#include "DistanceMatrix.h"
+#include "MoveEvaluator.h"
+#include "Neighborhood.h"
+#include "CandidateList.h"
+#include "LocalSearch.h"
+#include "ThreadPool.h"
+#include "RandomGenerator.h"
+#include "ConstructionHeuristic.h"
+#include "ElitePool.h"
+#include "AnnealingSchedule.h"
+#include "StopCriterion.h"
+
+class GreedyAlgorithm;
 
 /**
  * Class: SimulatedAnnealing
  * --------------------------
  * Implements the Simulated Annealing algorithm for solving the Asymmetric Traveling Salesman Problem (ATSP).
  * The algorithm iteratively improves the solution by exploring the search space while avoiding local minima
- * through probabilistic acceptance of worse solutions. The temperature decreases over time based on a cooling factor.
+ * through probabilistic acceptance of worse solutions. The temperature is held constant for an epoch of proposals
+ * and changed between epochs by the selected AnnealingSchedule (geometric, Lundy-Mees or adaptive).
  */
 class SimulatedAnnealing {
+public:
+    static constexpr double HOT_ACCEPTANCE = 0.5;   ///< Probability of the hottest tempering rung accepting an average uphill move.
+    static constexpr double COLD_ACCEPTANCE = 0.01; ///< Probability of the coldest tempering rung accepting the smallest uphill move.
+    static constexpr long long GREEDY_SCAN_BUDGET = 1LL << 26; ///< Matrix entries the greedy start tour may scan; bounds its start cities on large instances.
+
 private:
     /**
-     * Adjacency matrix representing distances between nodes in the graph.
+     * State and results of one annealing chain.
+     */
+    struct AnnealingChain {
+        std::vector<int> currentSolution; ///< Current open tour, initialised with the start tour.
+        std::vector<int> bestSolution;    ///< Best open tour of the chain.
+        int bestCost = 0;                 ///< Cost of bestSolution.
+        double bestTimestamp = 0.0;       ///< Seconds since the start when bestSolution was found.
+        long long proposals = 0;          ///< Number of moves evaluated by the chain.
+        double duration = 0.0;            ///< Seconds since the start when the chain stopped.
+        StopReason stopReason = StopReason::RUNNING; ///< Why the chain stopped.
+        double initialTemperature = 0.0;  ///< Temperature derived from the start tour.
+        double finalTemperature = 0.0;    ///< Temperature when the chain stopped.
+        long long epochs = 0;             ///< Number of completed epochs.
+        int reheats = 0;                  ///< Number of reheats of the frozen chain.
+        std::vector<AnnealingSchedule::EpochRecord> trace; ///< Per-epoch temperature and acceptance trace.
+        std::vector<std::pair<double, int>> improvements; ///< (seconds, cost) of every new best of the chain.
+        RandomGenerator generator;        ///< Random stream owned by the chain.
+    };
+
+    /**
+     * One rung of the parallel tempering ladder. The temperature and generator stay with the rung,
+     * solution, positions and cost move between rungs on an accepted exchange.
      */
-    const std::vector<std::vector<int>>& graph;
+    struct TemperingReplica {
+        double temperature = 0.0;      ///< Fixed temperature of the rung.
+        std::vector<int> solution;     ///< Current open tour.
+        std::vector<int> positions;    ///< Position index of solution.
+        int cost = 0;                  ///< Cost of solution.
+        std::vector<int> bestSolution; ///< Best open tour seen at this rung.
+        int bestCost = 0;              ///< Cost of bestSolution.
+        double bestTimestamp = 0.0;    ///< Seconds since the start when bestSolution was found.
+        long long proposals = 0;       ///< Moves evaluated at this rung.
+        long long accepted = 0;        ///< Moves accepted at this rung.
+        std::vector<std::pair<double, int>> improvements; ///< (seconds, cost) of every new best at this rung.
+        RandomGenerator generator;     ///< Random stream of the rung.
+    };
 
     /**
-     * Cooling rate used to decrease the temperature.
+     * Best solution over all parallel chains. The cost is atomic so chains can compare against it
+     * without locking; the tour itself is only copied under the mutex.
+     */
+    struct SharedBest {
+        std::atomic<int> bestCost{std::numeric_limits<int>::max()}; ///< Cost of the global best, read lock-free.
+        std::mutex solutionMutex;                                   ///< Guards bestSolution and solutionCost.
+        std::vector<int> bestSolution;                              ///< Global best open tour.
+        int solutionCost = std::numeric_limits<int>::max();         ///< Cost of bestSolution.
+        std::atomic<bool> cancelled{false};                         ///< Raised by a chain reaching the target cost.
+
+        void publish(const std::vector<int>& solution, int cost);
+        bool fetchIfBetter(std::vector<int>& solution, int& cost);
+    };
+
+    /**
+     * Shared matrix of distances between nodes in the graph.
+     */
+    std::shared_ptr<const DistanceMatrix> graph;
+
+    /**
+     * Cooling rate of the geometric schedule, applied once per epoch.
      * Typical values are between 0.8 and 0.99.
      */
     double coolingFactor;
 
     /**
-     * Maximum time allowed for the algorithm to run, in seconds.
+     * Schedule changing the temperature between epochs.
+     */
+    CoolingSchedule schedule;
+
+    /**
+     * Proposals per city and epoch.
+     */
+    int epochFactor;
+
+    /**
+     * Limits ending every chain: the time limit given to the constructor, and optionally an iteration
+     * (proposal) budget, a no-improvement window in proposals and a target cost.
+     */
+    StopLimits stopLimits;
+
+    /**
+     * Cancel flag shared with cooperating searches, nullptr when running alone.
+     */
+    std::atomic<bool>* cancelFlag;
+
+    /**
+     * Why the last run stopped.
      */
-    double maxTime;
+    StopReason stopReason;
 
     /**
      * Number of nodes in the graph.
@@ -60,35 +161,263 @@ private:
      */
     double bestSolutionTimestamp;
 
+    /**
+     * Number of candidate moves evaluated during the last run.
+     */
+    long long proposalCount;
+
+    /**
+     * (seconds, cost) of every improvement of the best solution during the last run.
+     */
+    std::vector<std::pair<double, int>> improvementHistory;
+
+    /**
+     * Per-epoch trace of the chain that found the best solution during the last run.
+     */
+    std::vector<AnnealingSchedule::EpochRecord> temperatureTrace;
+
+    /**
+     * Number of epochs completed by all chains during the last run.
+     */
+    long long epochCount;
+
+    /**
+     * Number of reheats of all chains during the last run.
+     */
+    int reheatCount;
+
+    /**
+     * Candidate lists biasing the random moves towards near-neighbour arcs, may be empty.
+     */
+    std::shared_ptr<const CandidateList> candidateList;
+
+    /**
+     * Neighbourhoods the random moves are drawn from.
+     */
+    std::vector<std::unique_ptr<Neighborhood>> neighborhoods;
+
+    /**
+     * Local search polishing the final best solution, nullptr when disabled.
+     */
+    std::unique_ptr<LocalSearch> localSearch;
+
+    /**
+     * Interval in seconds between local search runs on the current solution, 0 to only polish the final solution.
+     */
+    double localSearchPeriod;
+
+    /**
+     * Number of independent chains run in parallel, 1 for the classic single chain.
+     */
+    int chainCount;
+
+    /**
+     * Thread pool running the additional chains, not owned.
+     */
+    ThreadPool* threadPool;
+
+    /**
+     * Interval in seconds after which a chain restarts from the global best if that is better, 0 to disable.
+     */
+    double restartPeriod;
+
+    /**
+     * Number of rungs of the parallel tempering ladder, 1 when the cooling schedule is used.
+     */
+    int temperingReplicas;
+
+    /**
+     * Seed of the random streams, drawn from std::random_device unless set with setSeed().
+     */
+    std::uint64_t seed;
+
+    /**
+     * Heuristic building the start tour of the (first) chain; the other chains start from greedy tours of other cities.
+     */
+    ConstructionType construction;
+
+    /**
+     * Given closed start tour of the (first) chain, takes precedence over the construction; may be empty.
+     */
+    std::vector<int> initialTour;
+
+    /**
+     * Pool shared with concurrent solvers, nullptr when running alone.
+     */
+    ElitePool* elitePool;
+
+    /**
+     * Seconds without a new best after which a chain continues from a tour drawn from elitePool.
+     */
+    double stagnationPeriod;
+
+    /**
+     * Whether the run statistics are printed to std::cout.
+     */
+    bool verbose;
+
     /**
      * Calculates the total cost of a given solution.
      * @param solution The current solution represented as a sequence of node indices.
-     * @param adjacencyMatrix The graph's adjacency matrix.
+     * @param adjacencyMatrix The graph's distance matrix, passed by reference so no copy is made per call.
      * @param dimension The number of nodes in the graph.
      * @return The total cost of the solution.
      */
-    int calculateCost(const std::vector<int>& solution, std::vector<std::vector<int>> adjacencyMatrix, int dimension);
+    int calculateCost(const std::vector<int>& solution, const DistanceMatrix& adjacencyMatrix, int dimension) const;
+
+    /**
+     * Draws a random move from one of the enabled neighbourhoods, keeping the city at position 0 in place.
+     * @param solution The current solution.
+     * @param positions Position index of the current solution.
+     * @param generator The random number generator of the run.
+     * @return The proposed move.
+     */
+    Move generateRandomMove(const std::vector<int>& solution, const std::vector<int>& positions, RandomGenerator& generator) const;
 
     /**
      * Runs the Simulated Annealing algorithm for a given initial solution.
-     * @param initialSolution The starting solution for the algorithm.
+     * Moves are evaluated in O(1) and only accepted moves modify the tour.
+     * @param initialSolution The starting solution for the algorithm, an open tour of all nodes.
      */
     void runSimulatedAnnelingFor(std::vector<int> initialSolution);
 
+    /**
+     * Runs chainCount independent chains on the thread pool and keeps the best result.
+     * @param greedySolver The greedy algorithm providing the start tours of the other chains.
+     * @param startTour The constructed closed start tour of the first chain.
+     */
+    void runParallelChains(const GreedyAlgorithm& greedySolver, const std::vector<int>& startTour);
+
+    /**
+     * Runs temperingReplicas replicas at a ladder of fixed temperatures with periodic state exchanges
+     * between neighbouring rungs, and prints the move and exchange acceptance rate of every rung.
+     * @param greedySolver The greedy algorithm providing the start tours of the other rungs.
+     * @param startTour The constructed closed start tour of the first rung.
+     */
+    void runParallelTempering(const GreedyAlgorithm& greedySolver, const std::vector<int>& startTour);
+
+    /**
+     * Builds the start tour of one of several parallel searches.
+     * @param greedySolver The greedy algorithm providing tours from other start cities.
+     * @param startTour The constructed closed start tour.
+     * @param index Index of the search, 0 receives startTour.
+     * @param count Number of searches.
+     * @param generator Random stream of the search.
+     * @return The open start tour.
+     */
+    std::vector<int> buildStartTour(const GreedyAlgorithm& greedySolver, const std::vector<int>& startTour, int index, int count,
+                                    RandomGenerator& generator) const;
+
+    /**
+     * Runs one annealing chain from startTime until a stop limit is reached. Does not modify the solver, so
+     * several chains may run concurrently.
+     * @param chain The chain holding its start tour and seeded generator, receives the results.
+     * @param startTime The common start of the run.
+     * @param shared The global best of all chains, nullptr when running a single chain.
+     */
+    void runChain(AnnealingChain& chain, std::chrono::high_resolution_clock::time_point startTime, SharedBest* shared) const;
+
+    /**
+     * Merges the improvements of several parallel searches into the improvements of their common best.
+     * @param events (seconds, cost) pairs of all searches, in any order.
+     * @return The events that lowered the best cost over all searches, in order of time.
+     */
+    static std::vector<std::pair<double, int>> mergeImprovements(std::vector<std::pair<double, int>> events);
+
 public:
     /**
      * Constructor for SimulatedAnnealing.
-     * @param graph The graph's adjacency matrix representing distances between nodes.
+     * @param graph The shared matrix of distances between nodes.
      * @param coolingFactor The cooling rate for the algorithm.
      * @param maxTime The maximum time allowed for the algorithm to run.
+     * @param neighborhoodTypes The neighbourhoods random moves are drawn from.
+     * @param candidates Candidate lists biasing the random moves towards near-neighbour arcs, nullptr for uniform moves.
      */
-    SimulatedAnnealing(const std::vector<std::vector<int>>& graph, double coolingFactor, double maxTime);
+    SimulatedAnnealing(std::shared_ptr<const DistanceMatrix> graph, double coolingFactor, double maxTime,
+                       const std::vector<NeighborhoodType>& neighborhoodTypes = {NeighborhoodType::SWAP, NeighborhoodType::OR_OPT},
+                       std::shared_ptr<const CandidateList> candidates = nullptr);
 
     /**
      * Executes the Simulated Annealing algorithm to find the optimal solution.
      */
     void solve();
 
+    /**
+     * Enables or disables the LocalSearch (VND) post-optimisation. When enabled the best solution is polished
+     * when the time runs out, which may extend the run slightly past the time limit.
+     * @param enabled Whether to run the local search.
+     * @param periodSeconds Also polish the current solution every periodSeconds during the run, 0 to disable.
+     */
+    void setLocalSearch(bool enabled, double periodSeconds = 0.0);
+
+    /**
+     * Selects the schedule changing the temperature between epochs, adaptive by default.
+     * @param type The cooling schedule.
+     * @param proposalsPerCity Length of an epoch in proposals per city.
+     */
+    void setSchedule(CoolingSchedule type, int proposalsPerCity = AnnealingSchedule::DEFAULT_EPOCH_FACTOR);
+
+    /**
+     * Sets the limits ending a run, replacing the time limit given to the constructor. Every parallel chain
+     * has its own proposal budget and no-improvement window; the rungs of parallel tempering split the budget
+     * and window evenly and share the best cost. All modes check the limits after every proposal.
+     * @param limits Time limit and optional proposal budget, no-improvement window and target cost.
+     * @param flag Cancel flag shared with cooperating searches: raised when a chain reaches the target cost,
+     *             and ending the chains when another search raises it. nullptr to run alone.
+     */
+    void setStopLimits(const StopLimits& limits, std::atomic<bool>* flag = nullptr);
+
+    /**
+     * Enables the multi-start mode: chains independent annealing chains, each with its own start tour
+     * and random stream, run until the common deadline and the best result over all chains is kept.
+     * @param chains Number of chains, 1 for the classic single chain.
+     * @param pool Thread pool running chains 1..chains-1, chain 0 runs on the calling thread.
+     * @param restartSeconds Every restartSeconds a chain jumps to the global best if it is better, 0 to disable.
+     */
+    void setParallelChains(int chains, ThreadPool* pool, double restartSeconds = 0.0);
+
+    /**
+     * Enables the replica-exchange (parallel tempering) mode instead of the cooling schedule:
+     * replicas copies of the search run concurrently at a geometric ladder of fixed temperatures and
+     * periodically exchange their states with neighbouring rungs. Takes precedence over parallel chains.
+     * @param replicas Number of temperature rungs, 1 disables the mode.
+     * @param pool Thread pool sweeping the replicas, nullptr to sweep them on the calling thread.
+     */
+    void setParallelTempering(int replicas, ThreadPool* pool);
+
+    /**
+     * Sets the seed of the run, making it reproducible up to the timing of the time limit.
+     * Parallel chains and tempering rungs draw from independent streams of the seed.
+     * @param value The seed.
+     */
+    void setSeed(std::uint64_t value);
+
+    /**
+     * Selects the construction heuristic building the start tour, nearest neighbour by default.
+     * @param type The construction heuristic.
+     */
+    void setConstruction(ConstructionType type);
+
+    /**
+     * Starts the (first) chain from the given tour instead of a constructed one.
+     * @param tour The closed start tour, the start city repeated at the end.
+     */
+    void setStartTour(const std::vector<int>& tour);
+
+    /**
+     * Lets the chains cooperate with concurrent solvers: every new best solution is published to the pool,
+     * and after stagnationSeconds without one a chain continues from a solution drawn from the pool.
+     * @param pool The shared elite pool, nullptr to run alone.
+     * @param stagnationSeconds Seconds without improvement before a solution is pulled.
+     */
+    void setElitePool(ElitePool* pool, double stagnationSeconds);
+
+    /**
+     * Enables or disables the run statistics printed to std::cout, e.g. when several solvers run concurrently.
+     * @param enabled Whether to print them.
+     */
+    void setVerbose(bool enabled);
+
     /**
      * Retrieves the best solution found during the search.
      * @return The best solution as a sequence of node indices.
@@ -107,6 +436,42 @@ public:
      */
     double getBestSolutionTimestamp() const;
 
+    /**
+     * Retrieves the number of candidate moves evaluated by the last run.
+     * @return The number of proposals.
+     */
+    long long getProposalCount() const;
+
+    /**
+     * Retrieves every improvement of the best solution during the last run, for time-to-target statistics.
+     * @return Pairs of (seconds since the start, cost), in order of time with strictly decreasing cost.
+     */
+    std::vector<std::pair<double, int>> getImprovementHistory() const;
+
+    /**
+     * Retrieves the per-epoch trace of the chain that found the best solution, empty for parallel tempering.
+     * @return The (seconds, temperature, acceptance rate, cost) records, thinned to at most AnnealingSchedule::TRACE_CAPACITY.
+     */
+    std::vector<AnnealingSchedule::EpochRecord> getTemperatureTrace() const;
+
+    /**
+     * Retrieves the number of epochs completed by all chains during the last run.
+     * @return The number of epochs.
+     */
+    long long getEpochCount() const;
+
+    /**
+     * Retrieves the number of reheats of all chains during the last run.
+     * @return The number of reheats.
+     */
+    int getReheatCount() const;
+
+    /**
+     * Retrieves why the last run stopped; for parallel chains, why the chain with the best solution stopped.
+     * @return The stop reason.
+     */
+    StopReason getStopReason() const;
+
     /**
      * Saves the results (best solution and its cost) to a specified file.
      * @param fileName The name of the file to save the results to.
@@ -0,0 +1,154 @@
+#ifndef STOP_CRITERION_H
+#define STOP_CRITERION_H
+
+#include <string>
+#include <atomic>
+#include <chrono>
+
+/**
+ * Enum class representing why a run ended.
+ */
+enum class StopReason {
+    RUNNING,         ///< No limit has been reached yet.
+    TIME_LIMIT,      ///< The wall-clock limit ran out.
+    ITERATION_LIMIT, ///< The iteration budget was used up.
+    STALLED,         ///< The best cost did not improve for the no-improvement window.
+    TARGET_REACHED,  ///< A tour at or below the target cost was found.
+    CANCELLED        ///< A cooperating search raised the shared cancel flag.
+};
+
+/**
+ * Limits ending a run. The run stops as soon as any of the enabled limits is reached.
+ */
+struct StopLimits {
+    static constexpr long long NO_TARGET = -1; ///< Target cost disabling the target.
+
+    double seconds = 60.0;             ///< Wall-clock limit in seconds.
+    long long iterations = 0;          ///< Iteration budget, 0 for none.
+    long long stallIterations = 0;     ///< Iterations without a new best ending the run, 0 for none.
+    long long targetCost = NO_TARGET;  ///< Cost ending the run once reached, NO_TARGET for none.
+    std::chrono::high_resolution_clock::time_point startTime{}; ///< Common start of cooperating searches, the clock's epoch for none.
+
+    /**
+     * Gets the point the time limit counts from: the common start if one is set, so a search started late
+     * only gets the rest of the budget, and the current time otherwise.
+     * @return The start of the run.
+     */
+    std::chrono::high_resolution_clock::time_point runStart() const {
+        return startTime == std::chrono::high_resolution_clock::time_point{} ? std::chrono::high_resolution_clock::now() : startTime;
+    }
+};
+
+/**
+ * Stop test of a solver's hot loop. Every call of shouldStop() costs one comparison against the next
+ * iteration at which anything can change; only then are the limits evaluated and the clock read.
+ *
+ * The clock is read every checkPeriod iterations. The period is auto-calibrated on every read so that
+ * reads are about CHECK_INTERVAL seconds apart, changing at most by a factor of two per read, so a slow
+ * iteration (or a phase of slow iterations) shortens it again quickly. The deadline is therefore missed
+ * by about CHECK_INTERVAL at most. Iteration budget, no-improvement window and target cost are exact.
+ *
+ * Several searches may share a cancel flag: a search reaching the target cost raises it, and the others
+ * stop at their next clock read.
+ */
+class StopCriterion {
+public:
+    static constexpr double CHECK_INTERVAL = 1e-3;          ///< Seconds between clock reads the period is tuned to.
+    static constexpr long long MAX_CHECK_PERIOD = 1LL << 20; ///< Longest check period in iterations.
+
+private:
+    using Clock = std::chrono::high_resolution_clock;
+
+    StopLimits limits;                  ///< The enabled limits.
+    Clock::time_point startTime;        ///< Start of the run.
+    std::atomic<bool>* cancelFlag;      ///< Flag shared with cooperating searches, may be nullptr.
+    long long nextCheck;                ///< Next iteration at which check() runs.
+    long long nextClockCheck;           ///< Next iteration at which the clock is read.
+    long long checkPeriod;              ///< Iterations between clock reads.
+    long long lastClockIteration;       ///< Iteration of the last clock read.
+    long long lastImprovement;          ///< Iteration of the last new best.
+    double lastElapsed;                 ///< Seconds since the start at the last clock read.
+    long long clockReads;               ///< Number of clock reads.
+    StopReason reason;                  ///< Why the run stopped, RUNNING before.
+
+    /**
+     * Evaluates all limits, reading the clock when its period is over, and schedules the next check.
+     * @param iteration The current iteration.
+     * @return True if the run has to stop.
+     */
+    bool check(long long iteration);
+
+    /**
+     * Sets nextCheck to the first iteration at which a limit or the clock has to be looked at.
+     */
+    void scheduleNextCheck();
+
+public:
+    /**
+     * Constructor for StopCriterion.
+     * @param limits The limits of the run.
+     * @param flag Cancel flag shared with cooperating searches, nullptr to run alone.
+     */
+    explicit StopCriterion(const StopLimits& limits, std::atomic<bool>* flag = nullptr);
+
+    /**
+     * Starts the run at iteration 0, reading the clock once.
+     * @param start The start of the run, shared by cooperating searches; may lie in the past.
+     */
+    void start(std::chrono::high_resolution_clock::time_point start);
+
+    /**
+     * Tests whether the run has to stop, reading the clock only every checkPeriod iterations.
+     * @param iteration The number of iterations done so far, never decreasing.
+     * @return True if a limit has been reached; getReason() tells which.
+     */
+    bool shouldStop(long long iteration) {
+        return iteration >= nextCheck && check(iteration);
+    }
+
+    /**
+     * Records a new best tour, restarting the no-improvement window and testing the target cost.
+     * @param iteration The current iteration.
+     * @param cost The cost of the new best tour.
+     */
+    void recordImprovement(long long iteration, long long cost);
+
+    /**
+     * Reads the clock.
+     * @return Seconds since the start of the run.
+     */
+    double elapsed() const;
+
+    /**
+     * Gets the time of the last clock read, without reading the clock.
+     * @return Seconds since the start of the run, at most about CHECK_INTERVAL old while the run goes on.
+     */
+    double getLastElapsed() const;
+
+    /**
+     * Gets why the run stopped.
+     * @return The reason, RUNNING while no limit has been reached.
+     */
+    StopReason getReason() const;
+
+    /**
+     * Gets the current number of iterations between clock reads.
+     * @return The check period.
+     */
+    long long getCheckPeriod() const;
+
+    /**
+     * Gets the number of clock reads since the start.
+     * @return The count.
+     */
+    long long getClockReads() const;
+
+    /**
+     * Retrieves a description of a stop reason, e.g. for the run statistics.
+     * @param reason The stop reason.
+     * @return The description.
+     */
+    static std::string reasonName(StopReason reason);
+};
+
+#endif
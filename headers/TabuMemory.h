@@ -0,0 +1,191 @@
+#ifndef TABU_MEMORY_H
+#define TABU_MEMORY_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "MoveEvaluator.h"
+
+/**
+ * Enum class representing the move attributes a tabu memory forbids.
+ */
+enum class TabuAttribute {
+    POSITION, ///< A move is tabu while both of its end positions were moved recently.
+    ARC       ///< A move is tabu if it re-creates an arc removed recently.
+};
+
+/**
+ * Short-term memory of Tabu Search, kept in flat arrays whose size grows linearly with the number of cities.
+ *
+ * Position attributes store one expiry iteration per tour position. Arc attributes store the expiry of every
+ * recently removed arc in an open-addressed table of about 4n entries, probed a few slots deep; when all slots
+ * of an arc are live the one expiring first is overwritten, so a collision can only end a tenure early.
+ *
+ * The memory also keeps a 64-bit Zobrist fingerprint of the current tour: the XOR of one pseudo-random key
+ * per arc, updated from the arcs a move removes and adds. The arc keys are derived from two random words
+ * per city, so no n x n key table is needed, and every rotation of a tour has the same fingerprint. A
+ * direct-mapped history of visited fingerprints detects when the search returns to an earlier tour.
+ *
+ * The reactive tenure (Battiti and Tecchiolli) starts at n / 4. Every return to a tour lengthens it by 10%,
+ * and every stretch of twice the mean cycle length without one shortens it by 10%, within [MIN_TENURE, n / 2].
+ * A fixed tenure only counts the returns.
+ */
+class TabuMemory {
+public:
+    static constexpr int REACTIVE_TENURE = 0;        ///< Tenure argument selecting the reactive tenure.
+    static constexpr int MIN_TENURE = 5;             ///< Shortest reactive tenure.
+    static constexpr int HISTORY_CAPACITY = 1 << 14; ///< Fingerprints kept to detect returns to earlier tours.
+
+private:
+    /**
+     * Tenure of one removed arc.
+     */
+    struct ArcTenure {
+        int from = -1;  ///< Tail of the arc, -1 for an empty entry.
+        int to = -1;    ///< Head of the arc.
+        int expiry = 0; ///< Iteration from which re-creating the arc is allowed again.
+    };
+
+    static constexpr int ARC_PROBES = 4; ///< Slots of the arc table an arc may occupy.
+
+    int citiesCount;                        ///< Number of cities.
+    TabuAttribute attribute;                ///< Attribute made tabu by a move.
+    int fixedTenure;                        ///< Tenure in iterations, REACTIVE_TENURE for the reactive tenure.
+    double tenure;                          ///< Current tenure, adapted when reactive.
+    int maxTenure;                          ///< Longest reactive tenure.
+    std::vector<int> positionExpiry;        ///< positionExpiry[p] is the iteration from which position p may move again.
+    std::vector<ArcTenure> arcTable;        ///< Tenures of removed arcs, a power of two entries.
+    std::vector<std::uint64_t> tailKeys;    ///< Random word of every city as the tail of an arc.
+    std::vector<std::uint64_t> headKeys;    ///< Random word of every city as the head of an arc.
+    std::uint64_t fingerprint;              ///< Zobrist fingerprint of the current tour.
+    std::vector<std::uint64_t> historyFingerprints; ///< Visited fingerprints, indexed by their low bits.
+    std::vector<int> historyIterations;     ///< Iteration of the last visit of every stored fingerprint.
+    double meanCycleLength;                 ///< Moving average of the iterations between returns to a tour.
+    int lastTenureChange;                   ///< Iteration of the last return or reactive tenure change.
+    long long repetitionCount;              ///< Returns to an earlier tour since the last reset.
+
+    /**
+     * Computes the Zobrist key of an arc.
+     * @param from The tail of the arc.
+     * @param to The head of the arc.
+     * @return The 64-bit key.
+     */
+    std::uint64_t arcKey(int from, int to) const;
+
+    /**
+     * Lists the arcs a move removes from a tour and the arcs it adds.
+     * @param tour The tour before the move.
+     * @param move The move.
+     * @param removed Output, up to four (tail, head) pairs.
+     * @param added Output, up to four (tail, head) pairs.
+     * @return The number of arcs removed, equal to the number added.
+     */
+    static int moveArcs(const std::vector<int>& tour, const Move& move, int removed[][2], int added[][2]);
+
+    /**
+     * Gets the last position a move modifies.
+     * @param move The move.
+     * @return The second position of a swap, the third of a segment exchange.
+     */
+    static int lastPosition(const Move& move);
+
+    /**
+     * Gets the tenure a run starts with.
+     * @return The fixed tenure, or a quarter of the cities within the reactive bounds.
+     */
+    int initialTenure() const;
+
+    /**
+     * Gets the current tenure in whole iterations.
+     * @return The tenure.
+     */
+    int tenureIterations() const;
+
+public:
+    /**
+     * Constructor for TabuMemory.
+     * @param cities The number of cities.
+     * @param attribute The attribute made tabu by a move.
+     * @param tenure Iterations an attribute stays tabu, REACTIVE_TENURE for the reactive tenure.
+     */
+    TabuMemory(int cities, TabuAttribute attribute = TabuAttribute::ARC, int tenure = REACTIVE_TENURE);
+
+    /**
+     * Clears all tenures and the history and starts from a new tour.
+     * @param tour The open tour.
+     */
+    void reset(const std::vector<int>& tour);
+
+    /**
+     * Recomputes the fingerprint after the tour was replaced outside of recordMove(), keeping the tenures.
+     * @param tour The new open tour.
+     */
+    void setTour(const std::vector<int>& tour);
+
+    /**
+     * Checks whether a move is tabu. Reads the memory only, so concurrent scans may call it.
+     * @param tour The current tour.
+     * @param move The move.
+     * @param iteration The current iteration.
+     * @return True if the move is forbidden.
+     */
+    bool isTabu(const std::vector<int>& tour, const Move& move, int iteration) const;
+
+    /**
+     * Makes the attributes of a move tabu and updates the fingerprint. Call before applying the move.
+     * @param tour The tour before the move.
+     * @param move The move about to be applied.
+     * @param iteration The current iteration.
+     */
+    void recordMove(const std::vector<int>& tour, const Move& move, int iteration);
+
+    /**
+     * Looks the current fingerprint up in the history and stores it, adapting the reactive tenure.
+     * @param iteration The current iteration.
+     * @return True if the tour was visited before.
+     */
+    bool registerVisit(int iteration);
+
+    /**
+     * Gets the fingerprint of the current tour.
+     * @return The 64-bit fingerprint.
+     */
+    std::uint64_t getFingerprint() const;
+
+    /**
+     * Gets the current tenure.
+     * @return The tenure in iterations.
+     */
+    int getTenure() const;
+
+    /**
+     * Gets the number of returns to an earlier tour since the last reset.
+     * @return The count.
+     */
+    long long getRepetitionCount() const;
+
+    /**
+     * Computes the fingerprint of a tour from scratch.
+     * @param tour The open tour.
+     * @return The 64-bit fingerprint, equal for every rotation of the tour.
+     */
+    std::uint64_t computeFingerprint(const std::vector<int>& tour) const;
+
+    /**
+     * Parses the short name of an attribute, as used on the command line.
+     * @param name "position" or "arc".
+     * @return The attribute.
+     * @throws std::invalid_argument If the name is unknown.
+     */
+    static TabuAttribute parseAttribute(const std::string& name);
+
+    /**
+     * Retrieves the short name of an attribute, the inverse of parseAttribute().
+     * @param attribute The attribute.
+     * @return The short name.
+     */
+    static std::string attributeName(TabuAttribute attribute);
+};
+
+#endif
@@ -3,24 +3,118 @@
 
 #include <vector>
 #include <string>
-#include <unordered_set>
+#include <memory>
+#include <utility>
+
+#include "DistanceMatrix.h"
+#include "MoveEvaluator.h"
+#include "ThreadPool.h"
+#include "Neighborhood.h"
+#include "CandidateList.h"
+#include "LocalSearch.h"
+#include "RandomGenerator.h"
+#include "ConstructionHeuristic.h"
+#include "ElitePool.h"
+#include "TabuMemory.h"
+#include "StopCriterion.h"
+
+/**
+ * Phases of the reactive Tabu Search.
+ */
+enum class TabuPhase {
+    SEARCH,          ///< From the start tour until the first stagnation.
+    INTENSIFICATION, ///< Continuing from one of the best tours of earlier phases.
+    DIVERSIFICATION  ///< Continuing from a perturbed tour (double-bridge or segment shuffle).
+};
 
 /**
  * Class implementing the Tabu Search algorithm for solving the Traveling Salesman Problem (TSP).
+ * The short-term memory is a TabuMemory: arc or position attributes with a fixed or reactive tenure,
+ * and a Zobrist fingerprint of the current tour detecting returns to earlier tours. A tabu move is
+ * still taken when it leads to a new best tour (aspiration by objective).
+ *
+ * In the reactive mode the search runs in phases. When the best tour of a phase has not improved for
+ * the stagnation period, the phase's best tour enters a small elite set, and the search continues
+ * alternately from an elite tour (intensification) or from the current tour perturbed by a double-bridge
+ * move or a segment shuffle (diversification); a dead end, where every move is tabu, is perturbed as well
+ * instead of restarting. Iterations, move evaluations, time and improvements are counted per phase.
  */
 class TabuSearch {
+public:
+    /**
+     * Work done and results found in one phase kind during a run.
+     */
+    struct PhaseStatistics {
+        int entries = 0;            ///< Times the phase was entered.
+        long long iterations = 0;   ///< Iterations run in the phase.
+        long long evaluations = 0;  ///< Moves evaluated in the phase.
+        double seconds = 0.0;       ///< Wall time spent in the phase.
+        int improvements = 0;       ///< New best tours found in the phase.
+    };
+
+    static constexpr int ELITE_TOURS = 5; ///< Phase best tours kept for intensification.
+
 private:
-    std::vector<std::vector<int>> distanceMatrix; ///< Adjacency matrix representing distances between cities.
-    int tabuLimit;                                 ///< Maximum size of the tabu list.
-    double maxDuration;                      ///< Maximum allowed time for the algorithm to run.
+    /**
+     * Best admissible move found in one block of the neighbourhood.
+     */
+    struct NeighborCandidate {
+        Move move;             ///< The move, valid only if found is true.
+        int delta;             ///< Cost change caused by the move.
+        bool found;            ///< Whether any admissible move was seen in the block.
+        bool aspirated;        ///< Whether the move is tabu and admitted because it leads to a new best tour.
+        long long evaluations; ///< Moves evaluated in the block.
+    };
+
+    /**
+     * A contiguous range of rows of one neighbourhood, the unit of work of the neighbourhood scan.
+     */
+    struct ScanBlock {
+        int neighborhood; ///< Index into neighborhoods.
+        int firstRow;     ///< First row of the block.
+        int lastRow;      ///< One past the last row of the block.
+    };
+
+    std::shared_ptr<const DistanceMatrix> distanceMatrix; ///< Shared matrix of distances between cities.
+    MoveEvaluator moveEvaluator;                   ///< O(1) delta evaluation of moves on distanceMatrix.
+    int tabuTenure;                                ///< Tabu tenure in iterations, TabuMemory::REACTIVE_TENURE for the reactive tenure.
+    TabuAttribute tabuAttribute;                   ///< Attribute made tabu by an applied move.
+    TabuMemory tabuMemory;                         ///< Tenures and tour fingerprints of the current run.
+    StopLimits stopLimits;                         ///< Time limit and optional iteration, no-improvement and target cost limits.
+    std::atomic<bool>* cancelFlag;                 ///< Cancel flag shared with cooperating searches, nullptr when running alone.
+    StopReason stopReason;                         ///< Why the last run stopped.
     std::vector<int> optimalSolution;                    ///< Best tour found during the search.
     int optimalCost;                                 ///< Cost of the best tour.
     std::vector<int> currentSolution;                 ///< Current tour being evaluated.
+    std::vector<int> positions;                       ///< positions[city] is the index of city in currentSolution.
+    std::vector<int> arcWeights;                      ///< arcWeights[p] is the weight of the arc leaving position p of currentSolution.
     int currentSolutionCost;                              ///< Cost of the current tour.
-    std::unordered_set<std::string> tabuList;     ///< Tabu list to avoid revisiting solutions.
     int iterationCounter;                           ///< Number of iterations performed.
-    int noImprovementCount;                        ///< Counter to track stagnation in the search process.
+    int noImprovementCount;                        ///< Iterations since the best tour of the current phase improved.
     double bestSolutionTimestamp;                     ///< Timestamp when the best tour was found.
+    double runDuration;                               ///< Wall-clock duration of the last run in seconds.
+    std::vector<std::pair<double, int>> improvementHistory; ///< (seconds, cost) of every new best tour of the last run.
+    ThreadPool* threadPool;                           ///< Pool used to scan the neighbourhood, nullptr for a serial scan.
+    std::shared_ptr<const CandidateList> candidateList; ///< Candidate lists restricting the neighbourhoods, may be empty.
+    std::vector<std::unique_ptr<Neighborhood>> neighborhoods; ///< Neighbourhoods scanned on every iteration.
+    std::vector<ScanBlock> scanBlocks;                ///< The scan split into blocks, in serial scan order.
+    std::unique_ptr<LocalSearch> localSearch;         ///< Local search polishing the best tour, nullptr when disabled.
+    double localSearchPeriod;                         ///< Seconds between local search runs on the current tour, 0 for final polish only.
+    std::uint64_t seed;                               ///< Seed of the run, drawn from std::random_device unless set with setSeed().
+    RandomGenerator generator;                        ///< Random stream of the run, reseeded by solve().
+    bool constructedStart;                            ///< Whether the run starts from a construction heuristic instead of a random tour.
+    ConstructionType construction;                    ///< Heuristic building the start tour when constructedStart is set.
+    std::vector<int> startTour;                       ///< Given closed start tour, takes precedence over the construction; may be empty.
+    ElitePool* elitePool;                             ///< Pool shared with concurrent solvers, nullptr when running alone.
+    double stagnationPeriod;                          ///< Seconds without a new best after which a tour is pulled from elitePool.
+    bool reactive;                                    ///< Whether the search runs in intensification and diversification phases.
+    int stagnationIterations;                         ///< Iterations without a phase improvement that end a phase, 0 for 2n.
+    TabuPhase phase;                                  ///< Phase of the current iteration.
+    std::vector<int> phaseBestTour;                   ///< Best tour of the current phase.
+    int phaseBestCost;                                ///< Cost of phaseBestTour.
+    std::unique_ptr<ElitePool> phaseElite;            ///< Best tours of ended phases, the intensification targets.
+    std::vector<PhaseStatistics> phaseStatistics;     ///< Statistics of the last run, indexed by TabuPhase.
+    long long aspirationCount;                        ///< Tabu moves taken by aspiration during the last run.
 
     /**
      * Calculates the total cost of a given tour.
@@ -30,69 +124,147 @@ private:
     int computeSolutionCost(const std::vector<int>& tour) const;
 
     /**
-     * Converts a tour into a string representation for use as a key in the tabu list.
-     * @param tour A vector representing the tour.
-     * @return A string representation of the tour.
+     * Evaluates all moves of one block and selects the best one that is not tabu.
+     * @param block The block to scan.
+     * @return The best admissible move of the block.
      */
-    std::string tourToString(const std::vector<int>& tour) const;
+    NeighborCandidate evaluateNeighbors(const ScanBlock& block) const;
 
     /**
-     * Applies a 2-opt move to improve the tour.
-     * @param tour A vector representing the current tour.
+     * Compares two candidates: only a strictly lower delta wins. Candidates are reduced in serial scan
+     * order, so ties go to the earlier move and the parallel scan picks exactly the serial scan's move.
+     * @param candidate The challenging candidate, from a later block.
+     * @param incumbent The best candidate so far.
+     * @return True if candidate should replace incumbent.
      */
-    void applyTwoOpt(std::vector<int>& tour);
+    static bool isBetterCandidate(const NeighborCandidate& candidate, const NeighborCandidate& incumbent);
 
     /**
-     * Applies a 3-opt move to improve the tour.
-     * @param tour A vector representing the current tour.
+     * Checks whether a move is tabu at the current iteration.
+     * @param move The move to check.
+     * @return True if the move is forbidden.
      */
-    void applyThreeOpt(std::vector<int>& tour);
+    bool isTabu(const Move& move) const;
 
     /**
-     * Generates a set of promising neighbors based on the selected neighbor generation strategy.
-     * @return A vector of tours representing the generated neighbors.
+     * Selects the best admissible move of the whole neighbourhood, scanning the blocks on the thread pool when available.
+     * @return The best admissible move.
      */
-    std::vector<std::vector<int>> generatePromisingNeighbors();
+    NeighborCandidate findBestNeighbor();
 
     /**
-     * Evaluates the given neighbors and selects the best one that is not in the tabu list.
-     * @param neighbors A vector of tours representing the neighbors.
-     * @return The best neighbor tour.
+     * Splits the rows of every neighbourhood into blocks holding roughly the same number of moves.
+     * @param size The number of cities.
      */
-    std::vector<int> evaluateNeighbors(const std::vector<std::vector<int>>& neighbors);
+    void computeScanBlocks(int size);
 
     /**
-     * Adds a tour to the tabu list. Removes the oldest entry if the tabu list exceeds its maximum size.
-     * @param tour A vector representing the tour to be added to the tabu list.
+     * Diversifies the search by shuffling a random segment of about a tenth of the current tour.
      */
-    void addToTabuList(const std::vector<int>& tour);
+    void diversifyWithPartialShuffle();
 
     /**
-     * Diversifies the search by performing a partial shuffle of the current tour.
+     * Diversifies the search with a double-bridge move: the tour A B C D becomes A C B D, which keeps the
+     * direction of every segment and cannot be undone by a single swap or or-opt move.
      */
-    void diversifyWithPartialShuffle();
+    void diversifyWithDoubleBridge();
 
     /**
-     * Initializes the current tour with a randomized greedy solution.
+     * Ends the current phase: stores its best tour in the elite set and moves on to the next phase,
+     * intensification after a search or diversification phase if the elite set holds a tour, otherwise
+     * diversification.
+     * @param forceDiversification Perturb the current tour regardless of the phase, used at dead ends.
+     */
+    void changePhase(bool forceDiversification);
+
+    /**
+     * Replaces the current tour with a randomized greedy tour (GreedyAlgorithm::solveRandomizedFromCity)
+     * of a random start city, used to restart when every move is tabu.
      */
     void initializeRandomizedGreedySolution();
 
 public:
     /**
      * Constructor for TabuSearch.
-     * @param matrix The distance matrix representing the TSP instance.
-     * @param tabuSize The maximum size of the tabu list.
+     * @param matrix The shared distance matrix representing the TSP instance.
+     * @param tenure Iterations an attribute of an applied move stays tabu, TabuMemory::REACTIVE_TENURE to adapt it.
      * @param maxTimeInSeconds The maximum time allowed for the algorithm to run.
-     * @param type The neighbor generation strategy to use (RANDOM, OPT_ONLY, or ADAPTIVE).
+     * @param pool Thread pool used to evaluate the neighbourhood in parallel, nullptr for a serial scan.
+     * @param neighborhoodTypes Neighbourhoods scanned on every iteration; their union is searched.
+     * @param candidates Candidate lists restricting the scan to moves creating near-neighbour arcs, nullptr for full scans.
      */
-    TabuSearch(const std::vector<std::vector<int>>& matrix, int tabuSize, double maxTimeInSeconds);
+    TabuSearch(std::shared_ptr<const DistanceMatrix> matrix, int tenure, double maxTimeInSeconds, ThreadPool* pool = nullptr,
+               const std::vector<NeighborhoodType>& neighborhoodTypes = {NeighborhoodType::SWAP},
+               std::shared_ptr<const CandidateList> candidates = nullptr);
 
     /**
      * Runs the Tabu Search algorithm to solve the TSP.
      */
     void solve();
 
-    std::vector<int> generateRandomSolution(int size) const;
+    /**
+     * Enables or disables the LocalSearch (VND) post-optimisation. When enabled the best tour is polished
+     * after the time runs out, which may extend the run slightly past the time limit.
+     * @param enabled Whether to run the local search.
+     * @param periodSeconds Also polish the current tour every periodSeconds during the run, 0 to disable.
+     */
+    void setLocalSearch(bool enabled, double periodSeconds = 0.0);
+
+    /**
+     * Sets the limits ending a run, replacing the time limit given to the constructor.
+     * @param limits Time limit and optional iteration budget, no-improvement window and target cost.
+     * @param flag Cancel flag shared with cooperating searches: raised when this search reaches the target
+     *             cost, and ending this search when another one raises it. nullptr to run alone.
+     */
+    void setStopLimits(const StopLimits& limits, std::atomic<bool>* flag = nullptr);
+
+    /**
+     * Enables or disables the reactive mode with intensification and diversification phases.
+     * @param enabled Whether to run in phases.
+     * @param stagnationLimit Iterations without improvement of a phase's best tour that end the phase, 0 for 2n.
+     */
+    void setReactive(bool enabled, int stagnationLimit = 0);
+
+    /**
+     * Configures the tabu memory of the following runs.
+     * @param attribute The attribute made tabu by an applied move, arcs by default.
+     * @param tenure Iterations it stays tabu, TabuMemory::REACTIVE_TENURE to adapt it.
+     */
+    void setTabuMemory(TabuAttribute attribute, int tenure);
+
+    /**
+     * Sets the seed of the run, making it reproducible up to the timing of the time limit.
+     * @param value The seed.
+     */
+    void setSeed(std::uint64_t value);
+
+    /**
+     * Starts the search from a tour built by a construction heuristic instead of a random tour.
+     * Restarts after a dead end use randomized greedy tours.
+     * @param type The construction heuristic.
+     */
+    void setConstruction(ConstructionType type);
+
+    /**
+     * Starts the search from the given tour, e.g. a greedy tour, instead of a constructed or random one.
+     * @param tour The closed start tour, the start city repeated at the end.
+     */
+    void setStartTour(const std::vector<int>& tour);
+
+    /**
+     * Lets the search cooperate with concurrent solvers: every new best tour is published to the pool,
+     * and after stagnationSeconds without one the search continues from a tour drawn from the pool.
+     * @param pool The shared elite pool, nullptr to run alone.
+     * @param stagnationSeconds Seconds without improvement before a tour is pulled.
+     */
+    void setElitePool(ElitePool* pool, double stagnationSeconds);
+
+    /**
+     * Draws a random tour from the run's random stream.
+     * @param size The number of cities.
+     * @return A random permutation of the cities.
+     */
+    std::vector<int> generateRandomSolution(int size);
 
     int computeSwapDelta(const std::vector<int>& solution, int i, int j) const;
 
@@ -114,6 +286,61 @@ public:
      */
     double getBestTourTimestamp() const;
 
+    /**
+     * Retrieves every improvement of the best tour during the last run, for time-to-target statistics.
+     * @return Pairs of (seconds since the start, cost), in order of time with strictly decreasing cost.
+     */
+    std::vector<std::pair<double, int>> getImprovementHistory() const;
+
+    /**
+     * Gets the number of iterations performed by the last run.
+     * @return The iteration count.
+     */
+    int getIterationCount() const;
+
+    /**
+     * Gets the tabu tenure at the end of the last run, which the reactive tenure adapts during the run.
+     * @return The tenure in iterations.
+     */
+    int getTabuTenure() const;
+
+    /**
+     * Gets the number of returns to an earlier tour during the last run, detected by tour fingerprints.
+     * @return The count.
+     */
+    long long getRepetitionCount() const;
+
+    /**
+     * Retrieves the statistics of every phase of the last run; without the reactive mode all work is in SEARCH.
+     * @return One entry per TabuPhase, in enum order.
+     */
+    std::vector<PhaseStatistics> getPhaseStatistics() const;
+
+    /**
+     * Gets the number of tabu moves taken during the last run because they led to a new best tour.
+     * @return The count.
+     */
+    long long getAspirationCount() const;
+
+    /**
+     * Retrieves a human readable name of a phase.
+     * @param phase The phase.
+     * @return The name.
+     */
+    static std::string phaseName(TabuPhase phase);
+
+    /**
+     * Gets why the last run stopped.
+     * @return The stop reason.
+     */
+    StopReason getStopReason() const;
+
+    /**
+     * Gets the average number of iterations per second of the last run.
+     * @return Iterations per second, or 0 if the search has not been run.
+     */
+    double getIterationsPerSecond() const;
+
     /**
      * Saves the results (number of vertices and best tour) to a file.
      * @param fileName The name of the file to save the results to.
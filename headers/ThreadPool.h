@@ -0,0 +1,76 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+
+/**
+ * Class implementing a persistent pool of worker threads.
+ * Workers are started once and reused for every submitted job, so solvers can fan out work on
+ * each iteration without paying for thread creation. parallelFor() may be called from inside a
+ * job running on the pool: the caller always works on the blocks itself and never waits for a
+ * helper that has not started.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;        ///< Worker threads owned by the pool.
+    std::queue<std::function<void()>> jobs;  ///< Jobs waiting for a free worker.
+    std::mutex queueMutex;                   ///< Guards jobs and stopping.
+    std::condition_variable queueCondition;  ///< Signals new jobs or shutdown to the workers.
+    bool stopping;                           ///< Set by the destructor to let the workers exit.
+
+    /**
+     * Main loop of a worker thread: takes jobs from the queue until the pool is destroyed.
+     */
+    void workerLoop();
+
+    /**
+     * Adds a job to the queue and wakes one worker.
+     * @param job The job to run.
+     */
+    void enqueue(std::function<void()> job);
+
+public:
+    /**
+     * Constructor for ThreadPool.
+     * @param threadCount Number of worker threads, 0 selects std::thread::hardware_concurrency().
+     */
+    explicit ThreadPool(int threadCount = 0);
+
+    /**
+     * Destructor. Finishes the queued jobs and joins all workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Retrieves the number of worker threads.
+     * @return The size of the pool.
+     */
+    int size() const;
+
+    /**
+     * Submits an independent job to the pool.
+     * @param job The job to run.
+     * @return A future that becomes ready when the job finishes and rethrows its exception, if any.
+     */
+    std::future<void> submit(std::function<void()> job);
+
+    /**
+     * Runs task(block) for every block in [0, blockCount) on the workers and the calling thread,
+     * and returns once all blocks are done. Blocks are claimed dynamically, so uneven blocks balance out.
+     * The first exception thrown by a block is rethrown to the caller.
+     * @param blockCount Number of blocks.
+     * @param task Function processing one block.
+     */
+    void parallelFor(int blockCount, const std::function<void(int)>& task);
+};
+
+#endif
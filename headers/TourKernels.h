@@ -0,0 +1,71 @@
+#ifndef TOUR_KERNELS_H
+#define TOUR_KERNELS_H
+
+#include <cstddef>
+#include <string>
+
+#include "DistanceMatrix.h"
+
+/**
+ * Vectorised kernels shared by all solvers: tour costs, masked row minima and rows of swap deltas.
+ * Every kernel has a scalar version and, on x86, AVX2 and AVX-512 versions using gathers for the
+ * arc weights. The widest instruction set supported by the CPU is selected once at run time, so one
+ * binary runs everywhere; the environment variable ATSP_KERNELS (scalar, avx2 or avx512) caps it,
+ * e.g. to compare the versions. All versions return identical results.
+ */
+class TourKernels {
+public:
+    /**
+     * Sums the weights of the arcs between consecutive cities, cities[0] -> cities[1] -> ... -> cities[count - 1].
+     * @param matrix The distance matrix.
+     * @param cities The cities.
+     * @param count Number of cities.
+     * @return The cost of the path, 0 for fewer than two cities.
+     */
+    static int pathCost(const DistanceMatrix& matrix, const int* cities, std::size_t count);
+
+    /**
+     * Computes the cost of an open tour, including the arc from the last back to the first city.
+     * @param matrix The distance matrix.
+     * @param cities The tour.
+     * @param count Number of cities.
+     * @return The cost of the cycle, 0 for an empty tour.
+     */
+    static int cycleCost(const DistanceMatrix& matrix, const int* cities, std::size_t count);
+
+    /**
+     * Finds the cheapest allowed entry of a row. Entries are excluded by a mask of INT_MAX and allowed by
+     * INT_MIN, so the minimum is a branch-free reduction over max(row[i], mask[i]).
+     * @param row The row of weights.
+     * @param mask INT_MIN for allowed entries, INT_MAX for excluded ones.
+     * @param count Number of entries.
+     * @return The lowest index of an allowed entry of minimum weight, -1 if no entry is allowed.
+     */
+    static int maskedArgmin(const int* row, const int* mask, int count);
+
+    /**
+     * Computes the cost changes of the swaps (i, j), first <= j < last, of an open tour. Only non-adjacent
+     * swaps without wrap-around are allowed: i + 2 <= first and last <= size - 1. Within a row the removed
+     * arcs come from arcWeights and the added ones are gathered from the rows of tour[i - 1] and tour[i] and
+     * the transposed columns of tour[i] and tour[i + 1], so no offsets have to be multiplied; without the
+     * transposed copy the scalar loop is used.
+     * @param matrix The distance matrix.
+     * @param tour The open tour.
+     * @param arcWeights arcWeights[p] is the weight of tour[p] -> tour[(p + 1) % size].
+     * @param size Number of cities.
+     * @param i The first position of the swaps.
+     * @param first The first second position.
+     * @param last One past the last second position.
+     * @param deltas Output, deltas[j - first] is the cost change of the swap (i, j).
+     */
+    static void swapDeltas(const DistanceMatrix& matrix, const int* tour, const int* arcWeights, int size, int i,
+                           int first, int last, int* deltas);
+
+    /**
+     * Retrieves the instruction set of the selected kernels.
+     * @return "avx512", "avx2" or "scalar".
+     */
+    static std::string instructionSet();
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef TSPLIB_LOADER_H
+#define TSPLIB_LOADER_H
+
+#include <string>
+#include <memory>
+#include <vector>
+
+#include "DistanceMatrix.h"
+
+/**
+ * Header data and matrix of a loaded TSPLIB instance.
+ */
+struct TsplibInstance {
+    std::string name;                      ///< Value of the NAME keyword.
+    std::string type;                      ///< Value of the TYPE keyword, e.g. ATSP or TSP.
+    int dimension = 0;                     ///< Number of cities.
+    std::string edgeWeightType;            ///< Value of EDGE_WEIGHT_TYPE, e.g. EXPLICIT or EUC_2D.
+    std::string edgeWeightFormat;          ///< Value of EDGE_WEIGHT_FORMAT for explicit instances.
+    double parseSeconds = 0.0;             ///< Wall time spent mapping and parsing the file.
+    bool fromCache = false;                ///< True if the matrix came from the binary MatrixCache.
+    std::shared_ptr<DistanceMatrix> matrix; ///< The parsed distance matrix.
+};
+
+/**
+ * Loader for TSPLIB instance files. The file is memory-mapped and scanned once with a pointer based
+ * number parser that writes straight into the flat DistanceMatrix, without intermediate containers.
+ *
+ * Supported EDGE_WEIGHT_TYPEs are EXPLICIT, with the FULL_MATRIX, UPPER_ROW, LOWER_ROW, UPPER_DIAG_ROW,
+ * LOWER_DIAG_ROW, UPPER_COL, LOWER_COL, UPPER_DIAG_COL and LOWER_DIAG_COL formats, and the coordinate types
+ * EUC_2D, EUC_3D, CEIL_2D, MAN_2D, MAN_3D, MAX_2D, MAX_3D, ATT and GEO, whose distances are computed
+ * with the rounding rules of the TSPLIB specification. Triangular formats describe symmetric instances
+ * and are mirrored; entries missing from them (the diagonal) are 0.
+ */
+class TsplibLoader {
+private:
+    /**
+     * Cursor over the mapped file contents.
+     */
+    struct Scanner {
+        const char* position; ///< Next unread character.
+        const char* end;      ///< One past the last character.
+
+        /**
+         * Skips whitespace.
+         * @return False if the end of the file was reached.
+         */
+        bool skipWhitespace();
+
+        /**
+         * Reads the rest of the current line, trimmed.
+         * @return The line.
+         */
+        std::string readLine();
+
+        /**
+         * Reads an integer; a decimal value is accepted and rounded to the nearest integer.
+         * Throws std::runtime_error if no number follows.
+         * @return The value.
+         */
+        long long readInteger();
+
+        /**
+         * Reads a decimal number. Throws std::runtime_error if no number follows.
+         * @return The value.
+         */
+        double readDouble();
+    };
+
+    /**
+     * Fills the matrix from the numbers of an EDGE_WEIGHT_SECTION.
+     * @param scanner Scanner positioned at the first weight.
+     * @param format The EDGE_WEIGHT_FORMAT.
+     * @param matrix The matrix to fill, of the instance's dimension.
+     */
+    static void readExplicitWeights(Scanner& scanner, const std::string& format, DistanceMatrix& matrix);
+
+    /**
+     * Computes the matrix from the coordinates of a NODE_COORD_SECTION.
+     * @param scanner Scanner positioned at the first node.
+     * @param weightType The EDGE_WEIGHT_TYPE.
+     * @param matrix The matrix to fill, of the instance's dimension.
+     */
+    static void readCoordinates(Scanner& scanner, const std::string& weightType, DistanceMatrix& matrix);
+
+public:
+    /**
+     * Loads a TSPLIB file. Throws std::runtime_error if the file cannot be read, uses an unsupported
+     * format or its weight or coordinate section holds fewer or more numbers than DIMENSION requires.
+     * @param path The path of the file.
+     * @return The instance, with the time spent parsing it.
+     */
+    static TsplibInstance load(const std::string& path);
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include "../headers/AnnealingSchedule.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// Constructor
+AnnealingSchedule::AnnealingSchedule(CoolingSchedule type, double coolingFactor, int cities, int epochFactor)
+    : type(type), coolingFactor(coolingFactor), epochLength(static_cast<long long>(std::max(1, epochFactor)) * std::max(1, cities)),
+      initialTemperature(1.0), finalTemperature(1.0), reheatTemperature(1.0), temperature(1.0), epochCount(0),
+      stagnantEpochs(0), reheatCount(0), traceStride(1) {}
+
+// Calibrate the temperatures and start the first epoch
+void AnnealingSchedule::start(const std::vector<int>& deltas) {
+    initialTemperature = acceptanceTemperature(deltas, INITIAL_ACCEPTANCE);
+    finalTemperature = std::min(initialTemperature, temperatureRange(deltas, INITIAL_ACCEPTANCE, FINAL_ACCEPTANCE).second);
+    reheatTemperature = std::clamp(acceptanceTemperature(deltas, REHEAT_ACCEPTANCE), finalTemperature, initialTemperature);
+    temperature = initialTemperature;
+    epochCount = 0;
+    stagnantEpochs = 0;
+    reheatCount = 0;
+    traceStride = 1;
+    trace.clear();
+}
+
+// Record the epoch and set the temperature of the next one
+bool AnnealingSchedule::endEpoch(double elapsed, double progress, long long uphill, long long accepted, bool improved, int cost) {
+    const double rate = uphill > 0 ? static_cast<double>(accepted) / uphill : 0.0;
+
+    if (epochCount % traceStride == 0) {
+        if (static_cast<int>(trace.size()) == TRACE_CAPACITY) {
+            // Keep the epochs 0, 2s, 4s, ... so the trace stays evenly spaced
+            for (int index = 0; index < TRACE_CAPACITY / 2; ++index) trace[index] = trace[2 * index];
+            trace.resize(TRACE_CAPACITY / 2);
+            traceStride *= 2;
+        }
+        if (epochCount % traceStride == 0) trace.push_back(EpochRecord{elapsed, temperature, rate, cost});
+    }
+    ++epochCount;
+
+    stagnantEpochs = improved ? 0 : stagnantEpochs + 1;
+
+    switch (type) {
+        case CoolingSchedule::GEOMETRIC:
+            temperature *= coolingFactor;
+            break;
+        case CoolingSchedule::LUNDY_MEES: {
+            // beta is re-estimated from the epochs that still fit into the budget, so the schedule ends with it
+            if (progress <= 0.0) break;
+            const double remainingEpochs = (1.0 - progress) * epochCount / progress;
+            if (remainingEpochs >= 1.0 && temperature > finalTemperature) {
+                const double beta = (temperature - finalTemperature) / (remainingEpochs * temperature * finalTemperature);
+                temperature /= 1.0 + beta * temperature;
+            } else {
+                temperature = std::min(temperature, finalTemperature);
+            }
+            break;
+        }
+        case CoolingSchedule::ADAPTIVE: {
+            // With rate ~ exp(-c / T), T * ln(rate) is constant, so T * ln(rate) / ln(target) hits the target
+            const double target = INITIAL_RATE * std::pow(FINAL_RATE / INITIAL_RATE, std::clamp(progress, 0.0, 1.0));
+            const double smoothedRate = std::clamp((accepted + 0.5) / (uphill + 1.0), 1e-9, 1.0 - 1e-9);
+            temperature *= std::clamp(std::log(smoothedRate) / std::log(target), 0.5, 2.0);
+            return false;
+        }
+    }
+
+    const bool frozen = temperature <= finalTemperature || rate < FROZEN_RATE;
+    if (stagnantEpochs < REHEAT_EPOCHS || !frozen) return false;
+
+    temperature = std::max(temperature, reheatTemperature);
+    stagnantEpochs = 0;
+    ++reheatCount;
+    return true;
+}
+
+// Get the temperature of the current epoch
+double AnnealingSchedule::getTemperature() const {
+    return temperature;
+}
+
+// Get the calibrated start temperature
+double AnnealingSchedule::getInitialTemperature() const {
+    return initialTemperature;
+}
+
+// Get the number of proposals per epoch
+long long AnnealingSchedule::getEpochLength() const {
+    return epochLength;
+}
+
+// Get the number of completed epochs
+long long AnnealingSchedule::getEpochCount() const {
+    return epochCount;
+}
+
+// Get the number of reheats
+int AnnealingSchedule::getReheatCount() const {
+    return reheatCount;
+}
+
+// Get the per-epoch trace
+const std::vector<AnnealingSchedule::EpochRecord>& AnnealingSchedule::getTrace() const {
+    return trace;
+}
+
+// Bisection on log T: the mean of exp(-delta / T) over the uphill samples grows with T
+double AnnealingSchedule::acceptanceTemperature(const std::vector<int>& deltas, double acceptance) {
+    std::vector<int> uphill;
+    for (int delta : deltas) {
+        if (delta > 0) uphill.push_back(delta);
+    }
+    if (uphill.empty()) return 1.0;
+
+    auto meanAcceptance = [&uphill](double temperature) {
+        double sum = 0.0;
+        for (int delta : uphill) sum += std::exp(-delta / temperature);
+        return sum / uphill.size();
+    };
+    double low = std::log(*std::min_element(uphill.begin(), uphill.end()) / 100.0);
+    double high = std::log(*std::max_element(uphill.begin(), uphill.end()) * 100.0);
+    for (int step = 0; step < 60; ++step) {
+        const double middle = 0.5 * (low + high);
+        if (meanAcceptance(std::exp(middle)) < acceptance) low = middle;
+        else high = middle;
+    }
+    return std::exp(0.5 * (low + high));
+}
+
+// Temperatures accepting the mean uphill move with hotAcceptance and the smallest one with coldAcceptance
+std::pair<double, double> AnnealingSchedule::temperatureRange(const std::vector<int>& deltas, double hotAcceptance, double coldAcceptance) {
+    double uphillSum = 0.0;
+    int uphillCount = 0;
+    int smallestUphill = std::numeric_limits<int>::max();
+    for (int delta : deltas) {
+        if (delta <= 0) continue;
+        uphillSum += delta;
+        ++uphillCount;
+        smallestUphill = std::min(smallestUphill, delta);
+    }
+    const double averageUphill = uphillCount > 0 ? uphillSum / uphillCount : 1.0;
+    if (uphillCount == 0) smallestUphill = 1;
+
+    const double hottest = -averageUphill / std::log(hotAcceptance);
+    const double coldest = std::min(hottest, -smallestUphill / std::log(coldAcceptance));
+    return {hottest, coldest};
+}
+
+// Parse a schedule name
+CoolingSchedule AnnealingSchedule::parseSchedule(const std::string& name) {
+    if (name == "geometric") return CoolingSchedule::GEOMETRIC;
+    if (name == "lundy-mees") return CoolingSchedule::LUNDY_MEES;
+    if (name == "adaptive") return CoolingSchedule::ADAPTIVE;
+    throw std::invalid_argument("Error: Unknown cooling schedule '" + name + "'.");
+}
+
+// Short name of a schedule
+std::string AnnealingSchedule::scheduleName(CoolingSchedule type) {
+    switch (type) {
+        case CoolingSchedule::GEOMETRIC: return "geometric";
+        case CoolingSchedule::LUNDY_MEES: return "lundy-mees";
+        case CoolingSchedule::ADAPTIVE: return "adaptive";
+    }
+    return "geometric";
+}
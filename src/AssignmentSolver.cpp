@@ -0,0 +1,77 @@
+#include "../headers/AssignmentSolver.h"
+
+#include <cstddef>
+#include <limits>
+
+// One shortest augmenting path (rows and columns are 1-based, 0 is auxiliary)
+long long AssignmentSolver::augment(const std::vector<long long>& costs, int size, int row, std::vector<int>& assignment,
+                                    std::vector<long long>& rowDual, std::vector<long long>& columnDual) {
+    const long long infinity = std::numeric_limits<long long>::max() / 4;
+    std::vector<long long>& u = rowDual;
+    std::vector<long long>& v = columnDual;
+
+    std::vector<int> owner(size + 1, 0);
+    for (int city = 0; city < size; ++city) {
+        if (assignment[city] >= 0) owner[assignment[city] + 1] = city + 1;
+    }
+
+    std::vector<int> way(size + 1, 0);
+    std::vector<long long> minimum(size + 1, infinity);
+    std::vector<char> used(size + 1, 0);
+    owner[0] = row + 1;
+    int column = 0;
+    do {
+        used[column] = 1;
+        int current = owner[column];
+        long long delta = infinity;
+        int next = 0;
+        const long long* costRow = &costs[static_cast<std::size_t>(current - 1) * size];
+        for (int j = 1; j <= size; ++j) {
+            if (used[j]) continue;
+            long long reduced = costRow[j - 1] - u[current] - v[j];
+            if (reduced < minimum[j]) {
+                minimum[j] = reduced;
+                way[j] = column;
+            }
+            if (minimum[j] < delta) {
+                delta = minimum[j];
+                next = j;
+            }
+        }
+        for (int j = 0; j <= size; ++j) {
+            if (used[j]) {
+                u[owner[j]] += delta;
+                v[j] -= delta;
+            } else {
+                minimum[j] -= delta;
+            }
+        }
+        column = next;
+    } while (owner[column] != 0);
+
+    do {
+        int previous = way[column];
+        owner[column] = owner[previous];
+        column = previous;
+    } while (column);
+
+    // Rows assigned one by one leave the later ones free
+    long long cost = 0;
+    for (int j = 1; j <= size; ++j) {
+        if (owner[j] == 0) continue;
+        assignment[owner[j] - 1] = j - 1;
+        cost += costs[static_cast<std::size_t>(owner[j] - 1) * size + j - 1];
+    }
+    return cost;
+}
+
+// Assign the rows one at a time
+std::vector<int> AssignmentSolver::solve(const std::vector<long long>& costs, int size) {
+    std::vector<int> assignment(size, -1);
+    std::vector<long long> rowDual(size + 1, 0);
+    std::vector<long long> columnDual(size + 1, 0);
+    for (int row = 0; row < size; ++row) {
+        augment(costs, size, row, assignment, rowDual, columnDual);
+    }
+    return assignment;
+}
@@ -0,0 +1,217 @@
+#include "../headers/Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sstream>
+
+namespace {
+
+// Escape a string for a JSON string literal
+std::string jsonString(const std::string& value) {
+    std::string escaped = "\"";
+    for (char character : value) {
+        switch (character) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20) continue;
+                escaped += character;
+        }
+    }
+    return escaped + "\"";
+}
+
+double median(const std::vector<double>& sorted) {
+    if (sorted.empty()) return 0.0;
+    std::size_t middle = sorted.size() / 2;
+    return sorted.size() % 2 ? sorted[middle] : 0.5 * (sorted[middle - 1] + sorted[middle]);
+}
+
+double mean(const std::vector<double>& values) {
+    return values.empty() ? 0.0 : std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+}
+
+// Largest cost within targetGap percent of the reference
+long long targetCost(long long reference, double targetGap) {
+    return static_cast<long long>(std::floor(reference * (1.0 + targetGap / 100.0) + 1e-9));
+}
+
+bool isTimed(ExperimentAlgorithm algorithm) {
+    return algorithm != ExperimentAlgorithm::GREEDY && algorithm != ExperimentAlgorithm::HELD_KARP;
+}
+
+}
+
+// First improvement at or below the target
+double Benchmark::timeToTarget(const ExperimentResult& result, long long targetCost) {
+    if (!result.error.empty()) return -1.0;
+    for (const std::pair<double, int>& improvement : result.improvements) {
+        if (improvement.second <= targetCost) return improvement.first;
+    }
+    if (result.improvements.empty() && result.bestCost <= targetCost) return result.timeToBest;
+    return -1.0;
+}
+
+// Group the results and compute gaps, throughput and time-to-target distributions
+std::vector<BenchmarkGroup> Benchmark::summarize(const std::vector<ExperimentResult>& results, const std::vector<double>& targetGaps) {
+    // Gaps are relative to the known optimum, or to the best tour of any run when the optimum is unknown
+    std::map<std::string, long long> references;
+    for (const ExperimentResult& result : results) {
+        if (!result.error.empty()) continue;
+        auto entry = references.find(result.instanceName);
+        if (entry == references.end()) {
+            references[result.instanceName] = result.bestCost;
+        } else {
+            entry->second = std::min(entry->second, result.bestCost);
+        }
+    }
+
+    std::vector<BenchmarkGroup> groups;
+    std::vector<double> gapSums;
+    for (const ExperimentResult& result : results) {
+        const ExperimentJob& job = result.job;
+        auto group = std::find_if(groups.begin(), groups.end(), [&](const BenchmarkGroup& candidate) {
+            return candidate.instanceName == result.instanceName && candidate.algorithm == job.algorithm
+                && candidate.timeLimit == job.timeLimit && candidate.coolingFactor == job.coolingFactor;
+        });
+        if (group == groups.end()) {
+            BenchmarkGroup created;
+            created.instanceName = result.instanceName;
+            created.algorithm = job.algorithm;
+            created.timeLimit = job.timeLimit;
+            created.coolingFactor = job.coolingFactor;
+            long long optimum = ExperimentRunner::knownOptimum(result.instanceName);
+            created.referenceIsOptimum = optimum > 0;
+            auto reference = references.find(result.instanceName);
+            created.reference = optimum > 0 ? optimum : (reference != references.end() ? reference->second : -1);
+            created.targetGaps = targetGaps;
+            created.timesToTarget.resize(targetGaps.size());
+            created.bestGap = std::numeric_limits<double>::max();
+            created.worstGap = std::numeric_limits<double>::lowest();
+            groups.push_back(std::move(created));
+            gapSums.push_back(0.0);
+            group = std::prev(groups.end());
+        }
+
+        if (!result.error.empty()) {
+            ++group->failedRuns;
+            continue;
+        }
+        double gap = group->reference > 0 ? 100.0 * (result.bestCost - group->reference) / group->reference : 0.0;
+        ++group->runs;
+        gapSums[group - groups.begin()] += gap;
+        group->bestGap = std::min(group->bestGap, gap);
+        group->worstGap = std::max(group->worstGap, gap);
+        if (result.wallTime > 0.0) group->iterationsPerSecond += result.iterations / result.wallTime;
+
+        for (std::size_t target = 0; target < targetGaps.size(); ++target) {
+            double time = timeToTarget(result, targetCost(group->reference, targetGaps[target]));
+            if (time >= 0.0) group->timesToTarget[target].push_back(time);
+        }
+    }
+
+    for (std::size_t index = 0; index < groups.size(); ++index) {
+        BenchmarkGroup& group = groups[index];
+        if (group.runs > 0) {
+            group.meanGap = gapSums[index] / group.runs;
+            group.iterationsPerSecond /= group.runs;
+        } else {
+            group.bestGap = group.worstGap = 0.0;
+        }
+        for (std::vector<double>& times : group.timesToTarget) std::sort(times.begin(), times.end());
+    }
+    return groups;
+}
+
+// One row per group and target
+void Benchmark::writeCsv(std::ostream& out, const std::vector<BenchmarkGroup>& groups) {
+    out << "instance,algorithm,time_limit,cooling_factor,reference,reference_is_optimum,runs,failed_runs,"
+           "best_gap,mean_gap,worst_gap,iterations_per_second,target_gap,reached,ttt_min,ttt_median,ttt_mean,ttt_max\n";
+    for (const BenchmarkGroup& group : groups) {
+        for (std::size_t target = 0; target < std::max<std::size_t>(1, group.targetGaps.size()); ++target) {
+            out << group.instanceName << "," << ExperimentRunner::algorithmName(group.algorithm) << ",";
+            if (isTimed(group.algorithm)) out << group.timeLimit;
+            out << ",";
+            if (group.algorithm == ExperimentAlgorithm::SIMULATED_ANNEALING || group.algorithm == ExperimentAlgorithm::PORTFOLIO) out << group.coolingFactor;
+            out << "," << group.reference << "," << (group.referenceIsOptimum ? 1 : 0) << ","
+                << group.runs << "," << group.failedRuns << ","
+                << std::fixed << std::setprecision(3) << group.bestGap << "," << group.meanGap << "," << group.worstGap << ","
+                << std::setprecision(1) << group.iterationsPerSecond << std::defaultfloat << std::setprecision(6) << ",";
+            if (target < group.targetGaps.size()) {
+                const std::vector<double>& times = group.timesToTarget[target];
+                out << group.targetGaps[target] << "," << times.size();
+                if (!times.empty()) {
+                    out << std::fixed << std::setprecision(3) << "," << times.front() << "," << median(times) << ","
+                        << mean(times) << "," << times.back() << std::defaultfloat << std::setprecision(6);
+                } else {
+                    out << ",,,,";
+                }
+            } else {
+                out << ",,,,,";
+            }
+            out << "\n";
+        }
+    }
+}
+
+// Groups with their full distributions
+void Benchmark::writeJson(std::ostream& out, const std::vector<BenchmarkGroup>& groups) {
+    out << std::setprecision(6) << "{\n  \"groups\": [";
+    for (std::size_t index = 0; index < groups.size(); ++index) {
+        const BenchmarkGroup& group = groups[index];
+        out << (index ? "," : "") << "\n    {\n"
+            << "      \"instance\": " << jsonString(group.instanceName) << ",\n"
+            << "      \"algorithm\": " << jsonString(ExperimentRunner::algorithmName(group.algorithm)) << ",\n"
+            << "      \"time_limit\": ";
+        if (isTimed(group.algorithm)) out << group.timeLimit; else out << "null";
+        out << ",\n      \"cooling_factor\": ";
+        if (group.algorithm == ExperimentAlgorithm::SIMULATED_ANNEALING || group.algorithm == ExperimentAlgorithm::PORTFOLIO) out << group.coolingFactor; else out << "null";
+        out << ",\n"
+            << "      \"reference\": " << group.reference << ",\n"
+            << "      \"reference_is_optimum\": " << (group.referenceIsOptimum ? "true" : "false") << ",\n"
+            << "      \"runs\": " << group.runs << ",\n"
+            << "      \"failed_runs\": " << group.failedRuns << ",\n"
+            << "      \"best_gap\": " << group.bestGap << ",\n"
+            << "      \"mean_gap\": " << group.meanGap << ",\n"
+            << "      \"worst_gap\": " << group.worstGap << ",\n"
+            << "      \"iterations_per_second\": " << group.iterationsPerSecond << ",\n"
+            << "      \"time_to_target\": [";
+        for (std::size_t target = 0; target < group.targetGaps.size(); ++target) {
+            const std::vector<double>& times = group.timesToTarget[target];
+            out << (target ? "," : "") << "\n        {\"gap\": " << group.targetGaps[target]
+                << ", \"reached\": " << times.size() << ", \"seconds\": [";
+            for (std::size_t run = 0; run < times.size(); ++run) {
+                out << (run ? ", " : "") << times[run];
+            }
+            out << "]}";
+        }
+        out << (group.targetGaps.empty() ? "" : "\n      ") << "]\n    }";
+    }
+    out << (groups.empty() ? "" : "\n  ") << "]\n}\n";
+}
+
+// Console table
+void Benchmark::printSummary(std::ostream& out, const std::vector<BenchmarkGroup>& groups) {
+    for (const BenchmarkGroup& group : groups) {
+        out << std::left << std::setw(10) << group.instanceName << std::setw(9) << ExperimentRunner::algorithmName(group.algorithm);
+        std::ostringstream limit;
+        if (isTimed(group.algorithm)) limit << group.timeLimit << "s"; else limit << "-";
+        out << std::setw(6) << limit.str() << std::right << std::fixed << std::setprecision(2)
+            << " runs " << group.runs << (group.failedRuns ? " (" + std::to_string(group.failedRuns) + " failed)" : "")
+            << "  gap best " << group.bestGap << "% mean " << group.meanGap << "%"
+            << "  it/s " << std::setprecision(0) << group.iterationsPerSecond << std::setprecision(2);
+        for (std::size_t target = 0; target < group.targetGaps.size(); ++target) {
+            const std::vector<double>& times = group.timesToTarget[target];
+            out << "  <=" << std::defaultfloat << std::setprecision(6) << group.targetGaps[target] << "%: " << times.size() << "/" << group.runs;
+            out << std::fixed << std::setprecision(2);
+            if (!times.empty()) out << " in " << median(times) << "s";
+        }
+        out << std::defaultfloat << std::setprecision(6) << "\n";
+    }
+}
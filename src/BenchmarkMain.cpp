@@ -0,0 +1,186 @@
+/**
+ * ATSP Benchmark Suite
+ * --------------------
+ * Runs the solvers on the bundled instances for a fixed set of seeds and time budgets
+ * and reports gaps to the known optima, iterations per second and time-to-target
+ * distributions as CSV and JSON, so changes can be judged on quality per wall-clock
+ * second rather than on a single run.
+ *
+ * Accepts every option of the batch mode of ATSP_2 (see ATSP_2 --help); options that
+ * are not given default to the bundled instances, greedy, tabu and sa, time budgets
+ * of 1 and 5 seconds and seeds 1..5. Additional options:
+ *   --csv PATH      summary CSV (default: atsp_bench.csv)
+ *   --json PATH     summary JSON (default: atsp_bench.json)
+ *   --targets LIST  target gaps in percent for time to target (default: 0,1,5)
+ *   --out PATH      additionally write the per-run CSV of the batch mode
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+#include "../headers/ExperimentRunner.h"
+#include "../headers/Benchmark.h"
+
+#ifndef ATSP_RESOURCE_DIR
+#define ATSP_RESOURCE_DIR "resources"
+#endif
+
+/**
+ * Checks whether an argument sets the given option, as "--option value" or "--option=value".
+ * @param argument - The argument.
+ * @param names - Long and short names of the option.
+ * @return True if the argument is the option.
+ */
+bool isOption(const std::string& argument, const std::vector<std::string>& names) {
+    for (const std::string& name : names) {
+        if (argument == name || argument.rfind(name + "=", 0) == 0) return true;
+    }
+    return false;
+}
+
+/**
+ * Lists the bundled .atsp instances in name order.
+ * @return Paths of the instances.
+ */
+std::vector<std::string> bundledInstances() {
+    std::vector<std::string> paths;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(ATSP_RESOURCE_DIR, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".atsp") paths.push_back(entry.path().string());
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+/**
+ * Opens an output file, throwing std::runtime_error if it cannot be created.
+ * @param path - The path of the file.
+ * @param file - The stream to open.
+ */
+void openOutput(const std::string& path, std::ofstream& file) {
+    file.open(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error: Could not open file " + path + " for writing.");
+    }
+}
+
+/**
+ * Main Function
+ * -------------
+ * Separates the benchmark options from the batch options, fills in the defaults,
+ * runs the experiments and writes the reports.
+ */
+int main(int argc, char* argv[]) {
+    std::string csvPath = "atsp_bench.csv";
+    std::string jsonPath = "atsp_bench.json";
+    std::vector<double> targetGaps = {0.0, 1.0, 5.0};
+    std::vector<std::string> arguments = {argv[0]};
+
+    try {
+        for (int index = 1; index < argc; ++index) {
+            std::string argument = argv[index];
+            if (!isOption(argument, {"--csv", "--json", "--targets"})) {
+                arguments.push_back(argument);
+                continue;
+            }
+            std::string value;
+            std::size_t equals = argument.find('=');
+            if (equals != std::string::npos) {
+                value = argument.substr(equals + 1);
+                argument = argument.substr(0, equals);
+            } else if (index + 1 < argc) {
+                value = argv[++index];
+            } else {
+                throw std::invalid_argument("Error: Missing value for " + argument + ".");
+            }
+
+            if (argument == "--csv") {
+                csvPath = value;
+            } else if (argument == "--json") {
+                jsonPath = value;
+            } else {
+                targetGaps.clear();
+                std::size_t start = 0;
+                while (start <= value.size()) {
+                    std::size_t comma = std::min(value.find(',', start), value.size());
+                    std::string item = value.substr(start, comma - start);
+                    std::size_t consumed = 0;
+                    double gap = -1.0;
+                    try {
+                        gap = std::stod(item, &consumed);
+                    } catch (const std::exception&) {
+                        consumed = 0;
+                    }
+                    if (consumed == 0 || consumed != item.size() || gap < 0) {
+                        throw std::invalid_argument("Error: Invalid target gap '" + item + "'.");
+                    }
+                    targetGaps.push_back(gap);
+                    start = comma + 1;
+                }
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    auto given = [&arguments](const std::vector<std::string>& names) {
+        return std::any_of(arguments.begin() + 1, arguments.end(), [&names](const std::string& argument) {
+            return isOption(argument, names);
+        });
+    };
+    if (!given({"--instance", "-i"})) {
+        for (const std::string& path : bundledInstances()) {
+            arguments.push_back("--instance");
+            arguments.push_back(path);
+        }
+    }
+    if (!given({"--algo", "-a"})) arguments.insert(arguments.end(), {"--algo", "greedy,tabu,sa"});
+    if (!given({"--time", "-t"})) arguments.insert(arguments.end(), {"--time", "1,5"});
+    if (!given({"--seeds", "-s"})) arguments.insert(arguments.end(), {"--seeds", "1..5"});
+
+    std::vector<char*> argumentPointers;
+    for (std::string& argument : arguments) argumentPointers.push_back(argument.data());
+
+    ExperimentConfig config;
+    try {
+        config = ExperimentRunner::parseArguments(static_cast<int>(argumentPointers.size()), argumentPointers.data());
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n\n" << ExperimentRunner::usage();
+        return 1;
+    }
+    if (config.showHelp) {
+        std::cout << "Usage: atsp_bench [--csv PATH] [--json PATH] [--targets LIST] [batch options]\n"
+                  << "Defaults: bundled instances, --algo greedy,tabu,sa --time 1,5 --seeds 1..5 --targets 0,1,5\n\n"
+                  << ExperimentRunner::usage();
+        return 0;
+    }
+
+    try {
+        std::ofstream csvFile;
+        std::ofstream jsonFile;
+        std::ofstream runsFile;
+        openOutput(csvPath, csvFile);
+        openOutput(jsonPath, jsonFile);
+        if (!config.outputPath.empty()) openOutput(config.outputPath, runsFile);
+
+        ExperimentRunner runner(config);
+        std::vector<ExperimentResult> results = runner.run();
+        std::vector<BenchmarkGroup> groups = Benchmark::summarize(results, targetGaps);
+
+        Benchmark::printSummary(std::cout, groups);
+        Benchmark::writeCsv(csvFile, groups);
+        Benchmark::writeJson(jsonFile, groups);
+        if (runsFile.is_open()) ExperimentRunner::writeCsv(runsFile, results);
+        std::cout << "Reports written to " << csvPath << " and " << jsonPath << ".\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,351 @@
+#include "../headers/BranchAndBound.h"
+#include "../headers/GreedyAlgorithm.h"
+
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+// Constructor
+BranchAndBound::BranchAndBound(std::shared_ptr<const DistanceMatrix> matrix, double maxTime, ThreadPool* pool, std::size_t memoryCapBytes)
+    : distanceMatrix(std::move(matrix)),
+      matrixSize(distanceMatrix->size()),
+      maxTime(maxTime),
+      threadPool(pool),
+      memoryCap(memoryCapBytes),
+      bestCost(std::numeric_limits<long long>::max()),
+      lowerBound(0),
+      nodeCount(0),
+      bestTourTimestamp(0.0) {}
+
+// Memory held by a node
+std::size_t BranchAndBound::Node::memoryUsage() const {
+    return sizeof(Node)
+         + (excluded.capacity() + included.capacity()) * sizeof(std::pair<int, int>)
+         + assignment.capacity() * sizeof(int)
+         + (rowDual.capacity() + columnDual.capacity()) * sizeof(long long);
+}
+
+// Seed the search with a known tour
+void BranchAndBound::setIncumbent(const std::vector<int>& tour, int cost) {
+    std::vector<int> openTour(tour);
+    if (openTour.size() == static_cast<size_t>(matrixSize) + 1 && openTour.front() == openTour.back()) openTour.pop_back();
+    if (openTour.size() != static_cast<size_t>(matrixSize)) {
+        throw std::invalid_argument("Error: Incumbent tour does not match the matrix size.");
+    }
+    if (cost >= bestCost) return;
+
+    // Store it closed and starting at city 0, like the tours of the other solvers
+    auto start = std::find(openTour.begin(), openTour.end(), 0);
+    std::rotate(openTour.begin(), start, openTour.end());
+    openTour.push_back(openTour.front());
+    bestTour = std::move(openTour);
+    bestCost = cost;
+    bestTourTimestamp = 0.0;
+}
+
+// Apply the node's constraints to the instance's matrix
+void BranchAndBound::buildCosts(const Node& node, std::vector<long long>& costs) const {
+    const DistanceMatrix& matrix = *distanceMatrix;
+    const int size = matrixSize;
+    costs.resize(static_cast<size_t>(size) * size);
+    for (int from = 0; from < size; ++from) {
+        const int* row = matrix.row(from);
+        long long* costRow = &costs[static_cast<size_t>(from) * size];
+        for (int to = 0; to < size; ++to) costRow[to] = row[to];
+        costRow[from] = FORBIDDEN_COST;
+    }
+    for (const auto& arc : node.excluded) {
+        costs[static_cast<size_t>(arc.first) * size + arc.second] = FORBIDDEN_COST;
+    }
+    for (const auto& arc : node.included) {
+        for (int city = 0; city < size; ++city) {
+            if (city != arc.second) costs[static_cast<size_t>(arc.first) * size + city] = FORBIDDEN_COST;
+            if (city != arc.first) costs[static_cast<size_t>(city) * size + arc.second] = FORBIDDEN_COST;
+        }
+    }
+}
+
+// Solve the unconstrained assignment problem row by row
+BranchAndBound::Node BranchAndBound::solveRoot() const {
+    Node root;
+    root.assignment.assign(matrixSize, -1);
+    root.rowDual.assign(matrixSize + 1, 0);
+    root.columnDual.assign(matrixSize + 1, 0);
+
+    std::vector<long long> costs;
+    buildCosts(root, costs);
+    for (int row = 0; row < matrixSize; ++row) {
+        root.bound = AssignmentSolver::augment(costs, matrixSize, row, root.assignment, root.rowDual, root.columnDual);
+    }
+    return root;
+}
+
+// Split an assignment into cycles
+std::vector<std::vector<int>> BranchAndBound::findCycles(const std::vector<int>& assignment) {
+    std::vector<std::vector<int>> cycles;
+    std::vector<char> seen(assignment.size(), 0);
+    for (size_t start = 0; start < assignment.size(); ++start) {
+        if (seen[start]) continue;
+        std::vector<int> cycle;
+        for (int city = start; !seen[city]; city = assignment[city]) {
+            seen[city] = 1;
+            cycle.push_back(city);
+        }
+        cycles.push_back(std::move(cycle));
+    }
+    return cycles;
+}
+
+// Branch on the subtour with the fewest free arcs
+std::vector<BranchAndBound::Node> BranchAndBound::branch(const Node& parent, std::vector<long long>& costs) const {
+    std::vector<char> includedRow(matrixSize, 0);
+    for (const auto& arc : parent.included) includedRow[arc.first] = 1;
+
+    std::vector<std::pair<int, int>> freeArcs;
+    bool found = false;
+    for (const std::vector<int>& cycle : findCycles(parent.assignment)) {
+        std::vector<std::pair<int, int>> arcs;
+        for (int city : cycle) {
+            if (!includedRow[city]) arcs.emplace_back(city, parent.assignment[city]);
+        }
+        if (!found || arcs.size() < freeArcs.size()) {
+            freeArcs = std::move(arcs);
+            found = true;
+        }
+    }
+
+    std::vector<Node> children;
+    for (size_t r = 0; r < freeArcs.size(); ++r) {
+        Node child;
+        child.excluded = parent.excluded;
+        child.excluded.push_back(freeArcs[r]);
+        child.included = parent.included;
+        child.included.insert(child.included.end(), freeArcs.begin(), freeArcs.begin() + r);
+        child.assignment = parent.assignment;
+        child.rowDual = parent.rowDual;
+        child.columnDual = parent.columnDual;
+
+        buildCosts(child, costs);
+        child.assignment[freeArcs[r].first] = -1;
+        child.bound = AssignmentSolver::augment(costs, matrixSize, freeArcs[r].first, child.assignment, child.rowDual, child.columnDual);
+        if (child.bound < FORBIDDEN_COST) children.push_back(std::move(child));
+    }
+    return children;
+}
+
+// Best-first search over a memory-bounded node pool, expanded by all workers
+void BranchAndBound::solve() {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    auto elapsed = [startTime]() {
+        return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+    };
+
+    nodeCount = 0;
+    improvementHistory.clear();
+    if (matrixSize <= 1) {
+        bestTour.assign(matrixSize == 1 ? 2 : 0, 0);
+        bestCost = lowerBound = 0;
+        return;
+    }
+
+    if (bestTour.empty()) {
+        GreedyAlgorithm greedySolver(distanceMatrix, threadPool);
+        greedySolver.solve();
+        setIncumbent(greedySolver.getBestTour(), greedySolver.getBestCost());
+    }
+    improvementHistory.emplace_back(0.0, static_cast<int>(bestCost));
+
+    // Turns an assignment that is a single cycle into a closed tour from city 0
+    auto assignmentToTour = [](const std::vector<int>& assignment) {
+        std::vector<int> tour{0};
+        for (int city = assignment[0]; city != 0; city = assignment[city]) tour.push_back(city);
+        tour.push_back(0);
+        return tour;
+    };
+
+    Node root = solveRoot();
+    nodeCount = 1;
+    if (findCycles(root.assignment).size() == 1 && root.bound < bestCost) {
+        bestTour = assignmentToTour(root.assignment);
+        bestCost = root.bound;
+        bestTourTimestamp = elapsed();
+        improvementHistory.emplace_back(bestTourTimestamp, static_cast<int>(bestCost));
+    }
+
+    std::multimap<std::pair<long long, long long>, Node> pool;
+    std::size_t poolMemory = 0;
+    long long nextSequence = 0;
+    long long droppedBound = std::numeric_limits<long long>::max();
+    if (root.bound < bestCost) {
+        poolMemory += root.memoryUsage();
+        pool.emplace(std::make_pair(root.bound, nextSequence++), std::move(root));
+    }
+
+    const int workerCount = threadPool ? threadPool->size() + 1 : 1;
+    std::vector<long long> activeBound(workerCount, std::numeric_limits<long long>::max());
+    int activeWorkers = 0;
+    bool stopped = false;
+    double nextReport = REPORT_INTERVAL;
+    std::mutex stateMutex;
+    std::condition_variable stateChanged;
+
+    // Smallest bound of any subproblem that may still hold a better tour; call with the lock held
+    auto currentLowerBound = [&]() {
+        long long bound = std::min(bestCost, droppedBound);
+        if (!pool.empty()) bound = std::min(bound, pool.begin()->first.first);
+        for (long long active : activeBound) bound = std::min(bound, active);
+        return bound;
+    };
+
+    auto report = [&](double time) {
+        long long bound = currentLowerBound();
+        std::cout << "[" << time << " s] nodes: " << nodeCount << ", open: " << pool.size()
+                  << ", lower bound: " << bound << ", best: " << bestCost
+                  << ", gap: " << (bestCost > 0 ? 100.0 * (bestCost - bound) / bestCost : 0.0) << "%" << std::endl;
+    };
+
+    auto worker = [&](int slot) {
+        std::vector<long long> costs;
+        std::unique_lock<std::mutex> lock(stateMutex);
+        while (!stopped) {
+            double time = elapsed();
+            if (time >= maxTime) {
+                stopped = true;
+                break;
+            }
+            if (time >= nextReport) {
+                nextReport = time + REPORT_INTERVAL;
+                report(time);
+            }
+            if (!pool.empty() && pool.begin()->first.first >= bestCost) {
+                pool.clear(); // Best-first order: every open node is pruned by the incumbent
+                poolMemory = 0;
+            }
+            if (pool.empty()) {
+                if (activeWorkers == 0) {
+                    stopped = true;
+                    break;
+                }
+                stateChanged.wait_for(lock, std::chrono::milliseconds(50));
+                continue;
+            }
+
+            Node node = std::move(pool.begin()->second);
+            pool.erase(pool.begin());
+            poolMemory -= std::min(poolMemory, node.memoryUsage());
+            activeBound[slot] = node.bound;
+            ++activeWorkers;
+            lock.unlock();
+
+            std::vector<Node> children = branch(node, costs);
+            std::vector<char> isTour(children.size(), 0);
+            for (size_t index = 0; index < children.size(); ++index) {
+                isTour[index] = findCycles(children[index].assignment).size() == 1;
+            }
+
+            lock.lock();
+            nodeCount += children.size();
+            activeBound[slot] = std::numeric_limits<long long>::max();
+            --activeWorkers;
+            for (size_t index = 0; index < children.size(); ++index) {
+                Node& child = children[index];
+                if (child.bound >= bestCost) continue;
+                if (isTour[index]) {
+                    bestTour = assignmentToTour(child.assignment);
+                    bestCost = child.bound;
+                    bestTourTimestamp = elapsed();
+                    improvementHistory.emplace_back(bestTourTimestamp, static_cast<int>(bestCost));
+                    continue;
+                }
+                poolMemory += child.memoryUsage();
+                pool.emplace(std::make_pair(child.bound, nextSequence++), std::move(child));
+            }
+            // Keep the pool within its memory cap by dropping the weakest nodes
+            while (poolMemory > memoryCap && pool.size() > 1) {
+                auto weakest = std::prev(pool.end());
+                droppedBound = std::min(droppedBound, weakest->first.first);
+                poolMemory -= std::min(poolMemory, weakest->second.memoryUsage());
+                pool.erase(weakest);
+            }
+            stateChanged.notify_all();
+        }
+        stateChanged.notify_all();
+    };
+
+    if (threadPool) {
+        threadPool->parallelFor(workerCount, worker);
+    } else {
+        worker(0);
+    }
+
+    lowerBound = currentLowerBound();
+    report(elapsed());
+}
+
+// Get the best tour
+std::vector<int> BranchAndBound::getBestTour() const {
+    return bestTour;
+}
+
+// Get the best cost
+int BranchAndBound::getBestCost() const {
+    return static_cast<int>(bestCost);
+}
+
+// Get the proven lower bound
+long long BranchAndBound::getLowerBound() const {
+    return lowerBound;
+}
+
+// Get the relative gap
+double BranchAndBound::getGap() const {
+    return bestCost > 0 ? 100.0 * (bestCost - lowerBound) / bestCost : 0.0;
+}
+
+// Check whether optimality was proven
+bool BranchAndBound::isOptimal() const {
+    return lowerBound >= bestCost;
+}
+
+// Get the number of solved relaxations
+long long BranchAndBound::getNodeCount() const {
+    return nodeCount;
+}
+
+// Get the time when the best tour was found
+double BranchAndBound::getBestTourTimestamp() const {
+    return bestTourTimestamp;
+}
+
+// Get the improvements of the best tour
+std::vector<std::pair<double, int>> BranchAndBound::getImprovementHistory() const {
+    return improvementHistory;
+}
+
+// Get the matrix size
+int BranchAndBound::getMatrixSize() const {
+    return matrixSize;
+}
+
+// Save results to a file
+void BranchAndBound::saveResultToFile(const std::string& fileName) const {
+    std::ofstream outFile(fileName);
+
+    if (!outFile) {
+        throw std::runtime_error("Error: Unable to open file for writing.");
+    }
+
+    outFile << matrixSize << std::endl;
+    for (int city : bestTour) {
+        outFile << city << " ";
+    }
+    outFile << std::endl;
+
+    outFile.close();
+}
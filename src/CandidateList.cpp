@@ -0,0 +1,50 @@
+#include "../headers/CandidateList.h"
+
+#include <algorithm>
+#include <numeric>
+
+// Constructor
+CandidateList::CandidateList(const DistanceMatrix& matrix, int candidatesPerCity)
+    : dimension(matrix.size()),
+      candidateCount(std::max(0, std::min(candidatesPerCity, matrix.size() - 1))) {
+    successorList.resize(static_cast<std::size_t>(dimension) * candidateCount);
+    predecessorList.resize(static_cast<std::size_t>(dimension) * candidateCount);
+    if (candidateCount == 0) return;
+
+    std::vector<int> column(matrix.hasTransposed() ? 0 : dimension);
+    for (int city = 0; city < dimension; ++city) {
+        selectNearest(matrix.row(city), city, successorList.data() + static_cast<std::size_t>(city) * candidateCount);
+
+        const int* incoming;
+        if (matrix.hasTransposed()) {
+            incoming = matrix.column(city);
+        } else {
+            for (int from = 0; from < dimension; ++from) column[from] = matrix(from, city);
+            incoming = column.data();
+        }
+        selectNearest(incoming, city, predecessorList.data() + static_cast<std::size_t>(city) * candidateCount);
+    }
+}
+
+// Partial selection of the k cheapest cities, ties broken by city index
+void CandidateList::selectNearest(const int* weights, int city, int* target) const {
+    std::vector<int> others(dimension - 1);
+    std::iota(others.begin(), others.begin() + city, 0);
+    std::iota(others.begin() + city, others.end(), city + 1);
+
+    auto closer = [weights](int a, int b) {
+        return weights[a] != weights[b] ? weights[a] < weights[b] : a < b;
+    };
+    std::partial_sort(others.begin(), others.begin() + candidateCount, others.end(), closer);
+    std::copy_n(others.begin(), candidateCount, target);
+}
+
+// Get the number of candidates per city
+int CandidateList::size() const {
+    return candidateCount;
+}
+
+// Get the number of cities
+int CandidateList::getDimension() const {
+    return dimension;
+}
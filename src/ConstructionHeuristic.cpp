@@ -0,0 +1,403 @@
+#include "../headers/ConstructionHeuristic.h"
+#include "../headers/GreedyAlgorithm.h"
+#include "../headers/CandidateList.h"
+#include "../headers/TourKernels.h"
+#include "../headers/AssignmentSolver.h"
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+namespace {
+
+// Arc of the greedy edge matching
+struct Arc {
+    int weight;
+    int from;
+    int to;
+
+    bool operator<(const Arc& other) const {
+        if (weight != other.weight) return weight < other.weight;
+        return from != other.from ? from < other.from : to < other.to;
+    }
+};
+
+// Entry of the insertion priority queues, outdated once the city's version has moved on
+struct InsertionEntry {
+    long long key;
+    int city;
+    int version;
+};
+
+// Union-find root with path halving
+int findRoot(std::vector<int>& parent, int city) {
+    while (parent[city] != city) {
+        parent[city] = parent[parent[city]];
+        city = parent[city];
+    }
+    return city;
+}
+
+// Closed tour from city 0 following the successors
+std::vector<int> successorsToTour(const std::vector<int>& successor) {
+    std::vector<int> tour{0};
+    for (int city = successor[0]; city != 0; city = successor[city]) tour.push_back(city);
+    tour.push_back(0);
+    return tour;
+}
+
+}
+
+// Constructor
+ConstructionHeuristic::ConstructionHeuristic(std::shared_ptr<const DistanceMatrix> matrix)
+    : distanceMatrix(std::move(matrix)), matrixSize(distanceMatrix->size()) {}
+
+// Cost of a closed tour
+int ConstructionHeuristic::tourCost(const std::vector<int>& tour) const {
+    return TourKernels::pathCost(*distanceMatrix, tour.data(), tour.size());
+}
+
+// Factory
+std::unique_ptr<ConstructionHeuristic> ConstructionHeuristic::create(ConstructionType type, std::shared_ptr<const DistanceMatrix> matrix,
+                                                                     ThreadPool* pool) {
+    switch (type) {
+        case ConstructionType::NEAREST_NEIGHBOR: return std::make_unique<NearestNeighborConstruction>(std::move(matrix), pool);
+        case ConstructionType::GREEDY_EDGE: return std::make_unique<GreedyEdgeConstruction>(std::move(matrix));
+        case ConstructionType::CHEAPEST_INSERTION: return std::make_unique<InsertionConstruction>(std::move(matrix), false);
+        case ConstructionType::FARTHEST_INSERTION: return std::make_unique<InsertionConstruction>(std::move(matrix), true);
+        case ConstructionType::PATCHING: return std::make_unique<PatchingConstruction>(std::move(matrix));
+    }
+    throw std::invalid_argument("Error: Unknown construction heuristic.");
+}
+
+// Short name to type
+ConstructionType ConstructionHeuristic::parseType(const std::string& name) {
+    if (name == "nn" || name == "nearest") return ConstructionType::NEAREST_NEIGHBOR;
+    if (name == "greedy-edge" || name == "edge") return ConstructionType::GREEDY_EDGE;
+    if (name == "cheapest") return ConstructionType::CHEAPEST_INSERTION;
+    if (name == "farthest") return ConstructionType::FARTHEST_INSERTION;
+    if (name == "patching" || name == "karp") return ConstructionType::PATCHING;
+    throw std::invalid_argument("Error: Unknown construction heuristic '" + name + "'.");
+}
+
+// Type to short name
+std::string ConstructionHeuristic::typeName(ConstructionType type) {
+    switch (type) {
+        case ConstructionType::NEAREST_NEIGHBOR: return "nn";
+        case ConstructionType::GREEDY_EDGE: return "greedy-edge";
+        case ConstructionType::CHEAPEST_INSERTION: return "cheapest";
+        case ConstructionType::FARTHEST_INSERTION: return "farthest";
+        case ConstructionType::PATCHING: return "patching";
+    }
+    return "unknown";
+}
+
+// ---------------------------------------------------------------------------
+// Nearest neighbour
+// ---------------------------------------------------------------------------
+
+// Constructor
+NearestNeighborConstruction::NearestNeighborConstruction(std::shared_ptr<const DistanceMatrix> matrix, ThreadPool* pool, int startCities)
+    : ConstructionHeuristic(std::move(matrix)), threadPool(pool), startCities(startCities) {}
+
+ConstructionType NearestNeighborConstruction::getType() const {
+    return ConstructionType::NEAREST_NEIGHBOR;
+}
+
+std::string NearestNeighborConstruction::getName() const {
+    return "Nearest neighbour";
+}
+
+// Best greedy tour over the start cities
+std::vector<int> NearestNeighborConstruction::build() const {
+    GreedyAlgorithm greedySolver(distanceMatrix, threadPool);
+    greedySolver.setStartCities(startCities);
+    greedySolver.solve();
+    return greedySolver.getBestTour();
+}
+
+// ---------------------------------------------------------------------------
+// Greedy edge
+// ---------------------------------------------------------------------------
+
+// Constructor
+GreedyEdgeConstruction::GreedyEdgeConstruction(std::shared_ptr<const DistanceMatrix> matrix, int candidateCount)
+    : ConstructionHeuristic(std::move(matrix)), candidateCount(std::max(1, candidateCount)) {}
+
+ConstructionType GreedyEdgeConstruction::getType() const {
+    return ConstructionType::GREEDY_EDGE;
+}
+
+std::string GreedyEdgeConstruction::getName() const {
+    return "Greedy edge";
+}
+
+// Match the cheapest arcs that keep the partial tour a set of paths
+std::vector<int> GreedyEdgeConstruction::build() const {
+    const DistanceMatrix& matrix = *distanceMatrix;
+    if (matrixSize == 0) return {};
+    if (matrixSize == 1) return {0, 0};
+
+    std::vector<int> successor(matrixSize, -1);
+    std::vector<int> predecessor(matrixSize, -1);
+    std::vector<int> parent(matrixSize);
+    std::iota(parent.begin(), parent.end(), 0);
+    int accepted = 0;
+
+    // Takes the arcs in order; every accepted arc joins two path fragments
+    auto acceptArcs = [&](std::vector<Arc>& arcs) {
+        std::sort(arcs.begin(), arcs.end());
+        for (const Arc& arc : arcs) {
+            if (accepted == matrixSize - 1) return;
+            if (successor[arc.from] != -1 || predecessor[arc.to] != -1) continue;
+            int fromRoot = findRoot(parent, arc.from);
+            int toRoot = findRoot(parent, arc.to);
+            if (fromRoot == toRoot) continue;
+            parent[fromRoot] = toRoot;
+            successor[arc.from] = arc.to;
+            predecessor[arc.to] = arc.from;
+            ++accepted;
+        }
+    };
+
+    // Phase 1: the arcs to the nearest successors of every city
+    {
+        CandidateList candidates(matrix, candidateCount);
+        std::vector<Arc> arcs;
+        arcs.reserve(static_cast<std::size_t>(matrixSize) * candidates.size());
+        for (int city = 0; city < matrixSize; ++city) {
+            const int* nearest = candidates.successors(city);
+            for (int rank = 0; rank < candidates.size(); ++rank) {
+                arcs.push_back({matrix(city, nearest[rank]), city, nearest[rank]});
+            }
+        }
+        acceptArcs(arcs);
+    }
+
+    // Phase 2: every arc from the end of one fragment to the start of another; a single pass joins them all
+    if (accepted < matrixSize - 1) {
+        std::vector<int> heads;
+        std::vector<int> tails;
+        for (int city = 0; city < matrixSize; ++city) {
+            if (predecessor[city] == -1) heads.push_back(city);
+            if (successor[city] == -1) tails.push_back(city);
+        }
+        std::vector<Arc> arcs;
+        arcs.reserve(tails.size() * (heads.size() - 1));
+        for (int tail : tails) {
+            int tailRoot = findRoot(parent, tail);
+            for (int head : heads) {
+                if (findRoot(parent, head) != tailRoot) arcs.push_back({matrix(tail, head), tail, head});
+            }
+        }
+        acceptArcs(arcs);
+    }
+
+    // Close the remaining path into the tour
+    int last = static_cast<int>(std::find(successor.begin(), successor.end(), -1) - successor.begin());
+    int first = static_cast<int>(std::find(predecessor.begin(), predecessor.end(), -1) - predecessor.begin());
+    successor[last] = first;
+    return successorsToTour(successor);
+}
+
+// ---------------------------------------------------------------------------
+// Cheapest and farthest insertion
+// ---------------------------------------------------------------------------
+
+// Constructor
+InsertionConstruction::InsertionConstruction(std::shared_ptr<const DistanceMatrix> matrix, bool farthest)
+    : ConstructionHeuristic(std::move(matrix)), farthest(farthest) {}
+
+ConstructionType InsertionConstruction::getType() const {
+    return farthest ? ConstructionType::FARTHEST_INSERTION : ConstructionType::CHEAPEST_INSERTION;
+}
+
+std::string InsertionConstruction::getName() const {
+    return farthest ? "Farthest insertion" : "Cheapest insertion";
+}
+
+// Grow a cycle one city at a time
+std::vector<int> InsertionConstruction::build() const {
+    const DistanceMatrix& matrix = *distanceMatrix;
+    if (matrixSize == 0) return {};
+    if (matrixSize == 1) return {0, 0};
+
+    // Start from the cheapest (or, for farthest insertion, the most expensive) 2-cycle
+    int firstCity = 0;
+    int secondCity = 1;
+    long long startCost = static_cast<long long>(matrix(0, 1)) + matrix(1, 0);
+    for (int i = 0; i < matrixSize; ++i) {
+        for (int j = i + 1; j < matrixSize; ++j) {
+            long long cost = static_cast<long long>(matrix(i, j)) + matrix(j, i);
+            if (farthest ? cost > startCost : cost < startCost) {
+                startCost = cost;
+                firstCity = i;
+                secondCity = j;
+            }
+        }
+    }
+
+    std::vector<int> successor(matrixSize, -1);
+    std::vector<char> inTour(matrixSize, 0);
+    successor[firstCity] = secondCity;
+    successor[secondCity] = firstCity;
+    inTour[firstCity] = inTour[secondCity] = 1;
+
+    // Cost of inserting city behind tail, i.e. on the arc tail -> successor[tail]
+    auto insertionCost = [&](int tail, int city) {
+        int head = successor[tail];
+        return static_cast<long long>(matrix(tail, city)) + matrix(city, head) - matrix(tail, head);
+    };
+
+    std::vector<int> bestTail(matrixSize, -1);
+    std::vector<long long> bestCost(matrixSize, std::numeric_limits<long long>::max());
+    std::vector<long long> nearestDistance(matrixSize, std::numeric_limits<long long>::max());
+    std::vector<int> version(matrixSize, 0);
+
+    auto rescan = [&](int city) {
+        bestCost[city] = std::numeric_limits<long long>::max();
+        int tail = firstCity;
+        do {
+            long long cost = insertionCost(tail, city);
+            if (cost < bestCost[city]) {
+                bestCost[city] = cost;
+                bestTail[city] = tail;
+            }
+            tail = successor[tail];
+        } while (tail != firstCity);
+    };
+    auto distanceTo = [&](int tourCity, int city) {
+        return static_cast<long long>(std::min(matrix(tourCity, city), matrix(city, tourCity)));
+    };
+
+    // Min-queue on the insertion cost, or max-queue on the distance to the tour; ties go to the lower city
+    auto later = [this](const InsertionEntry& a, const InsertionEntry& b) {
+        if (a.key != b.key) return farthest ? a.key < b.key : a.key > b.key;
+        return a.city > b.city;
+    };
+    std::priority_queue<InsertionEntry, std::vector<InsertionEntry>, decltype(later)> queue(later);
+    auto keyOf = [&](int city) { return farthest ? nearestDistance[city] : bestCost[city]; };
+
+    for (int city = 0; city < matrixSize; ++city) {
+        if (inTour[city]) continue;
+        rescan(city);
+        nearestDistance[city] = std::min(distanceTo(firstCity, city), distanceTo(secondCity, city));
+        queue.push({keyOf(city), city, 0});
+    }
+
+    for (int inserted = 2; inserted < matrixSize; ++inserted) {
+        InsertionEntry entry = queue.top();
+        queue.pop();
+        while (inTour[entry.city] || entry.version != version[entry.city]) {
+            entry = queue.top();
+            queue.pop();
+        }
+
+        const int city = entry.city;
+        const int tail = bestTail[city];
+        const int head = successor[tail];
+        successor[tail] = city;
+        successor[city] = head;
+        inTour[city] = 1;
+
+        // The arc tail -> head is gone: rescan the cities that wanted it, offer the two new arcs to the rest
+        for (int other = 0; other < matrixSize; ++other) {
+            if (inTour[other]) continue;
+            const long long oldKey = keyOf(other);
+            if (bestTail[other] == tail) {
+                rescan(other);
+            } else {
+                for (int newTail : {tail, city}) {
+                    long long cost = insertionCost(newTail, other);
+                    if (cost < bestCost[other]) {
+                        bestCost[other] = cost;
+                        bestTail[other] = newTail;
+                    }
+                }
+            }
+            nearestDistance[other] = std::min(nearestDistance[other], distanceTo(city, other));
+            if (keyOf(other) != oldKey) {
+                queue.push({keyOf(other), other, ++version[other]});
+            }
+        }
+    }
+
+    return successorsToTour(successor);
+}
+
+// ---------------------------------------------------------------------------
+// Karp patching
+// ---------------------------------------------------------------------------
+
+ConstructionType PatchingConstruction::getType() const {
+    return ConstructionType::PATCHING;
+}
+
+std::string PatchingConstruction::getName() const {
+    return "Karp patching";
+}
+
+// Assignment relaxation of the matrix, a city may not follow itself
+std::vector<int> PatchingConstruction::solveAssignment() const {
+    const DistanceMatrix& matrix = *distanceMatrix;
+    const int n = matrixSize;
+    std::vector<long long> costs(static_cast<std::size_t>(n) * n);
+    for (int from = 0; from < n; ++from) {
+        const int* row = matrix.row(from);
+        long long* costRow = &costs[static_cast<std::size_t>(from) * n];
+        for (int to = 0; to < n; ++to) costRow[to] = row[to];
+        costRow[from] = AssignmentSolver::FORBIDDEN_COST;
+    }
+    return AssignmentSolver::solve(costs, n);
+}
+
+// Patch the assignment cycles into one tour, largest cycles first
+std::vector<int> PatchingConstruction::build() const {
+    const DistanceMatrix& matrix = *distanceMatrix;
+    if (matrixSize == 0) return {};
+    if (matrixSize == 1) return {0, 0};
+
+    std::vector<int> successor = solveAssignment();
+
+    std::vector<std::vector<int>> cycles;
+    std::vector<char> seen(matrixSize, 0);
+    for (int start = 0; start < matrixSize; ++start) {
+        if (seen[start]) continue;
+        cycles.emplace_back();
+        for (int city = start; !seen[city]; city = successor[city]) {
+            seen[city] = 1;
+            cycles.back().push_back(city);
+        }
+    }
+    std::stable_sort(cycles.begin(), cycles.end(), [](const std::vector<int>& a, const std::vector<int>& b) {
+        return a.size() > b.size();
+    });
+
+    // Exchanging the successors of a and b merges their cycles; pick the cheapest such pair
+    std::vector<int> merged = std::move(cycles.front());
+    for (std::size_t index = 1; index < cycles.size(); ++index) {
+        const std::vector<int>& cycle = cycles[index];
+        long long bestDelta = std::numeric_limits<long long>::max();
+        int bestA = -1;
+        int bestB = -1;
+        for (int a : merged) {
+            const int* fromA = matrix.row(a);
+            const long long removedA = fromA[successor[a]];
+            for (int b : cycle) {
+                long long delta = fromA[successor[b]] + static_cast<long long>(matrix(b, successor[a]))
+                                  - removedA - matrix(b, successor[b]);
+                if (delta < bestDelta) {
+                    bestDelta = delta;
+                    bestA = a;
+                    bestB = b;
+                }
+            }
+        }
+        std::swap(successor[bestA], successor[bestB]);
+        merged.insert(merged.end(), cycle.begin(), cycle.end());
+    }
+
+    return successorsToTour(successor);
+}
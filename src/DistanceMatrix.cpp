@@ -0,0 +1,93 @@
+#include "../headers/DistanceMatrix.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+// Constructor for an empty matrix of the given dimension
+DistanceMatrix::DistanceMatrix(int dimension)
+    : dimension(dimension),
+      rowStride(strideFor(dimension)) {
+    if (dimension < 0) {
+        throw std::invalid_argument("Error: Matrix dimension cannot be negative.");
+    }
+    weights = allocate();
+}
+
+// Constructor copying a nested adjacency matrix
+DistanceMatrix::DistanceMatrix(const std::vector<std::vector<int>>& rows)
+    : DistanceMatrix(static_cast<int>(rows.size())) {
+    for (int from = 0; from < dimension; ++from) {
+        if (static_cast<int>(rows[from].size()) != dimension) {
+            throw std::invalid_argument("Error: Adjacency matrix is not square.");
+        }
+        std::memcpy(rowData(from), rows[from].data(), dimension * sizeof(int));
+    }
+}
+
+// Constructor wrapping existing storage
+DistanceMatrix::DistanceMatrix(int dimension, std::shared_ptr<int> storage, std::shared_ptr<int> transposedStorage)
+    : dimension(dimension),
+      rowStride(strideFor(dimension)),
+      weights(std::move(storage)),
+      transposed(std::move(transposedStorage)) {
+    if (dimension < 0) {
+        throw std::invalid_argument("Error: Matrix dimension cannot be negative.");
+    }
+    if (dimension > 0 && !weights) {
+        throw std::invalid_argument("Error: Matrix storage is missing.");
+    }
+}
+
+// Round the dimension up to whole cache lines
+int DistanceMatrix::strideFor(int dimension) {
+    return (dimension + ROW_PADDING - 1) / ROW_PADDING * ROW_PADDING;
+}
+
+// Allocate a zeroed block of dimension x rowStride elements on an ALIGNMENT boundary
+std::shared_ptr<int> DistanceMatrix::allocate() const {
+    std::size_t bytes = static_cast<std::size_t>(dimension) * rowStride * sizeof(int);
+    if (bytes == 0) {
+        return std::shared_ptr<int>();
+    }
+    // rowStride is a multiple of ROW_PADDING, so bytes is already a multiple of ALIGNMENT
+    void* block = std::aligned_alloc(ALIGNMENT, bytes);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    std::memset(block, 0, bytes);
+    return std::shared_ptr<int>(static_cast<int*>(block), [](int* pointer) { std::free(pointer); });
+}
+
+// Build the column-major copy
+void DistanceMatrix::buildTransposed() {
+    transposed = allocate();
+    int* target = transposed.get();
+    for (int from = 0; from < dimension; ++from) {
+        const int* source = row(from);
+        for (int to = 0; to < dimension; ++to) {
+            target[static_cast<std::size_t>(to) * rowStride + from] = source[to];
+        }
+    }
+}
+
+// Check whether the transposed copy exists
+bool DistanceMatrix::hasTransposed() const {
+    return dimension == 0 || transposed != nullptr;
+}
+
+// Get the number of cities
+int DistanceMatrix::size() const {
+    return dimension;
+}
+
+// Get the padded row length
+int DistanceMatrix::stride() const {
+    return rowStride;
+}
+
+// Check whether the matrix is empty
+bool DistanceMatrix::empty() const {
+    return dimension == 0;
+}
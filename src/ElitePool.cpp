@@ -0,0 +1,129 @@
+#include "../headers/ElitePool.h"
+
+#include <algorithm>
+#include <climits>
+#include <utility>
+
+// Constructor
+ElitePool::ElitePool(int capacity, int tourSize)
+    : tourSize(std::max(0, tourSize)), capacity(std::max(1, capacity)), slots(new Slot[std::max(1, capacity)]),
+      bestCost(INT_MAX), acceptedCount(0) {
+    for (int index = 0; index < this->capacity; ++index) {
+        slots[index].cost.store(INT_MAX, std::memory_order_relaxed);
+        slots[index].cities.reset(new std::atomic<int>[this->tourSize]);
+    }
+}
+
+// Optimistic copy of one slot, rejected if a writer touched it meanwhile
+bool ElitePool::readSlot(const Slot& slot, std::vector<int>& tour, int& cost) const {
+    const unsigned before = slot.sequence.load(std::memory_order_acquire);
+    if (before & 1u) return false;
+    const int slotCost = slot.cost.load(std::memory_order_relaxed);
+    if (slotCost == INT_MAX) return false;
+
+    tour.resize(tourSize);
+    for (int position = 0; position < tourSize; ++position) {
+        tour[position] = slot.cities[position].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != before) return false;
+    cost = slotCost;
+    return true;
+}
+
+// Replace the most expensive slot by a cheaper, new tour
+bool ElitePool::publish(const std::vector<int>& tour, int cost) {
+    if (static_cast<int>(tour.size()) != tourSize || tourSize == 0 || cost == INT_MAX) return false;
+
+    const int start = static_cast<int>(std::find(tour.begin(), tour.end(), 0) - tour.begin());
+    if (start == tourSize) return false;
+    std::uint64_t fingerprint = 14695981039346656037ULL;
+    for (int offset = 0; offset < tourSize; ++offset) {
+        fingerprint = (fingerprint ^ static_cast<std::uint64_t>(tour[(start + offset) % tourSize])) * 1099511628211ULL;
+    }
+
+    // A claimed slot may already hold a different tour when another writer got there first, so rescan
+    for (int attempt = 0; attempt <= capacity; ++attempt) {
+        int worst = 0;
+        for (int index = 0; index < capacity; ++index) {
+            const int slotCost = slots[index].cost.load(std::memory_order_relaxed);
+            if (slotCost == cost && slots[index].fingerprint.load(std::memory_order_relaxed) == fingerprint) return false;
+            if (slotCost > slots[worst].cost.load(std::memory_order_relaxed)) worst = index;
+        }
+        Slot& slot = slots[worst];
+        if (cost >= slot.cost.load(std::memory_order_relaxed)) return false;
+
+        unsigned sequence = slot.sequence.load(std::memory_order_relaxed);
+        if ((sequence & 1u) || !slot.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire)) continue;
+        std::atomic_thread_fence(std::memory_order_release);
+        if (cost >= slot.cost.load(std::memory_order_relaxed)) {
+            slot.sequence.store(sequence + 2, std::memory_order_release);
+            continue;
+        }
+
+        slot.cost.store(cost, std::memory_order_relaxed);
+        slot.fingerprint.store(fingerprint, std::memory_order_relaxed);
+        for (int offset = 0; offset < tourSize; ++offset) {
+            slot.cities[offset].store(tour[(start + offset) % tourSize], std::memory_order_relaxed);
+        }
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+
+        int known = bestCost.load(std::memory_order_relaxed);
+        while (cost < known && !bestCost.compare_exchange_weak(known, cost, std::memory_order_relaxed)) {}
+        acceptedCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+// Binary tournament over the filled slots
+bool ElitePool::sample(RandomGenerator& generator, std::vector<int>& tour, int& cost) const {
+    std::vector<int> candidate;
+    int candidateCost = INT_MAX;
+    bool found = false;
+    for (int draw = 0; draw < 2; ++draw) {
+        // Slots being written are skipped, the scan moves on to the next one
+        const int first = generator.below(capacity);
+        for (int offset = 0; offset < capacity; ++offset) {
+            if (readSlot(slots[(first + offset) % capacity], candidate, candidateCost)) {
+                if (!found || candidateCost < cost) {
+                    tour.swap(candidate);
+                    cost = candidateCost;
+                    found = true;
+                }
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+// Cheapest readable slot
+bool ElitePool::best(std::vector<int>& tour, int& cost) const {
+    // Sorted on a snapshot of the costs, writers may change them meanwhile
+    std::vector<std::pair<int, int>> order(capacity);
+    for (int index = 0; index < capacity; ++index) {
+        order[index] = {slots[index].cost.load(std::memory_order_relaxed), index};
+    }
+    std::sort(order.begin(), order.end());
+    for (const std::pair<int, int>& entry : order) {
+        if (entry.first == INT_MAX) break;
+        if (readSlot(slots[entry.second], tour, cost)) return true;
+    }
+    return false;
+}
+
+// Get the lowest published cost
+int ElitePool::getBestCost() const {
+    return bestCost.load(std::memory_order_relaxed);
+}
+
+// Get the number of accepted publications
+long long ElitePool::getAcceptedCount() const {
+    return acceptedCount.load(std::memory_order_relaxed);
+}
+
+// Get the number of slots
+int ElitePool::getCapacity() const {
+    return capacity;
+}
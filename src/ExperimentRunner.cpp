@@ -0,0 +1,601 @@
+#include "../headers/ExperimentRunner.h"
+#include "../headers/MatrixCache.h"
+#include "../headers/GreedyAlgorithm.h"
+#include "../headers/TabuSearch.h"
+#include "../headers/SimulatedAnnealing.h"
+#include "../headers/HeldKarp.h"
+#include "../headers/BranchAndBound.h"
+#include "../headers/PortfolioSolver.h"
+#include "../headers/MemeticAlgorithm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <thread>
+
+namespace {
+
+// Stream buffer discarding everything written to it
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int character) override { return traits_type::not_eof(character); }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// Redirects std::cout into a NullBuffer for its lifetime
+class SilencedOutput {
+private:
+    NullBuffer nullBuffer;
+    std::streambuf* previous;
+
+public:
+    SilencedOutput() : previous(std::cout.rdbuf(&nullBuffer)) {}
+    ~SilencedOutput() { std::cout.rdbuf(previous); }
+};
+
+// Split a comma separated option value, dropping empty items
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// Parse a whole string as a number, throwing std::invalid_argument naming the option otherwise
+double parseNumber(const std::string& text, const std::string& option) {
+    std::size_t consumed = 0;
+    double value = 0.0;
+    try {
+        value = std::stod(text, &consumed);
+    } catch (const std::exception&) {
+        consumed = 0;
+    }
+    if (consumed == 0 || consumed != text.size()) {
+        throw std::invalid_argument("Error: Invalid value '" + text + "' for " + option + ".");
+    }
+    return value;
+}
+
+long long parseLimit(const std::string& text, const std::string& option) {
+    double value = parseNumber(text, option);
+    if (value != std::floor(value) || value < 0 || value > 1e18) {
+        throw std::invalid_argument("Error: " + option + " expects a whole number of at least 0.");
+    }
+    return static_cast<long long>(value);
+}
+
+int parseCount(const std::string& text, const std::string& option, int minimum) {
+    double value = parseNumber(text, option);
+    if (value != static_cast<int>(value) || value < minimum) {
+        throw std::invalid_argument("Error: " + option + " expects a whole number of at least " + std::to_string(minimum) + ".");
+    }
+    return static_cast<int>(value);
+}
+
+ExperimentAlgorithm parseAlgorithm(const std::string& name) {
+    if (name == "greedy") return ExperimentAlgorithm::GREEDY;
+    if (name == "tabu") return ExperimentAlgorithm::TABU_SEARCH;
+    if (name == "sa") return ExperimentAlgorithm::SIMULATED_ANNEALING;
+    if (name == "heldkarp" || name == "hk") return ExperimentAlgorithm::HELD_KARP;
+    if (name == "bnb") return ExperimentAlgorithm::BRANCH_AND_BOUND;
+    if (name == "portfolio") return ExperimentAlgorithm::PORTFOLIO;
+    if (name == "memetic") return ExperimentAlgorithm::MEMETIC;
+    throw std::invalid_argument("Error: Unknown algorithm '" + name + "'.");
+}
+
+// Quote a CSV field if it contains a separator, quote or line break
+std::string csvField(const std::string& value) {
+    if (value.find_first_of(",\"\n") == std::string::npos) return value;
+    std::string quoted = "\"";
+    for (char character : value) {
+        if (character == '"') quoted += '"';
+        quoted += character;
+    }
+    return quoted + "\"";
+}
+
+}
+
+// Constructor
+ExperimentRunner::ExperimentRunner(ExperimentConfig config) : config(std::move(config)) {}
+
+// Parse "--option value" and "--option=value" arguments
+ExperimentConfig ExperimentRunner::parseArguments(int argc, char* argv[]) {
+    ExperimentConfig config;
+    bool timesGiven = false;
+    bool coolingGiven = false;
+    bool seedsGiven = false;
+
+    for (int index = 1; index < argc; ++index) {
+        std::string option = argv[index];
+        std::string value;
+        bool hasValue = false;
+        std::size_t equals = option.find('=');
+        if (option.rfind("--", 0) == 0 && equals != std::string::npos) {
+            value = option.substr(equals + 1);
+            option = option.substr(0, equals);
+            hasValue = true;
+        }
+        auto nextValue = [&]() -> const std::string& {
+            if (!hasValue) {
+                if (index + 1 >= argc) {
+                    throw std::invalid_argument("Error: Missing value for " + option + ".");
+                }
+                value = argv[++index];
+                hasValue = true;
+            }
+            return value;
+        };
+
+        if (option == "--help" || option == "-h") {
+            config.showHelp = true;
+        } else if (option == "--instance" || option == "-i") {
+            for (const std::string& path : splitList(nextValue())) config.instancePaths.push_back(path);
+        } else if (option == "--algo" || option == "-a") {
+            for (const std::string& name : splitList(nextValue())) {
+                ExperimentAlgorithm algorithm = parseAlgorithm(name);
+                if (std::find(config.algorithms.begin(), config.algorithms.end(), algorithm) == config.algorithms.end()) {
+                    config.algorithms.push_back(algorithm);
+                }
+            }
+        } else if (option == "--time" || option == "-t") {
+            if (!timesGiven) config.timeLimits.clear();
+            timesGiven = true;
+            for (const std::string& item : splitList(nextValue())) {
+                double seconds = parseNumber(item, option);
+                if (seconds <= 0 || seconds > 36000) {
+                    throw std::invalid_argument("Error: Time limits must lie in (0, 36000] seconds.");
+                }
+                config.timeLimits.push_back(seconds);
+            }
+        } else if (option == "--iterations") {
+            config.iterationLimit = parseLimit(nextValue(), option);
+        } else if (option == "--stall") {
+            config.stallIterations = parseLimit(nextValue(), option);
+        } else if (option == "--target") {
+            config.targetOptimum = nextValue() == "optimum";
+            if (!config.targetOptimum) config.targetCost = parseLimit(value, option);
+        } else if (option == "--cooling") {
+            if (!coolingGiven) config.coolingFactors.clear();
+            coolingGiven = true;
+            for (const std::string& item : splitList(nextValue())) {
+                double factor = parseNumber(item, option);
+                if (factor <= 0 || factor >= 1) {
+                    throw std::invalid_argument("Error: Cooling factors must lie in (0, 1).");
+                }
+                config.coolingFactors.push_back(factor);
+            }
+        } else if (option == "--seeds" || option == "-s") {
+            if (!seedsGiven) config.seeds.clear();
+            seedsGiven = true;
+            for (const std::string& item : splitList(nextValue())) {
+                std::size_t range = item.find("..");
+                if (range == std::string::npos) {
+                    config.seeds.push_back(static_cast<unsigned>(parseCount(item, option, 0)));
+                    continue;
+                }
+                int first = parseCount(item.substr(0, range), option, 0);
+                int last = parseCount(item.substr(range + 2), option, 0);
+                if (last < first) {
+                    throw std::invalid_argument("Error: Empty seed range '" + item + "'.");
+                }
+                for (int seed = first; seed <= last; ++seed) config.seeds.push_back(static_cast<unsigned>(seed));
+            }
+        } else if (option == "--threads") {
+            config.threadCount = parseCount(nextValue(), option, 0);
+        } else if (option == "--jobs" || option == "-j") {
+            config.concurrentJobs = parseCount(nextValue(), option, 0);
+        } else if (option == "--neighborhoods") {
+            config.neighborhoodTypes.clear();
+            for (char digit : nextValue()) {
+                NeighborhoodType type;
+                switch (digit) {
+                    case '1': type = NeighborhoodType::SWAP; break;
+                    case '2': type = NeighborhoodType::OR_OPT; break;
+                    case '3': type = NeighborhoodType::SEGMENT_EXCHANGE; break;
+                    default: throw std::invalid_argument("Error: Neighbourhoods are given as digits 1-3, e.g. 12.");
+                }
+                if (std::find(config.neighborhoodTypes.begin(), config.neighborhoodTypes.end(), type) == config.neighborhoodTypes.end()) {
+                    config.neighborhoodTypes.push_back(type);
+                }
+            }
+            if (config.neighborhoodTypes.empty()) {
+                throw std::invalid_argument("Error: No neighbourhood selected.");
+            }
+        } else if (option == "--candidates") {
+            config.candidateListSize = parseCount(nextValue(), option, 0);
+        } else if (option == "--local-search") {
+            config.localSearch = true;
+        } else if (option == "--construction") {
+            config.construction = ConstructionHeuristic::parseType(nextValue());
+            config.useConstruction = true;
+        } else if (option == "--chains") {
+            config.annealingChains = parseCount(nextValue(), option, 1);
+        } else if (option == "--replicas") {
+            config.temperingReplicas = parseCount(nextValue(), option, 1);
+        } else if (option == "--schedule") {
+            config.coolingSchedule = AnnealingSchedule::parseSchedule(nextValue());
+        } else if (option == "--epoch") {
+            config.epochFactor = parseCount(nextValue(), option, 1);
+        } else if (option == "--tabu-attribute") {
+            config.tabuAttribute = TabuMemory::parseAttribute(nextValue());
+        } else if (option == "--tabu-tenure") {
+            config.tabuTenure = parseCount(nextValue(), option, 0);
+        } else if (option == "--reactive-tabu") {
+            config.reactiveTabu = true;
+        } else if (option == "--tabu-stagnation") {
+            config.tabuStagnation = parseCount(nextValue(), option, 0);
+        } else if (option == "--population") {
+            config.populationSize = parseCount(nextValue(), option, 2);
+        } else if (option == "--crossover") {
+            config.crossover = MemeticAlgorithm::parseCrossover(nextValue());
+        } else if (option == "--memory") {
+            config.memoryLimitMB = parseCount(nextValue(), option, 1);
+        } else if (option == "--compact-cache") {
+            config.compactCache = true;
+        } else if (option == "--out" || option == "-o") {
+            config.outputPath = nextValue();
+        } else {
+            throw std::invalid_argument("Error: Unknown option '" + option + "'.");
+        }
+    }
+
+    if (config.showHelp) return config;
+    if (config.instancePaths.empty()) {
+        throw std::invalid_argument("Error: No instance given, use --instance.");
+    }
+    if (config.algorithms.empty()) {
+        throw std::invalid_argument("Error: No algorithm given, use --algo.");
+    }
+    if (config.timeLimits.empty() || config.coolingFactors.empty() || config.seeds.empty()) {
+        throw std::invalid_argument("Error: Empty list of time limits, cooling factors or seeds.");
+    }
+    return config;
+}
+
+// Command line help
+std::string ExperimentRunner::usage() {
+    return "Usage: ATSP_2 [options]\n"
+           "Without options the interactive menu is started.\n"
+           "\n"
+           "Batch experiments run every combination of instance, algorithm, time limit,\n"
+           "cooling factor and seed and write one CSV row per run.\n"
+           "List values may be comma separated or given by repeating the option.\n"
+           "\n"
+           "  -i, --instance PATH      TSPLIB file to solve (required)\n"
+           "  -a, --algo LIST          greedy, tabu, sa, heldkarp (hk), bnb, portfolio, memetic (required);\n"
+           "                           the portfolio and memetic run on the solver threads\n"
+           "  -t, --time LIST          time limits in seconds (default 60)\n"
+           "      --iterations N       also stop tabu, sa and portfolio after N iterations (sa: proposals)\n"
+           "      --stall N            also stop them after N iterations without a new best\n"
+           "      --target COST        also stop them at a tour of at most COST; 'optimum' uses the known optimum\n"
+           "      --cooling LIST       cooling factors of the geometric schedule (default 0.85)\n"
+           "  -s, --seeds LIST         seeds or ranges, e.g. 1..30 (default 1)\n"
+           "      --threads N          total worker threads (default: one per hardware thread)\n"
+           "  -j, --jobs N             runs executed at the same time (default: one per thread,\n"
+           "                           one per two threads with portfolio jobs);\n"
+           "                           threads beyond N are split evenly among the running jobs\n"
+           "      --neighborhoods D    move types: 1 = swap, 2 = or-opt, 3 = segment exchange (default 12)\n"
+           "      --candidates K       nearest neighbours per city, 0 disables (default 10)\n"
+           "      --local-search       polish tours with the VND local search\n"
+           "      --construction NAME  start tour of tabu and sa: nn, greedy-edge, cheapest, farthest,\n"
+           "                           patching (default: random for tabu, nn for sa)\n"
+           "      --chains N           parallel Simulated Annealing chains (default 1)\n"
+           "      --replicas N         parallel tempering rungs (default 1 = cooling schedule)\n"
+           "      --schedule NAME      cooling schedule of sa: geometric, lundy-mees, adaptive (default adaptive)\n"
+           "      --epoch N            proposals per city at one temperature (default 10)\n"
+           "      --tabu-attribute A   tabu attribute of Tabu Search: arc, position (default arc)\n"
+           "      --tabu-tenure N      tabu tenure in iterations, 0 = reactive (default 0)\n"
+           "      --reactive-tabu      run Tabu Search in intensification and diversification phases\n"
+           "      --tabu-stagnation N  iterations without improvement ending a phase (default: 2n)\n"
+           "      --population N       population of the memetic algorithm (default 30)\n"
+           "      --crossover NAME     crossover of the memetic algorithm: eax, ox (default eax)\n"
+           "      --memory MB          memory limit of the exact solvers (default 1024)\n"
+           "      --compact-cache      write new matrix caches with 16-bit weights when they fit\n"
+           "                           (half the size, but widened on every load)\n"
+           "  -o, --out PATH           CSV output file (default: standard output)\n"
+           "  -h, --help               show this help\n";
+}
+
+// Best known tours of the TSPLIB ATSP instances
+long long ExperimentRunner::knownOptimum(const std::string& instanceName) {
+    static const std::map<std::string, long long> optima = {
+        {"br17", 39},       {"ft53", 6905},     {"ft70", 38673},    {"ftv33", 1286},
+        {"ftv35", 1473},    {"ftv38", 1530},    {"ftv44", 1613},    {"ftv47", 1776},
+        {"ftv55", 1608},    {"ftv64", 1839},    {"ftv70", 1950},    {"ftv170", 2755},
+        {"kro124p", 36230}, {"p43", 5620},      {"rbg323", 1326},   {"rbg358", 1163},
+        {"rbg403", 2465},   {"rbg443", 2720},   {"ry48p", 14422}
+    };
+    auto entry = optima.find(instanceName);
+    return entry == optima.end() ? -1 : entry->second;
+}
+
+// Command line name of an algorithm
+std::string ExperimentRunner::algorithmName(ExperimentAlgorithm algorithm) {
+    switch (algorithm) {
+        case ExperimentAlgorithm::GREEDY: return "greedy";
+        case ExperimentAlgorithm::TABU_SEARCH: return "tabu";
+        case ExperimentAlgorithm::SIMULATED_ANNEALING: return "sa";
+        case ExperimentAlgorithm::HELD_KARP: return "heldkarp";
+        case ExperimentAlgorithm::BRANCH_AND_BOUND: return "bnb";
+        case ExperimentAlgorithm::PORTFOLIO: return "portfolio";
+        case ExperimentAlgorithm::MEMETIC: return "memetic";
+    }
+    return "unknown";
+}
+
+// Expand the experiment matrix
+std::vector<ExperimentJob> ExperimentRunner::buildJobs() const {
+    std::vector<ExperimentJob> jobs;
+    const unsigned firstSeed = config.seeds.front();
+    for (int instance = 0; instance < static_cast<int>(instances.size()); ++instance) {
+        for (ExperimentAlgorithm algorithm : config.algorithms) {
+            switch (algorithm) {
+                case ExperimentAlgorithm::GREEDY:
+                case ExperimentAlgorithm::HELD_KARP:
+                    jobs.push_back({instance, algorithm, 0.0, 0.0, firstSeed});
+                    break;
+                case ExperimentAlgorithm::BRANCH_AND_BOUND:
+                    for (double timeLimit : config.timeLimits) jobs.push_back({instance, algorithm, timeLimit, 0.0, firstSeed});
+                    break;
+                case ExperimentAlgorithm::TABU_SEARCH:
+                case ExperimentAlgorithm::MEMETIC:
+                    for (double timeLimit : config.timeLimits) {
+                        for (unsigned seed : config.seeds) jobs.push_back({instance, algorithm, timeLimit, 0.0, seed});
+                    }
+                    break;
+                case ExperimentAlgorithm::SIMULATED_ANNEALING:
+                case ExperimentAlgorithm::PORTFOLIO:
+                    for (double timeLimit : config.timeLimits) {
+                        for (double coolingFactor : config.coolingFactors) {
+                            for (unsigned seed : config.seeds) jobs.push_back({instance, algorithm, timeLimit, coolingFactor, seed});
+                        }
+                    }
+                    break;
+            }
+        }
+    }
+    return jobs;
+}
+
+// Run one solver and collect its statistics
+ExperimentResult ExperimentRunner::runJob(const ExperimentJob& job, ThreadPool* solverPool) const {
+    ExperimentResult result;
+    result.job = job;
+    result.instanceName = instances[job.instance].name;
+    result.dimension = instances[job.instance].dimension;
+    result.optimum = knownOptimum(result.instanceName);
+
+    std::shared_ptr<const DistanceMatrix> matrix = instances[job.instance].matrix;
+    const std::shared_ptr<const CandidateList>& candidateList = candidates[job.instance];
+    const std::size_t memoryCap = static_cast<std::size_t>(config.memoryLimitMB) << 20;
+    StopLimits limits;
+    limits.seconds = job.timeLimit;
+    limits.iterations = config.iterationLimit;
+    limits.stallIterations = config.stallIterations;
+    limits.targetCost = config.targetOptimum ? result.optimum : config.targetCost;
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    try {
+        switch (job.algorithm) {
+            case ExperimentAlgorithm::GREEDY: {
+                GreedyAlgorithm solver(matrix, solverPool);
+                solver.solve();
+                if (config.localSearch) solver.improveWithLocalSearch(candidateList.get());
+                result.bestCost = solver.getBestCost();
+                result.iterations = solver.getMatrixSize();
+                break;
+            }
+            case ExperimentAlgorithm::TABU_SEARCH: {
+                TabuSearch solver(matrix, config.tabuTenure, job.timeLimit, solverPool, config.neighborhoodTypes, candidateList);
+                solver.setTabuMemory(config.tabuAttribute, config.tabuTenure);
+                solver.setReactive(config.reactiveTabu, config.tabuStagnation);
+                solver.setStopLimits(limits);
+                solver.setLocalSearch(config.localSearch);
+                solver.setSeed(job.seed);
+                if (config.useConstruction) solver.setConstruction(config.construction);
+                solver.solve();
+                result.bestCost = solver.getOptimalCost();
+                result.timeToBest = solver.getBestTourTimestamp();
+                result.iterations = solver.getIterationCount();
+                result.improvements = solver.getImprovementHistory();
+                result.stopReason = StopCriterion::reasonName(solver.getStopReason());
+                break;
+            }
+            case ExperimentAlgorithm::SIMULATED_ANNEALING: {
+                SimulatedAnnealing solver(matrix, job.coolingFactor, job.timeLimit, config.neighborhoodTypes, candidateList);
+                solver.setStopLimits(limits);
+                solver.setLocalSearch(config.localSearch);
+                solver.setSchedule(config.coolingSchedule, config.epochFactor);
+                if (config.annealingChains > 1) solver.setParallelChains(config.annealingChains, solverPool);
+                if (config.temperingReplicas > 1) solver.setParallelTempering(config.temperingReplicas, solverPool);
+                solver.setSeed(job.seed);
+                if (config.useConstruction) solver.setConstruction(config.construction);
+                solver.solve();
+                result.bestCost = solver.getBestCost();
+                result.timeToBest = solver.getBestSolutionTimestamp();
+                result.iterations = solver.getProposalCount();
+                result.improvements = solver.getImprovementHistory();
+                result.stopReason = StopCriterion::reasonName(solver.getStopReason());
+                break;
+            }
+            case ExperimentAlgorithm::HELD_KARP: {
+                HeldKarp solver(matrix, solverPool, memoryCap);
+                solver.solve();
+                result.bestCost = solver.getBestCost();
+                result.provedOptimal = true;
+                break;
+            }
+            case ExperimentAlgorithm::BRANCH_AND_BOUND: {
+                BranchAndBound solver(matrix, job.timeLimit, solverPool, memoryCap);
+                solver.solve();
+                result.bestCost = solver.getBestCost();
+                result.timeToBest = solver.getBestTourTimestamp();
+                result.iterations = solver.getNodeCount();
+                result.improvements = solver.getImprovementHistory();
+                result.provedOptimal = solver.isOptimal();
+                break;
+            }
+            case ExperimentAlgorithm::PORTFOLIO: {
+                PortfolioSolver solver(matrix, job.timeLimit, job.coolingFactor, solverPool, config.neighborhoodTypes, candidateList);
+                solver.setStopLimits(limits);
+                solver.setLocalSearch(config.localSearch);
+                solver.setSeed(job.seed);
+                solver.solve();
+                result.bestCost = solver.getBestCost();
+                result.timeToBest = solver.getBestTourTimestamp();
+                result.iterations = solver.getIterationCount();
+                result.improvements = solver.getImprovementHistory();
+                result.stopReason = StopCriterion::reasonName(solver.getStopReason());
+                break;
+            }
+            case ExperimentAlgorithm::MEMETIC: {
+                MemeticAlgorithm solver(matrix, job.timeLimit, solverPool, candidateList);
+                solver.setPopulationSize(config.populationSize);
+                solver.setCrossover(config.crossover);
+                solver.setSeed(job.seed);
+                solver.solve();
+                result.bestCost = solver.getBestCost();
+                result.timeToBest = solver.getBestTourTimestamp();
+                result.iterations = solver.getOffspringCount();
+                result.improvements = solver.getImprovementHistory();
+                break;
+            }
+        }
+    } catch (const std::exception& e) {
+        result.bestCost = -1;
+        result.error = e.what();
+    }
+
+    result.wallTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+    // Constructive and dynamic programming solvers only know their tour at the end
+    if (job.algorithm == ExperimentAlgorithm::GREEDY || job.algorithm == ExperimentAlgorithm::HELD_KARP) {
+        result.timeToBest = result.wallTime;
+        if (result.error.empty()) result.improvements.assign(1, {result.wallTime, static_cast<int>(result.bestCost)});
+    }
+    return result;
+}
+
+// Load the instances, then run the jobs on the job pool
+std::vector<ExperimentResult> ExperimentRunner::run() {
+    instances.clear();
+    candidates.clear();
+    for (const std::string& path : config.instancePaths) {
+        instances.push_back(MatrixCache::loadOrParse(path, config.compactCache));
+        const TsplibInstance& instance = instances.back();
+        candidates.push_back(config.candidateListSize > 0 && instance.dimension > 1
+            ? std::make_shared<const CandidateList>(*instance.matrix, config.candidateListSize)
+            : nullptr);
+        std::cerr << "Loaded " << instance.name << " (" << instance.dimension << " cities) from " << path << std::endl;
+    }
+
+    const std::vector<ExperimentJob> jobs = buildJobs();
+    std::vector<ExperimentResult> results(jobs.size());
+    if (jobs.empty()) return results;
+
+    // Job threads run one job each; the remaining threads are split evenly into one solver pool per job slot,
+    // so a job's parallel sections never wait for the helpers of another job
+    int totalThreads = config.threadCount > 0 ? config.threadCount : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const bool portfolio = std::any_of(jobs.begin(), jobs.end(), [](const ExperimentJob& job) {
+        return job.algorithm == ExperimentAlgorithm::PORTFOLIO;
+    });
+    // A portfolio needs a solver thread for its Simulated Annealing worker next to the Tabu Search one
+    int jobThreads = config.concurrentJobs > 0 ? config.concurrentJobs : (portfolio ? std::max(1, totalThreads / 2) : totalThreads);
+    jobThreads = std::max(1, std::min(jobThreads, static_cast<int>(jobs.size())));
+    const int slotThreads = std::max(0, totalThreads - jobThreads) / jobThreads;
+    if (portfolio && slotThreads == 0) {
+        std::cerr << "Warning: portfolio jobs get no solver threads and run a single Tabu Search worker; "
+                     "give --jobs below --threads for a Tabu Search and a Simulated Annealing worker." << std::endl;
+    }
+    std::vector<std::unique_ptr<ThreadPool>> solverPools(jobThreads);
+    std::vector<int> freeSlots(jobThreads);
+    for (int slot = 0; slot < jobThreads; ++slot) {
+        if (slotThreads > 0) solverPools[slot] = std::make_unique<ThreadPool>(slotThreads);
+        freeSlots[slot] = slot;
+    }
+    std::cerr << "Running " << jobs.size() << " jobs, " << jobThreads << " at a time";
+    if (slotThreads > 0) std::cerr << ", " << slotThreads << " solver threads each";
+    std::cerr << std::endl;
+
+    std::mutex progressMutex;
+    std::mutex slotMutex;
+    std::size_t finished = 0;
+    {
+        SilencedOutput silence;
+        ThreadPool jobPool(jobThreads);
+        std::vector<std::future<void>> pending;
+        pending.reserve(jobs.size());
+        for (std::size_t index = 0; index < jobs.size(); ++index) {
+            pending.push_back(jobPool.submit([&, index]() {
+                // At most jobThreads jobs run at once, so a slot is always free
+                int slot;
+                {
+                    std::lock_guard<std::mutex> lock(slotMutex);
+                    slot = freeSlots.back();
+                    freeSlots.pop_back();
+                }
+                results[index] = runJob(jobs[index], solverPools[slot].get());
+                {
+                    std::lock_guard<std::mutex> lock(slotMutex);
+                    freeSlots.push_back(slot);
+                }
+                const ExperimentResult& result = results[index];
+                std::lock_guard<std::mutex> lock(progressMutex);
+                std::cerr << "[" << ++finished << "/" << jobs.size() << "] " << result.instanceName << " "
+                          << algorithmName(result.job.algorithm) << " seed " << result.job.seed << ": ";
+                if (result.error.empty()) {
+                    std::cerr << result.bestCost << " in " << std::fixed << std::setprecision(2) << result.wallTime
+                              << std::defaultfloat << " s" << std::endl;
+                } else {
+                    std::cerr << result.error << std::endl;
+                }
+            }));
+        }
+        for (std::future<void>& job : pending) job.get();
+    }
+    return results;
+}
+
+// One row per result
+void ExperimentRunner::writeCsv(std::ostream& out, const std::vector<ExperimentResult>& results) {
+    out << "instance,dimension,algorithm,time_limit,cooling_factor,seed,best_cost,optimum,gap_percent,"
+           "time_to_best,iterations,wall_time,status,stop_reason\n";
+    for (const ExperimentResult& result : results) {
+        const ExperimentJob& job = result.job;
+        const bool timed = job.algorithm != ExperimentAlgorithm::GREEDY && job.algorithm != ExperimentAlgorithm::HELD_KARP;
+        const bool succeeded = result.error.empty();
+
+        out << csvField(result.instanceName) << "," << result.dimension << "," << algorithmName(job.algorithm) << ",";
+        if (timed) out << job.timeLimit;
+        out << ",";
+        if (job.algorithm == ExperimentAlgorithm::SIMULATED_ANNEALING || job.algorithm == ExperimentAlgorithm::PORTFOLIO) out << job.coolingFactor;
+        out << "," << job.seed << ",";
+        if (succeeded) out << result.bestCost;
+        out << ",";
+        if (result.optimum > 0) out << result.optimum;
+        out << ",";
+        if (succeeded && result.optimum > 0) {
+            out << std::fixed << std::setprecision(3) << 100.0 * (result.bestCost - result.optimum) / result.optimum
+                << std::defaultfloat << std::setprecision(6);
+        }
+        out << "," << std::fixed << std::setprecision(3) << result.timeToBest << "," << result.iterations << ","
+            << result.wallTime << std::defaultfloat << std::setprecision(6) << ",";
+        if (!succeeded) {
+            out << csvField(result.error);
+        } else {
+            out << (result.provedOptimal ? "optimal" : "ok");
+        }
+        out << "," << result.stopReason << "\n";
+    }
+}
@@ -1,70 +1,143 @@
 #include "../headers/GreedyAlgorithm.h"
+#include "../headers/LocalSearch.h"
+#include "../headers/TourKernels.h"
 
 #include <fstream>
-#include <unordered_set>
 #include <numeric>
 #include <limits>
 #include <algorithm>
+#include <stdexcept>
 
 // Constructor
-GreedyAlgorithm::GreedyAlgorithm(const std::vector<std::vector<int>>& matrix) 
-    : distanceMatrix(matrix), 
-      matrixSize(matrix.size()), 
-      bestCost(std::numeric_limits<int>::max()) {}
+GreedyAlgorithm::GreedyAlgorithm(std::shared_ptr<const DistanceMatrix> matrix, ThreadPool* pool) 
+    : distanceMatrix(std::move(matrix)), 
+      matrixSize(distanceMatrix->size()), 
+      bestCost(std::numeric_limits<int>::max()),
+      threadPool(pool),
+      startCityCount(0) {}
+
+// Limit the number of start cities
+void GreedyAlgorithm::setStartCities(int count) {
+    startCityCount = std::max(0, count);
+}
 
 // Build a greedy solution starting from a specific city
-std::vector<int> GreedyAlgorithm::solveFromCity(int startCity) {
+std::vector<int> GreedyAlgorithm::solveFromCity(int startCity) const {
+    const DistanceMatrix& matrix = *distanceMatrix;
     std::vector<int> tour;
-    std::unordered_set<int> visited;
+    tour.reserve(matrixSize + 1);
+
+    // INT_MIN for unvisited cities, INT_MAX for visited ones (see TourKernels::maskedArgmin)
+    std::vector<int> mask(matrixSize, std::numeric_limits<int>::min());
+    const int visited = std::numeric_limits<int>::max();
 
     int currentCity = startCity;
     tour.push_back(currentCity);
-    visited.insert(currentCity);
+    mask[currentCity] = visited;
 
     for (int step = 1; step < matrixSize; ++step) {
-        int nextCity = -1;
-        int minDistance = std::numeric_limits<int>::max();
+        // First unvisited city at the minimum distance, the same choice as a strict-less-than scan
+        int nextCity = TourKernels::maskedArgmin(matrix.row(currentCity), mask.data(), matrixSize);
+
+        currentCity = nextCity;
+        tour.push_back(currentCity);
+        mask[currentCity] = visited;
+    }
+
+    tour.push_back(tour.front()); 
+    return tour;
+}
+
+// Build a tour moving to one of the cheapest unvisited cities at random
+std::vector<int> GreedyAlgorithm::solveRandomizedFromCity(int startCity, RandomGenerator& generator, int choices) const {
+    const DistanceMatrix& matrix = *distanceMatrix;
+    choices = std::max(1, choices);
+    std::vector<int> tour;
+    tour.reserve(matrixSize + 1);
+    std::vector<char> visited(matrixSize, 0);
+    std::vector<int> nearest(choices);
+    std::vector<int> weights(choices);
 
+    int currentCity = startCity;
+    tour.push_back(currentCity);
+    visited[currentCity] = 1;
+
+    for (int step = 1; step < matrixSize; ++step) {
+        // Keep the cheapest unvisited cities sorted by weight, ties by index
+        const int* row = matrix.row(currentCity);
+        int found = 0;
         for (int city = 0; city < matrixSize; ++city) {
-            if (visited.find(city) == visited.end() && distanceMatrix[currentCity][city] < minDistance) {
-                minDistance = distanceMatrix[currentCity][city];
-                nextCity = city;
+            if (visited[city] || (found == choices && row[city] >= weights[found - 1])) continue;
+            int slot = std::min(found, choices - 1);
+            while (slot > 0 && weights[slot - 1] > row[city]) {
+                nearest[slot] = nearest[slot - 1];
+                weights[slot] = weights[slot - 1];
+                --slot;
             }
+            nearest[slot] = city;
+            weights[slot] = row[city];
+            found = std::min(found + 1, choices);
         }
 
-        if (nextCity != -1) {
-            currentCity = nextCity;
-            tour.push_back(currentCity);
-            visited.insert(currentCity);
-        }
+        currentCity = nearest[generator.below(found)];
+        tour.push_back(currentCity);
+        visited[currentCity] = 1;
     }
 
-    tour.push_back(tour.front()); 
+    tour.push_back(tour.front());
     return tour;
 }
 
 // Calculate the cost of a given tour
 int GreedyAlgorithm::calculateTourCost(const std::vector<int>& tour) const {
-    int totalCost = 0;
-    for (size_t i = 0; i < tour.size() - 1; ++i) {
-        totalCost += distanceMatrix[tour[i]][tour[i + 1]];
-    }
-    return totalCost;
+    return TourKernels::pathCost(*distanceMatrix, tour.data(), tour.size());
 }
 
 // Solve the ATSP using the greedy algorithm
 void GreedyAlgorithm::solve() {
-    for (int startCity = 0; startCity < matrixSize; ++startCity) {
-        std::vector<int> tour = solveFromCity(startCity);
-        int totalCost = calculateTourCost(tour);
+    const int startCount = startCityCount > 0 ? std::min(startCityCount, matrixSize) : matrixSize;
+    if (startCount == 0) return;
+
+    // Every block keeps its own best; blocks are merged in order so ties go to the lowest start city
+    const int blockCount = threadPool ? std::min(startCount, 4 * (threadPool->size() + 1)) : 1;
+    std::vector<std::vector<int>> blockTours(blockCount);
+    std::vector<int> blockCosts(blockCount, std::numeric_limits<int>::max());
+
+    auto solveBlock = [&](int block) {
+        const int first = static_cast<int>(static_cast<long long>(block) * startCount / blockCount);
+        const int last = static_cast<int>(static_cast<long long>(block + 1) * startCount / blockCount);
+        for (int index = first; index < last; ++index) {
+            std::vector<int> tour = solveFromCity(static_cast<int>(static_cast<long long>(index) * matrixSize / startCount));
+            int totalCost = calculateTourCost(tour);
+
+            if (totalCost < blockCosts[block]) {
+                blockCosts[block] = totalCost;
+                blockTours[block] = std::move(tour);
+            }
+        }
+    };
+
+    if (blockCount > 1) {
+        threadPool->parallelFor(blockCount, solveBlock);
+    } else {
+        solveBlock(0);
+    }
 
-        if (totalCost < bestCost) {
-            bestCost = totalCost;
-            bestTour = tour;
+    for (int block = 0; block < blockCount; ++block) {
+        if (!blockTours[block].empty() && blockCosts[block] < bestCost) {
+            bestCost = blockCosts[block];
+            bestTour = std::move(blockTours[block]);
         }
     }
 }
 
+// Polish the best tour with variable neighbourhood descent
+void GreedyAlgorithm::improveWithLocalSearch(const CandidateList* candidates) {
+    if (bestTour.empty()) return;
+    LocalSearch localSearch(*distanceMatrix, candidates);
+    bestCost -= localSearch.optimizeClosedTour(bestTour);
+}
+
 // Get the best tour
 std::vector<int> GreedyAlgorithm::getBestTour() const {
     return bestTour;
@@ -0,0 +1,167 @@
+#include "../headers/HeldKarp.h"
+
+#include <fstream>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+// Constructor
+HeldKarp::HeldKarp(std::shared_ptr<const DistanceMatrix> matrix, ThreadPool* pool, std::size_t memoryCapBytes)
+    : distanceMatrix(std::move(matrix)),
+      matrixSize(distanceMatrix->size()),
+      threadPool(pool),
+      memoryCap(memoryCapBytes),
+      bestCost(std::numeric_limits<int>::max()) {}
+
+// Table size: every subset of the n - 1 free cities stores one entry per member
+std::size_t HeldKarp::requiredMemory(int dimension) {
+    if (dimension < 2) return 0;
+    if (dimension > 33) return std::numeric_limits<std::size_t>::max();
+    const int freeCities = dimension - 1;
+    return static_cast<std::size_t>(freeCities) * (std::size_t(1) << (freeCities - 1)) * sizeof(int);
+}
+
+// Total number of set bits of all masks below the given one
+std::size_t HeldKarp::subsetOffset(std::uint32_t mask) {
+    std::size_t offset = 0;
+    for (int bit = 0; (std::uint64_t(1) << bit) <= mask; ++bit) {
+        std::uint64_t period = std::uint64_t(1) << (bit + 1);
+        std::uint64_t half = std::uint64_t(1) << bit;
+        offset += (mask / period) * half;
+        std::uint64_t rest = mask % period;
+        if (rest > half) offset += rest - half;
+    }
+    return offset;
+}
+
+// Fill the table subset layer by subset layer and walk back from the full set
+void HeldKarp::solve() {
+    const DistanceMatrix& matrix = *distanceMatrix;
+    bestTour.clear();
+
+    if (matrixSize <= 1) {
+        bestTour.assign(matrixSize == 1 ? 2 : 0, 0);
+        bestCost = 0;
+        return;
+    }
+    if (matrixSize > 32 || requiredMemory(matrixSize) > memoryCap) {
+        throw std::runtime_error("Error: Held-Karp table for " + std::to_string(matrixSize) + " cities exceeds the memory cap of "
+                                 + std::to_string(memoryCap >> 20) + " MiB.");
+    }
+
+    // Free city i of a mask is the matrix city i + 1
+    const int freeCities = matrixSize - 1;
+    const std::uint32_t fullMask = (freeCities == 32) ? 0xffffffffu : ((std::uint32_t(1) << freeCities) - 1);
+    std::vector<int> cost(requiredMemory(matrixSize) / sizeof(int));
+
+    for (int city = 0; city < freeCities; ++city) {
+        cost[subsetOffset(std::uint32_t(1) << city)] = matrix(0, city + 1);
+    }
+
+    const std::uint64_t maskCount = std::uint64_t(fullMask) + 1;
+    const int blockCount = threadPool ? static_cast<int>(std::min<std::uint64_t>(maskCount, 8ULL * threadPool->size())) : 1;
+
+    for (int layer = 2; layer <= freeCities; ++layer) {
+        auto computeBlock = [&](int block) {
+            std::uint64_t first = maskCount * block / blockCount;
+            std::uint64_t end = maskCount * (block + 1) / blockCount;
+            for (std::uint64_t value = first; value < end; ++value) {
+                std::uint32_t mask = static_cast<std::uint32_t>(value);
+                if (__builtin_popcount(mask) != layer) continue;
+
+                std::size_t offset = subsetOffset(mask);
+                int rank = 0;
+                for (std::uint32_t members = mask; members; members &= members - 1, ++rank) {
+                    int last = __builtin_ctz(members);
+                    std::uint32_t previous = mask ^ (std::uint32_t(1) << last);
+                    const int* previousCost = &cost[subsetOffset(previous)];
+
+                    long long best = std::numeric_limits<long long>::max();
+                    int previousRank = 0;
+                    for (std::uint32_t rest = previous; rest; rest &= rest - 1, ++previousRank) {
+                        int city = __builtin_ctz(rest);
+                        best = std::min(best, static_cast<long long>(previousCost[previousRank]) + matrix(city + 1, last + 1));
+                    }
+                    cost[offset + rank] = static_cast<int>(std::min<long long>(best, std::numeric_limits<int>::max()));
+                }
+            }
+        };
+        if (threadPool && blockCount > 1) {
+            threadPool->parallelFor(blockCount, computeBlock);
+        } else {
+            computeBlock(0);
+        }
+    }
+
+    // Close the tour with the cheapest return to the start city
+    const int* fullCost = &cost[subsetOffset(fullMask)];
+    long long optimum = std::numeric_limits<long long>::max();
+    int lastCity = 0;
+    int rank = 0;
+    for (std::uint32_t members = fullMask; members; members &= members - 1, ++rank) {
+        int city = __builtin_ctz(members);
+        long long total = static_cast<long long>(fullCost[rank]) + matrix(city + 1, 0);
+        if (total < optimum) {
+            optimum = total;
+            lastCity = city;
+        }
+    }
+
+    // Recover the path by finding, for every subset, the predecessor that produced its cost
+    std::vector<int> reversedPath;
+    std::uint32_t mask = fullMask;
+    while (true) {
+        reversedPath.push_back(lastCity + 1);
+        std::uint32_t previous = mask ^ (std::uint32_t(1) << lastCity);
+        if (!previous) break;
+
+        int target = cost[subsetOffset(mask) + __builtin_popcount(mask & ((std::uint32_t(1) << lastCity) - 1))];
+        const int* previousCost = &cost[subsetOffset(previous)];
+        int previousRank = 0;
+        for (std::uint32_t rest = previous; rest; rest &= rest - 1, ++previousRank) {
+            int city = __builtin_ctz(rest);
+            if (static_cast<long long>(previousCost[previousRank]) + matrix(city + 1, lastCity + 1) == target) {
+                lastCity = city;
+                break;
+            }
+        }
+        mask = previous;
+    }
+
+    bestTour.push_back(0);
+    bestTour.insert(bestTour.end(), reversedPath.rbegin(), reversedPath.rend());
+    bestTour.push_back(0);
+    bestCost = static_cast<int>(optimum);
+}
+
+// Get the optimal tour
+std::vector<int> HeldKarp::getBestTour() const {
+    return bestTour;
+}
+
+// Get the optimal cost
+int HeldKarp::getBestCost() const {
+    return bestCost;
+}
+
+// Get the matrix size
+int HeldKarp::getMatrixSize() const {
+    return matrixSize;
+}
+
+// Save results to a file
+void HeldKarp::saveResultToFile(const std::string& fileName) const {
+    std::ofstream outFile(fileName);
+
+    if (!outFile) {
+        throw std::runtime_error("Error: Unable to open file for writing.");
+    }
+
+    outFile << matrixSize << std::endl;
+    for (int city : bestTour) {
+        outFile << city << " ";
+    }
+    outFile << std::endl;
+
+    outFile.close();
+}
@@ -0,0 +1,105 @@
+#include "../headers/LocalSearch.h"
+
+#include <deque>
+
+// Constructor
+LocalSearch::LocalSearch(const DistanceMatrix& matrix, const CandidateList* candidates)
+    : evaluator(matrix),
+      neighborhoods(Neighborhood::createAll({NeighborhoodType::SWAP, NeighborhoodType::OR_OPT, NeighborhoodType::SEGMENT_EXCHANGE},
+                                            candidates)) {}
+
+// Cities at both ends of every removed arc
+void LocalSearch::collectEndpoints(const std::vector<int>& tour, const Move& move, int cities[6]) {
+    const int size = tour.size();
+    if (move.type == MoveType::SWAP) {
+        cities[0] = tour[(move.first - 1 + size) % size];
+        cities[1] = tour[move.first];
+        cities[2] = tour[(move.first + 1) % size];
+        cities[3] = tour[move.second - 1];
+        cities[4] = tour[move.second];
+        cities[5] = tour[(move.second + 1) % size];
+        return;
+    }
+    cities[0] = tour[move.first];
+    cities[1] = tour[move.first + 1];
+    cities[2] = tour[move.second];
+    cities[3] = tour[move.second + 1];
+    cities[4] = tour[move.third];
+    cities[5] = tour[(move.third + 1) % size];
+}
+
+// Variable neighbourhood descent driven by a queue of active cities, closed by sweeps over all rows
+int LocalSearch::optimize(std::vector<int>& tour) const {
+    const int size = tour.size();
+    if (size < 5) return 0;
+
+    std::vector<int> positions;
+    MoveEvaluator::computePositions(tour, positions);
+
+    std::vector<char> active(size, 1);
+    std::deque<int> queue(tour.begin(), tour.end());
+    int improvement = 0;
+
+    // Apply the best improving move of the first neighbourhood with one in the row, activating the touched cities
+    auto improveRow = [&](int row) {
+        for (const auto& neighborhood : neighborhoods) {
+            Move bestMove{};
+            int bestDelta = 0;
+            neighborhood->forEachMove(tour, positions, row, row + 1, [&](const Move& move) {
+                int delta = evaluator.delta(tour, move);
+                if (delta < bestDelta) {
+                    bestDelta = delta;
+                    bestMove = move;
+                }
+            });
+            if (bestDelta >= 0) continue;
+
+            int touched[6];
+            collectEndpoints(tour, bestMove, touched);
+            evaluator.apply(tour, positions, bestMove);
+            improvement -= bestDelta;
+
+            for (int neighbor : touched) {
+                if (!active[neighbor]) {
+                    active[neighbor] = 1;
+                    queue.push_back(neighbor);
+                }
+            }
+            return true;
+        }
+        return false;
+    };
+
+    auto drainQueue = [&]() {
+        while (!queue.empty()) {
+            int city = queue.front();
+            queue.pop_front();
+            active[city] = 0;
+            while (improveRow(positions[city])) {}
+        }
+    };
+
+    // A row only holds the moves anchored at its position, so a move whose anchor city stayed passive is
+    // missed by the queue; the tour is a local optimum once a sweep finds no improving move in any row
+    drainQueue();
+    int row = 0;
+    for (int cleanRows = 0; cleanRows < size;) {
+        if (improveRow(row)) {
+            drainQueue();
+            cleanRows = 0;
+        } else {
+            ++cleanRows;
+            row = (row + 1) % size;
+        }
+    }
+    return improvement;
+}
+
+// Improve a tour whose start city is repeated at the end
+int LocalSearch::optimizeClosedTour(std::vector<int>& tour) const {
+    if (tour.size() < 2) return 0;
+    tour.pop_back();
+    int improvement = optimize(tour);
+    tour.push_back(tour.front());
+    return improvement;
+}
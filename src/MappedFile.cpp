@@ -0,0 +1,67 @@
+#include "../headers/MappedFile.h"
+
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Constructor
+MappedFile::MappedFile(const std::string& path, bool copyOnWrite) : bytes(nullptr), length(0), mapped(false) {
+#ifndef _WIN32
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("Error: Unable to open file " + path);
+    }
+    struct stat status;
+    if (::fstat(descriptor, &status) == 0 && status.st_size > 0) {
+        length = static_cast<std::size_t>(status.st_size);
+        int protection = copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* mapping = ::mmap(nullptr, length, protection, MAP_PRIVATE, descriptor, 0);
+        if (mapping != MAP_FAILED) {
+            if (!copyOnWrite) ::madvise(mapping, length, MADV_SEQUENTIAL);
+            bytes = static_cast<const char*>(mapping);
+            mapped = true;
+        }
+    }
+    ::close(descriptor); // The mapping stays valid without the descriptor
+    if (mapped || length == 0) return;
+#endif
+
+    // Fallback: read the whole file into memory
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error: Unable to open file " + path);
+    }
+    buffer.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(buffer.data(), buffer.size());
+    length = buffer.size();
+    bytes = buffer.empty() ? nullptr : buffer.data();
+}
+
+// Destructor
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (mapped) ::munmap(const_cast<char*>(bytes), length);
+#endif
+}
+
+// Get the file contents
+const char* MappedFile::data() const {
+    return bytes;
+}
+
+// Get the file contents for modification
+char* MappedFile::mutableData() {
+    return const_cast<char*>(bytes);
+}
+
+// Get the file size
+std::size_t MappedFile::size() const {
+    return length;
+}
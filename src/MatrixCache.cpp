@@ -0,0 +1,236 @@
+#include "../headers/MatrixCache.h"
+#include "../headers/MappedFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Copy a string into a fixed, zero-terminated header field
+template <std::size_t N>
+void writeField(char (&field)[N], const std::string& value) {
+    std::memset(field, 0, N);
+    std::memcpy(field, value.data(), std::min(value.size(), N - 1));
+}
+
+template <std::size_t N>
+std::string readField(const char (&field)[N]) {
+    return std::string(field, std::find(field, field + N, '\0'));
+}
+
+}
+
+// FNV-1a over 8-byte words, then the remaining bytes
+std::uint64_t MatrixCache::checksum(const char* data, std::size_t size) {
+    const std::uint64_t prime = 0x100000001b3ULL;
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    std::size_t offset = 0;
+    for (; offset + sizeof(std::uint64_t) <= size; offset += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, data + offset, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; offset < size; ++offset) {
+        hash = (hash ^ static_cast<unsigned char>(data[offset])) * prime;
+    }
+    return hash;
+}
+
+// Modification time of a file
+std::int64_t MatrixCache::modificationTime(const std::string& path) {
+    return static_cast<std::int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+}
+
+// Cache file next to the source
+std::string MatrixCache::cachePath(const std::string& sourcePath) {
+    return sourcePath + ".cache";
+}
+
+// Map the cache and validate it against the source
+bool MatrixCache::load(const std::string& sourcePath, TsplibInstance& instance) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::error_code error;
+    if (!std::filesystem::exists(cachePath(sourcePath), error)) return false;
+
+    std::shared_ptr<MappedFile> file;
+    try {
+        file = std::make_shared<MappedFile>(cachePath(sourcePath), true);
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+    if (file->size() < sizeof(Header)) return false;
+
+    Header header;
+    std::memcpy(&header, file->data(), sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) return false;
+
+    // Stale if the source changed; a new timestamp alone is resolved with the checksum
+    std::uint64_t sourceSize = std::filesystem::file_size(sourcePath, error);
+    if (error || sourceSize != header.sourceSize) return false;
+    if (modificationTime(sourcePath) != header.sourceModified) {
+        MappedFile source(sourcePath);
+        if (checksum(source.data(), source.size()) != header.sourceChecksum) return false;
+    }
+
+    const int dimension = static_cast<int>(header.dimension);
+    const std::size_t cells = static_cast<std::size_t>(dimension) * dimension;
+    const std::size_t paddedCells = static_cast<std::size_t>(dimension) * DistanceMatrix::strideFor(dimension);
+    char* data = file->mutableData() + sizeof(Header);
+
+    if (header.elementType == ElementType::INT32) {
+        std::size_t blocks = header.hasTransposed ? 2 : 1;
+        if (header.rowStride != static_cast<std::uint32_t>(DistanceMatrix::strideFor(dimension))
+            || file->size() != sizeof(Header) + blocks * paddedCells * sizeof(int)) {
+            return false;
+        }
+        std::shared_ptr<int> weights;
+        std::shared_ptr<int> transposed;
+        if (reinterpret_cast<std::uintptr_t>(data) % DistanceMatrix::ALIGNMENT == 0) {
+            // Zero-copy: the matrix shares ownership of the mapping
+            weights = std::shared_ptr<int>(file, reinterpret_cast<int*>(data));
+            if (header.hasTransposed) transposed = std::shared_ptr<int>(file, reinterpret_cast<int*>(data) + paddedCells);
+            instance.matrix = std::make_shared<DistanceMatrix>(dimension, weights, transposed);
+        } else {
+            // The file was read into an unaligned buffer, copy the rows
+            instance.matrix = std::make_shared<DistanceMatrix>(dimension);
+            const int* rows = reinterpret_cast<const int*>(data);
+            for (int from = 0; from < dimension; ++from) {
+                std::memcpy(instance.matrix->rowData(from), rows + static_cast<std::size_t>(from) * header.rowStride, dimension * sizeof(int));
+            }
+        }
+    } else if (header.elementType == ElementType::INT16 || header.elementType == ElementType::UINT16) {
+        if (file->size() != sizeof(Header) + cells * sizeof(std::uint16_t)) return false;
+        bool isSigned = header.elementType == ElementType::INT16;
+        instance.matrix = std::make_shared<DistanceMatrix>(dimension);
+        for (int from = 0; from < dimension; ++from) {
+            int* row = instance.matrix->rowData(from);
+            const char* source = data + static_cast<std::size_t>(from) * dimension * sizeof(std::uint16_t);
+            for (int to = 0; to < dimension; ++to) {
+                std::uint16_t value;
+                std::memcpy(&value, source + to * sizeof(std::uint16_t), sizeof(value));
+                row[to] = isSigned ? static_cast<std::int16_t>(value) : value;
+            }
+            row[from] = header.diagonal;
+        }
+    } else {
+        return false;
+    }
+
+    instance.name = readField(header.name);
+    instance.type = readField(header.type);
+    instance.dimension = dimension;
+    instance.edgeWeightType = readField(header.edgeWeightType);
+    instance.edgeWeightFormat = readField(header.edgeWeightFormat);
+    instance.fromCache = true;
+    instance.parseSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+    return true;
+}
+
+// Write the header and the zero-copy layout, or the narrowest one holding every weight for compact caches
+void MatrixCache::store(const std::string& sourcePath, const TsplibInstance& instance, bool compact) {
+    const DistanceMatrix& matrix = *instance.matrix;
+    const int dimension = matrix.size();
+
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.dimension = static_cast<std::uint32_t>(dimension);
+    header.rowStride = static_cast<std::uint32_t>(matrix.stride());
+    {
+        MappedFile source(sourcePath);
+        header.sourceSize = source.size();
+        header.sourceChecksum = checksum(source.data(), source.size());
+    }
+    header.sourceModified = modificationTime(sourcePath);
+    writeField(header.name, instance.name);
+    writeField(header.type, instance.type);
+    writeField(header.edgeWeightType, instance.edgeWeightType);
+    writeField(header.edgeWeightFormat, instance.edgeWeightFormat);
+
+    header.elementType = ElementType::INT32;
+    header.hasTransposed = matrix.hasTransposed() && dimension > 0;
+    header.diagonal = dimension > 0 ? matrix(0, 0) : 0;
+    if (compact) {
+        // Narrowing needs one common diagonal value and off-diagonal weights within 16 bits
+        bool uniformDiagonal = true;
+        int minimum = std::numeric_limits<int>::max();
+        int maximum = std::numeric_limits<int>::min();
+        for (int from = 0; from < dimension; ++from) {
+            const int* row = matrix.row(from);
+            for (int to = 0; to < dimension; ++to) {
+                if (to == from) continue;
+                minimum = std::min(minimum, row[to]);
+                maximum = std::max(maximum, row[to]);
+            }
+            if (row[from] != matrix(0, 0)) uniformDiagonal = false;
+        }
+        if (uniformDiagonal && minimum >= std::numeric_limits<std::int16_t>::min() && maximum <= std::numeric_limits<std::int16_t>::max()) {
+            header.elementType = ElementType::INT16;
+        } else if (uniformDiagonal && minimum >= 0 && maximum <= std::numeric_limits<std::uint16_t>::max()) {
+            header.elementType = ElementType::UINT16;
+        }
+        if (header.elementType != ElementType::INT32) header.hasTransposed = 0;
+    }
+
+    const std::string path = cachePath(sourcePath);
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Error: Unable to write cache file " + path);
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+        if (header.elementType == ElementType::INT32) {
+            const std::size_t rowBytes = static_cast<std::size_t>(matrix.stride()) * sizeof(int);
+            for (int from = 0; from < dimension; ++from) {
+                file.write(reinterpret_cast<const char*>(matrix.row(from)), rowBytes);
+            }
+            if (header.hasTransposed) {
+                for (int to = 0; to < dimension; ++to) {
+                    file.write(reinterpret_cast<const char*>(matrix.column(to)), rowBytes);
+                }
+            }
+        } else {
+            std::vector<std::uint16_t> narrowed(dimension);
+            for (int from = 0; from < dimension; ++from) {
+                const int* row = matrix.row(from);
+                for (int to = 0; to < dimension; ++to) {
+                    narrowed[to] = static_cast<std::uint16_t>(to == from ? 0 : row[to]);
+                }
+                file.write(reinterpret_cast<const char*>(narrowed.data()), narrowed.size() * sizeof(std::uint16_t));
+            }
+        }
+        if (!file) {
+            throw std::runtime_error("Error: Unable to write cache file " + path);
+        }
+    }
+    std::filesystem::rename(temporaryPath, path);
+}
+
+// Use the cache when it is up to date, otherwise parse the source and refresh the cache
+TsplibInstance MatrixCache::loadOrParse(const std::string& sourcePath, bool compact) {
+    TsplibInstance instance;
+    if (load(sourcePath, instance)) {
+        if (!instance.matrix->hasTransposed()) instance.matrix->buildTransposed();
+        return instance;
+    }
+
+    instance = TsplibLoader::load(sourcePath);
+    instance.matrix->buildTransposed();
+    try {
+        store(sourcePath, instance, compact);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+    return instance;
+}
@@ -0,0 +1,425 @@
+#include "../headers/MemeticAlgorithm.h"
+#include "../headers/GreedyAlgorithm.h"
+#include "../headers/TourKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+// Constructor
+MemeticAlgorithm::MemeticAlgorithm(std::shared_ptr<const DistanceMatrix> matrix, double maxTimeInSeconds, ThreadPool* pool,
+                                   std::shared_ptr<const CandidateList> candidates)
+    : distanceMatrix(std::move(matrix)), matrixSize(distanceMatrix->size()), maxDuration(maxTimeInSeconds), threadPool(pool),
+      candidateList(std::move(candidates)), localSearch(*distanceMatrix, candidateList.get()), crossover(CrossoverType::EDGE_ASSEMBLY),
+      populationSize(DEFAULT_POPULATION_SIZE), seed(RandomGenerator::randomSeed()), bestCost(std::numeric_limits<int>::max()),
+      bestTimestamp(0.0), offspringCount(0), acceptedCount(0) {}
+
+// Hash of the set of arcs, the same for every rotation of the tour
+std::uint64_t MemeticAlgorithm::fingerprint(const std::vector<int>& tour) const {
+    std::uint64_t hash = 0;
+    for (int position = 0; position < matrixSize; ++position) {
+        std::uint64_t arc = static_cast<std::uint64_t>(tour[position]) * matrixSize + tour[(position + 1) % matrixSize];
+        arc += 0x9E3779B97F4A7C15ULL;
+        arc = (arc ^ (arc >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        arc = (arc ^ (arc >> 27)) * 0x94D049BB133111EBULL;
+        hash += arc ^ (arc >> 31);
+    }
+    return hash;
+}
+
+// Copy a tour into a population slot
+void MemeticAlgorithm::storeMember(int member, const std::vector<int>& tour, int cost) {
+    const std::size_t offset = static_cast<std::size_t>(member) * matrixSize;
+    std::copy(tour.begin(), tour.end(), tours.begin() + offset);
+    for (int position = 0; position < matrixSize; ++position) {
+        successors[offset + tour[position]] = tour[(position + 1) % matrixSize];
+    }
+    costs[member] = cost;
+    fingerprints[member] = fingerprint(tour);
+}
+
+// Greedy tours of spread start cities and randomized greedy tours, all locally optimised
+void MemeticAlgorithm::initializePopulation() {
+    const std::size_t cells = static_cast<std::size_t>(populationSize) * matrixSize;
+    tours.assign(cells, 0);
+    successors.assign(cells, 0);
+    costs.assign(populationSize, std::numeric_limits<int>::max());
+    fingerprints.assign(populationSize, 0);
+
+    const GreedyAlgorithm greedySolver(distanceMatrix);
+    const RandomGenerator root(seed);
+    const int greedyMembers = std::min(matrixSize, (populationSize + 1) / 2);
+    std::vector<std::vector<int>> initial(populationSize);
+    std::vector<RandomGenerator> generators(populationSize);
+
+    auto build = [&](int member) {
+        generators[member] = root.stream(member);
+        std::vector<int> tour = member < greedyMembers
+            ? greedySolver.solveFromCity(static_cast<int>(static_cast<long long>(member) * matrixSize / greedyMembers))
+            : greedySolver.solveRandomizedFromCity(generators[member].below(matrixSize), generators[member]);
+        tour.pop_back();
+        localSearch.optimize(tour);
+        initial[member] = std::move(tour);
+    };
+    if (threadPool) {
+        threadPool->parallelFor(populationSize, build);
+    } else {
+        for (int member = 0; member < populationSize; ++member) build(member);
+    }
+
+    // Duplicates would only waste crossovers, they are replaced by further randomized tours
+    for (int member = 0; member < populationSize; ++member) {
+        std::vector<int>& tour = initial[member];
+        for (int attempt = 0; attempt < 10; ++attempt) {
+            const std::uint64_t hash = fingerprint(tour);
+            if (std::find(fingerprints.begin(), fingerprints.begin() + member, hash) == fingerprints.begin() + member) break;
+            tour = greedySolver.solveRandomizedFromCity(generators[member].below(matrixSize), generators[member]);
+            tour.pop_back();
+            localSearch.optimize(tour);
+        }
+        storeMember(member, tour, TourKernels::cycleCost(*distanceMatrix, tour.data(), tour.size()));
+    }
+}
+
+// Pick two parents, recombine them and polish the offspring
+void MemeticAlgorithm::breed(OffspringWorkspace& workspace) const {
+    RandomGenerator& generator = workspace.generator;
+    const int first = generator.below(populationSize);
+    int second = generator.below(populationSize - 1);
+    if (second >= first) ++second;
+
+    if (crossover == CrossoverType::ORDER || !edgeAssemblyCrossover(first, second, workspace)) {
+        orderCrossover(first, second, workspace);
+    }
+    localSearch.optimize(workspace.tour);
+    workspace.cost = TourKernels::cycleCost(*distanceMatrix, workspace.tour.data(), workspace.tour.size());
+    workspace.parent = first;
+}
+
+// Directed EAX: exchange the arcs of an AB-cycle, then join the subtours
+bool MemeticAlgorithm::edgeAssemblyCrossover(int first, int second, OffspringWorkspace& workspace) const {
+    const DistanceMatrix& matrix = *distanceMatrix;
+    const int n = matrixSize;
+    const int* successorsA = successors.data() + static_cast<std::size_t>(first) * n;
+    const int* successorsB = successors.data() + static_cast<std::size_t>(second) * n;
+
+    std::vector<int> predecessorsB(n);
+    for (int city = 0; city < n; ++city) predecessorsB[successorsB[city]] = city;
+
+    // AB-cycles are the cycles of u -> predB(succA(u)); shared arcs are its fixed points
+    workspace.cycleOf.assign(n, -1);
+    workspace.cycleStarts.clear();
+    for (int city = 0; city < n; ++city) {
+        if (workspace.cycleOf[city] != -1 || successorsA[city] == successorsB[city]) continue;
+        const int label = workspace.cycleStarts.size();
+        for (int current = city; workspace.cycleOf[current] == -1; current = predecessorsB[successorsA[current]]) {
+            workspace.cycleOf[current] = label;
+        }
+        workspace.cycleStarts.push_back(city);
+    }
+    if (workspace.cycleStarts.empty()) return false;
+
+    const int cycleCount = workspace.cycleStarts.size();
+    const int trials = std::min(EAX_TRIALS, cycleCount);
+    int bestDelta = std::numeric_limits<int>::max();
+    for (int trial = 0; trial < trials; ++trial) {
+        std::swap(workspace.cycleStarts[trial], workspace.cycleStarts[trial + workspace.generator.below(cycleCount - trial)]);
+        const int start = workspace.cycleStarts[trial];
+
+        // Every A-arc (u, succA(u)) of the cycle is replaced by the B-arc (predB(succA(u)), succA(u))
+        workspace.successors.assign(successorsA, successorsA + n);
+        int delta = 0;
+        int current = start;
+        do {
+            const int head = successorsA[current];
+            const int next = predecessorsB[head];
+            delta += matrix(next, head) - matrix(current, head);
+            workspace.successors[next] = head;
+            current = next;
+        } while (current != start);
+
+        workspace.predecessors.resize(n);
+        for (int city = 0; city < n; ++city) workspace.predecessors[workspace.successors[city]] = city;
+        delta += mergeSubtours(workspace);
+
+        if (delta < bestDelta) {
+            bestDelta = delta;
+            workspace.bestSuccessors.swap(workspace.successors);
+        }
+    }
+
+    workspace.tour.resize(n);
+    workspace.tour[0] = 0;
+    for (int position = 1; position < n; ++position) {
+        workspace.tour[position] = workspace.bestSuccessors[workspace.tour[position - 1]];
+    }
+    return true;
+}
+
+// Merge the smallest subtour into another one until a single tour is left
+int MemeticAlgorithm::mergeSubtours(OffspringWorkspace& workspace) const {
+    const DistanceMatrix& matrix = *distanceMatrix;
+    const int n = matrixSize;
+    std::vector<int>& next = workspace.successors;
+    std::vector<int>& previous = workspace.predecessors;
+
+    workspace.subtourOf.assign(n, -1);
+    workspace.subtourSizes.clear();
+    workspace.subtourStarts.clear();
+    for (int city = 0; city < n; ++city) {
+        if (workspace.subtourOf[city] != -1) continue;
+        const int label = workspace.subtourSizes.size();
+        int size = 0;
+        for (int current = city; workspace.subtourOf[current] == -1; current = next[current]) {
+            workspace.subtourOf[current] = label;
+            ++size;
+        }
+        workspace.subtourSizes.push_back(size);
+        workspace.subtourStarts.push_back(city);
+    }
+
+    int delta = 0;
+    for (int remaining = workspace.subtourSizes.size(); remaining > 1; --remaining) {
+        int smallest = -1;
+        for (int label = 0; label < static_cast<int>(workspace.subtourSizes.size()); ++label) {
+            const int size = workspace.subtourSizes[label];
+            if (size > 0 && (smallest == -1 || size < workspace.subtourSizes[smallest])) smallest = label;
+        }
+        const int start = workspace.subtourStarts[smallest];
+
+        // Replace (a, succ(a)) and (c, succ(c)) by (a, succ(c)) and (c, succ(a)), c in another subtour
+        int bestGain = std::numeric_limits<int>::max();
+        int bestFrom = -1;
+        int bestOther = -1;
+        if (candidateList) {
+            const int k = candidateList->size();
+            int from = start;
+            do {
+                const int* nearest = candidateList->successors(from);
+                for (int rank = 0; rank < k; ++rank) {
+                    const int head = nearest[rank];
+                    if (workspace.subtourOf[head] == smallest) continue;
+                    const int other = previous[head];
+                    const int gain = matrix(from, head) + matrix(other, next[from]) - matrix(from, next[from]) - matrix(other, head);
+                    if (gain < bestGain) {
+                        bestGain = gain;
+                        bestFrom = from;
+                        bestOther = other;
+                    }
+                }
+                from = next[from];
+            } while (from != start);
+        }
+        if (bestFrom == -1) {
+            int from = start;
+            do {
+                for (int other = 0; other < n; ++other) {
+                    if (workspace.subtourOf[other] == smallest) continue;
+                    const int gain = matrix(from, next[other]) + matrix(other, next[from]) - matrix(from, next[from]) - matrix(other, next[other]);
+                    if (gain < bestGain) {
+                        bestGain = gain;
+                        bestFrom = from;
+                        bestOther = other;
+                    }
+                }
+                from = next[from];
+            } while (from != start);
+        }
+
+        const int target = workspace.subtourOf[bestOther];
+        int city = start;
+        do {
+            workspace.subtourOf[city] = target;
+            city = next[city];
+        } while (city != start);
+        workspace.subtourSizes[target] += workspace.subtourSizes[smallest];
+        workspace.subtourSizes[smallest] = 0;
+
+        const int headFrom = next[bestFrom];
+        const int headOther = next[bestOther];
+        next[bestFrom] = headOther;
+        previous[headOther] = bestFrom;
+        next[bestOther] = headFrom;
+        previous[headFrom] = bestOther;
+        delta += bestGain;
+    }
+    return delta;
+}
+
+// OX: a segment of A in place, the remaining cities in the order of B
+void MemeticAlgorithm::orderCrossover(int first, int second, OffspringWorkspace& workspace) const {
+    const int n = matrixSize;
+    const int* parentA = tours.data() + static_cast<std::size_t>(first) * n;
+    const int* parentB = tours.data() + static_cast<std::size_t>(second) * n;
+    int left = workspace.generator.below(n);
+    int right = workspace.generator.below(n);
+    if (left > right) std::swap(left, right);
+
+    workspace.tour.resize(n);
+    workspace.used.assign(n, 0);
+    for (int position = left; position <= right; ++position) {
+        workspace.tour[position] = parentA[position];
+        workspace.used[parentA[position]] = 1;
+    }
+    int position = (right + 1) % n;
+    for (int offset = 1; offset <= n; ++offset) {
+        const int city = parentB[(right + offset) % n];
+        if (workspace.used[city]) continue;
+        workspace.tour[position] = city;
+        position = (position + 1) % n;
+    }
+}
+
+// Keep the offspring if it is new and beats its parent or the worst member
+void MemeticAlgorithm::insertOffspring(const OffspringWorkspace& workspace, double elapsed) {
+    const std::uint64_t hash = fingerprint(workspace.tour);
+    for (int member = 0; member < populationSize; ++member) {
+        if (fingerprints[member] == hash && costs[member] == workspace.cost) return;
+    }
+
+    int target = workspace.parent;
+    if (workspace.cost >= costs[target]) {
+        target = static_cast<int>(std::max_element(costs.begin(), costs.end()) - costs.begin());
+        if (workspace.cost >= costs[target]) return;
+    }
+    storeMember(target, workspace.tour, workspace.cost);
+    ++acceptedCount;
+
+    if (workspace.cost < bestCost) {
+        bestCost = workspace.cost;
+        bestTour = workspace.tour;
+        bestTimestamp = elapsed;
+        improvementHistory.emplace_back(elapsed, bestCost);
+    }
+}
+
+// Run generations of parallel offspring batches until the time limit
+void MemeticAlgorithm::solve() {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    auto elapsedSince = [startTime]() {
+        return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+    };
+    bestCost = std::numeric_limits<int>::max();
+    bestTour.clear();
+    bestTimestamp = 0.0;
+    improvementHistory.clear();
+    offspringCount = 0;
+    acceptedCount = 0;
+    if (matrixSize == 0) return;
+
+    // Too few cities to recombine, every tour is a rotation of the identity or its reverse
+    if (matrixSize < 4) {
+        bestTour.resize(matrixSize);
+        std::iota(bestTour.begin(), bestTour.end(), 0);
+        bestCost = TourKernels::cycleCost(*distanceMatrix, bestTour.data(), bestTour.size());
+        std::vector<int> reversed(bestTour.rbegin(), bestTour.rend());
+        const int reversedCost = TourKernels::cycleCost(*distanceMatrix, reversed.data(), reversed.size());
+        if (reversedCost < bestCost) {
+            bestTour.swap(reversed);
+            bestCost = reversedCost;
+        }
+        improvementHistory.emplace_back(elapsedSince(), bestCost);
+        return;
+    }
+
+    initializePopulation();
+    const int bestMember = static_cast<int>(std::min_element(costs.begin(), costs.end()) - costs.begin());
+    bestCost = costs[bestMember];
+    bestTour.assign(tours.begin() + static_cast<std::size_t>(bestMember) * matrixSize,
+                    tours.begin() + static_cast<std::size_t>(bestMember + 1) * matrixSize);
+    bestTimestamp = elapsedSince();
+    improvementHistory.emplace_back(bestTimestamp, bestCost);
+
+    const int batchSize = threadPool ? threadPool->size() + 1 : 1;
+    const RandomGenerator root(seed);
+    std::vector<OffspringWorkspace> workspaces(batchSize);
+    for (int slot = 0; slot < batchSize; ++slot) workspaces[slot].generator = root.stream(populationSize + slot);
+
+    while (elapsedSince() < maxDuration) {
+        if (batchSize > 1) {
+            threadPool->parallelFor(batchSize, [this, &workspaces](int slot) { breed(workspaces[slot]); });
+        } else {
+            breed(workspaces[0]);
+        }
+        const double elapsed = elapsedSince();
+        for (const OffspringWorkspace& workspace : workspaces) insertOffspring(workspace, elapsed);
+        offspringCount += batchSize;
+    }
+}
+
+// Set the population size
+void MemeticAlgorithm::setPopulationSize(int size) {
+    populationSize = std::max(2, size);
+}
+
+// Select the crossover
+void MemeticAlgorithm::setCrossover(CrossoverType type) {
+    crossover = type;
+}
+
+// Set the seed of the run
+void MemeticAlgorithm::setSeed(std::uint64_t value) {
+    seed = value;
+}
+
+// Get the best tour, closed
+std::vector<int> MemeticAlgorithm::getBestTour() const {
+    std::vector<int> tour = bestTour;
+    if (!tour.empty()) tour.push_back(tour.front());
+    return tour;
+}
+
+// Get the best cost
+int MemeticAlgorithm::getBestCost() const {
+    return bestCost;
+}
+
+// Get the time when the best tour was found
+double MemeticAlgorithm::getBestTourTimestamp() const {
+    return bestTimestamp;
+}
+
+// Get the improvements of the best tour
+std::vector<std::pair<double, int>> MemeticAlgorithm::getImprovementHistory() const {
+    return improvementHistory;
+}
+
+// Get the number of offspring
+long long MemeticAlgorithm::getOffspringCount() const {
+    return offspringCount;
+}
+
+// Get the number of accepted offspring
+long long MemeticAlgorithm::getAcceptedCount() const {
+    return acceptedCount;
+}
+
+// Save the results to a file
+void MemeticAlgorithm::saveResultsToFile(const std::string& fileName) const {
+    std::ofstream outFile(fileName);
+    if (!outFile) {
+        throw std::runtime_error("Error: Unable to open file for writing.");
+    }
+
+    const std::vector<int> tour = getBestTour();
+    outFile << matrixSize << std::endl;
+    for (int city : tour) {
+        outFile << city << " ";
+    }
+    outFile << std::endl;
+}
+
+// Parse a crossover name
+CrossoverType MemeticAlgorithm::parseCrossover(const std::string& name) {
+    if (name == "eax") return CrossoverType::EDGE_ASSEMBLY;
+    if (name == "ox") return CrossoverType::ORDER;
+    throw std::invalid_argument("Error: Unknown crossover '" + name + "'.");
+}
+
+// Short name of a crossover
+std::string MemeticAlgorithm::crossoverName(CrossoverType type) {
+    return type == CrossoverType::EDGE_ASSEMBLY ? "eax" : "ox";
+}
@@ -0,0 +1,120 @@
+#include "../headers/MoveEvaluator.h"
+#include "../headers/TourKernels.h"
+
+#include <algorithm>
+
+// Constructor
+MoveEvaluator::MoveEvaluator(const DistanceMatrix& matrix) : matrix(matrix) {}
+
+// Create a swap move with ordered positions
+Move MoveEvaluator::swap(int i, int j) {
+    return Move{MoveType::SWAP, std::min(i, j), std::max(i, j), 0};
+}
+
+// Create an insertion move as an exchange of the moved city with the segment it jumps over
+Move MoveEvaluator::insertion(int from, int to) {
+    if (from < to) {
+        return segmentExchange(from - 1, from, to);
+    }
+    return segmentExchange(to - 1, from - 1, from);
+}
+
+// Create an or-opt move as an exchange of the segment with the cities between it and the target
+Move MoveEvaluator::orOpt(int start, int length, int target) {
+    int end = start + length - 1;
+    if (target > end) {
+        return segmentExchange(start - 1, end, target);
+    }
+    return segmentExchange(target, start - 1, end);
+}
+
+// Create a segment exchange move
+Move MoveEvaluator::segmentExchange(int i, int j, int k) {
+    return Move{MoveType::SEGMENT_EXCHANGE, i, j, k};
+}
+
+// Compute the cost change of a move from the arcs it removes and adds
+int MoveEvaluator::delta(const std::vector<int>& tour, const Move& move) const {
+    const int size = tour.size();
+
+    if (move.type == MoveType::SEGMENT_EXCHANGE) {
+        int a = tour[move.first],  b = tour[move.first + 1];
+        int c = tour[move.second], d = tour[move.second + 1];
+        int e = tour[move.third],  f = tour[(move.third + 1) % size];
+        return matrix(a, d) + matrix(e, b) + matrix(c, f)
+             - matrix(a, b) - matrix(c, d) - matrix(e, f);
+    }
+
+    int i = move.first, j = move.second;
+    if (size <= 2) {
+        return 0;
+    }
+
+    int x = tour[i], y = tour[j];
+    if (j == i + 1) {
+        // ... p x y n ... -> ... p y x n ...
+        int p = tour[(i - 1 + size) % size], n = tour[(j + 1) % size];
+        return matrix(p, y) + matrix(y, x) + matrix(x, n)
+             - matrix(p, x) - matrix(x, y) - matrix(y, n);
+    }
+    if (i == 0 && j == size - 1) {
+        // Adjacent through the closing edge: ... p y | x n ... -> ... p x | y n ...
+        int p = tour[size - 2], n = tour[1];
+        return matrix(p, x) + matrix(x, y) + matrix(y, n)
+             - matrix(p, y) - matrix(y, x) - matrix(x, n);
+    }
+
+    int prevI = tour[(i - 1 + size) % size], nextI = tour[i + 1];
+    int prevJ = tour[j - 1], nextJ = tour[(j + 1) % size];
+    return matrix(prevI, y) + matrix(y, nextI) + matrix(prevJ, x) + matrix(x, nextJ)
+         - matrix(prevI, x) - matrix(x, nextI) - matrix(prevJ, y) - matrix(y, nextJ);
+}
+
+// Cost changes of a whole row of swaps: the adjacent ones directly, the others with the vector kernel
+void MoveEvaluator::swapRowDeltas(const std::vector<int>& tour, const std::vector<int>& arcWeights, int i, int* deltas) const {
+    const int size = tour.size();
+    if (i + 1 >= size) return;
+    deltas[0] = delta(tour, swap(i, i + 1));
+    if (i + 2 >= size) return;
+    TourKernels::swapDeltas(matrix, tour.data(), arcWeights.data(), size, i, i + 2, size - 1, deltas + 1);
+    deltas[size - i - 2] = delta(tour, swap(i, size - 1));
+}
+
+// Weights of the arcs leaving every position
+void MoveEvaluator::computeArcWeights(const std::vector<int>& tour, std::vector<int>& arcWeights) const {
+    const int size = tour.size();
+    arcWeights.resize(size);
+    for (int position = 0; position < size; ++position) {
+        arcWeights[position] = matrix(tour[position], tour[(position + 1) % size]);
+    }
+}
+
+// Apply a move in place
+void MoveEvaluator::apply(std::vector<int>& tour, const Move& move) const {
+    if (move.type == MoveType::SWAP) {
+        std::swap(tour[move.first], tour[move.second]);
+        return;
+    }
+    std::rotate(tour.begin() + move.first + 1, tour.begin() + move.second + 1, tour.begin() + move.third + 1);
+}
+
+// Apply a move and refresh the positions of the cities between its ends
+void MoveEvaluator::apply(std::vector<int>& tour, std::vector<int>& positions, const Move& move) const {
+    apply(tour, move);
+    if (move.type == MoveType::SWAP) {
+        positions[tour[move.first]] = move.first;
+        positions[tour[move.second]] = move.second;
+        return;
+    }
+    for (int position = move.first + 1; position <= move.third; ++position) {
+        positions[tour[position]] = position;
+    }
+}
+
+// Build the position index of a tour
+void MoveEvaluator::computePositions(const std::vector<int>& tour, std::vector<int>& positions) {
+    positions.resize(tour.size());
+    for (int position = 0; position < static_cast<int>(tour.size()); ++position) {
+        positions[tour[position]] = position;
+    }
+}
@@ -0,0 +1,263 @@
+#include "../headers/Neighborhood.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Constructor
+Neighborhood::Neighborhood(const CandidateList* candidates)
+    : candidates(candidates && candidates->size() > 0 ? candidates : nullptr) {}
+
+// Create a neighbourhood of the given type
+std::unique_ptr<Neighborhood> Neighborhood::create(NeighborhoodType type, const CandidateList* candidates) {
+    switch (type) {
+        case NeighborhoodType::SWAP: return std::make_unique<SwapNeighborhood>(candidates);
+        case NeighborhoodType::OR_OPT: return std::make_unique<OrOptNeighborhood>(candidates);
+        case NeighborhoodType::SEGMENT_EXCHANGE: return std::make_unique<SegmentExchangeNeighborhood>(candidates);
+    }
+    throw std::invalid_argument("Error: Unknown neighbourhood type.");
+}
+
+// Create neighbourhoods for a list of types
+std::vector<std::unique_ptr<Neighborhood>> Neighborhood::createAll(const std::vector<NeighborhoodType>& types,
+                                                                   const CandidateList* candidates) {
+    std::vector<std::unique_ptr<Neighborhood>> neighborhoods;
+    for (NeighborhoodType type : types) {
+        neighborhoods.push_back(create(type, candidates));
+    }
+    return neighborhoods;
+}
+
+// Draw a candidate move, falling back to a uniform one
+Move Neighborhood::randomMove(const std::vector<int>& tour, const std::vector<int>& positions, RandomGenerator& generator) const {
+    const int size = tour.size();
+    if (candidates && generator.uniform() >= UNIFORM_MOVE_SHARE) {
+        Move move;
+        if (candidateMove(tour, positions, generator, move)) return move;
+    }
+    return uniformMove(size, generator);
+}
+
+// Check whether candidate lists are used
+bool Neighborhood::usesCandidates() const {
+    return candidates != nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// Swap
+// ---------------------------------------------------------------------------
+
+NeighborhoodType SwapNeighborhood::getType() const {
+    return NeighborhoodType::SWAP;
+}
+
+std::string SwapNeighborhood::getName() const {
+    return "swap";
+}
+
+long long SwapNeighborhood::countMovesInRow(int size, int row) const {
+    if (candidates) return 2LL * candidates->size();
+    return size - 1 - row;
+}
+
+void SwapNeighborhood::forEachMove(const std::vector<int>& tour, const std::vector<int>& positions, int firstRow, int lastRow,
+                                   const std::function<void(const Move&)>& visit) const {
+    const int size = tour.size();
+    if (!candidates) {
+        for (int i = firstRow; i < lastRow; ++i) {
+            for (int j = i + 1; j < size; ++j) {
+                visit(MoveEvaluator::swap(i, j));
+            }
+        }
+        return;
+    }
+
+    const int k = candidates->size();
+    for (int i = firstRow; i < lastRow; ++i) {
+        // Bring a candidate successor right after tour[i]
+        const int next = (i + 1) % size;
+        const int* successors = candidates->successors(tour[i]);
+        for (int r = 0; r < k; ++r) {
+            int j = positions[successors[r]];
+            if (j != next && j != i) visit(MoveEvaluator::swap(next, j));
+        }
+        // Bring a candidate predecessor right before tour[i]
+        const int previous = (i - 1 + size) % size;
+        const int* predecessors = candidates->predecessors(tour[i]);
+        for (int r = 0; r < k; ++r) {
+            int j = positions[predecessors[r]];
+            if (j != previous && j != i) visit(MoveEvaluator::swap(previous, j));
+        }
+    }
+}
+
+Move SwapNeighborhood::uniformMove(int size, RandomGenerator& generator) const {
+    int first, second;
+    do {
+        first = generator.between(1, size - 1);
+        second = generator.between(1, size - 1);
+    } while (first == second);
+    return MoveEvaluator::swap(first, second);
+}
+
+bool SwapNeighborhood::candidateMove(const std::vector<int>& tour, const std::vector<int>& positions,
+                                     RandomGenerator& generator, Move& move) const {
+    const int size = tour.size();
+    int i = generator.between(0, size - 2);
+    int rank = generator.between(0, candidates->size() - 1);
+    int j = positions[candidates->successors(tour[i])[rank]];
+    if (j == 0 || j == i || j == i + 1) return false;
+    move = MoveEvaluator::swap(i + 1, j);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Or-opt
+// ---------------------------------------------------------------------------
+
+OrOptNeighborhood::OrOptNeighborhood(const CandidateList* candidates, int maxSegmentLength)
+    : Neighborhood(candidates), maxSegmentLength(std::max(1, maxSegmentLength)) {}
+
+NeighborhoodType OrOptNeighborhood::getType() const {
+    return NeighborhoodType::OR_OPT;
+}
+
+std::string OrOptNeighborhood::getName() const {
+    return "or-opt";
+}
+
+long long OrOptNeighborhood::countMovesInRow(int size, int row) const {
+    if (row == 0) return 0;
+    long long count = 0;
+    for (int length = 1; length <= maxSegmentLength && row + length <= size; ++length) {
+        count += candidates ? 2LL * candidates->size() : std::max(0, size - length - 1);
+    }
+    return count;
+}
+
+void OrOptNeighborhood::forEachMove(const std::vector<int>& tour, const std::vector<int>& positions, int firstRow, int lastRow,
+                                    const std::function<void(const Move&)>& visit) const {
+    const int size = tour.size();
+    for (int start = std::max(1, firstRow); start < lastRow; ++start) {
+        for (int length = 1; length <= maxSegmentLength && start + length <= size; ++length) {
+            int end = start + length - 1;
+
+            if (!candidates) {
+                for (int target = 0; target < start - 1; ++target) {
+                    visit(MoveEvaluator::orOpt(start, length, target));
+                }
+                for (int target = end + 1; target < size; ++target) {
+                    visit(MoveEvaluator::orOpt(start, length, target));
+                }
+                continue;
+            }
+
+            auto isValidTarget = [start, end](int target) { return target < start - 1 || target > end; };
+            const int k = candidates->size();
+            // Place the segment right after a candidate predecessor of its first city
+            const int* predecessors = candidates->predecessors(tour[start]);
+            for (int r = 0; r < k; ++r) {
+                int target = positions[predecessors[r]];
+                if (isValidTarget(target)) visit(MoveEvaluator::orOpt(start, length, target));
+            }
+            // Place the segment right before a candidate successor of its last city
+            const int* successors = candidates->successors(tour[end]);
+            for (int r = 0; r < k; ++r) {
+                int target = (positions[successors[r]] - 1 + size) % size;
+                if (isValidTarget(target)) visit(MoveEvaluator::orOpt(start, length, target));
+            }
+        }
+    }
+}
+
+Move OrOptNeighborhood::uniformMove(int size, RandomGenerator& generator) const {
+    int length = generator.between(1, std::min(maxSegmentLength, size - 3));
+    int start = generator.between(1, size - length);
+    int target;
+    do {
+        target = generator.between(0, size - 1);
+    } while (target >= start - 1 && target <= start + length - 1);
+    return MoveEvaluator::orOpt(start, length, target);
+}
+
+bool OrOptNeighborhood::candidateMove(const std::vector<int>& tour, const std::vector<int>& positions,
+                                      RandomGenerator& generator, Move& move) const {
+    const int size = tour.size();
+    int length = generator.between(1, std::min(maxSegmentLength, size - 3));
+    int start = generator.between(1, size - length);
+    int rank = generator.between(0, candidates->size() - 1);
+    int target = positions[candidates->predecessors(tour[start])[rank]];
+    if (target >= start - 1 && target <= start + length - 1) return false;
+    move = MoveEvaluator::orOpt(start, length, target);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Segment exchange (reversal-free 3-opt)
+// ---------------------------------------------------------------------------
+
+NeighborhoodType SegmentExchangeNeighborhood::getType() const {
+    return NeighborhoodType::SEGMENT_EXCHANGE;
+}
+
+std::string SegmentExchangeNeighborhood::getName() const {
+    return "segment exchange";
+}
+
+long long SegmentExchangeNeighborhood::countMovesInRow(int size, int row) const {
+    long long remaining = size - 1 - row;
+    if (remaining <= 1) return 0;
+    if (candidates) return static_cast<long long>(candidates->size()) * candidates->size();
+    return remaining * (remaining - 1) / 2;
+}
+
+void SegmentExchangeNeighborhood::forEachMove(const std::vector<int>& tour, const std::vector<int>& positions, int firstRow, int lastRow,
+                                              const std::function<void(const Move&)>& visit) const {
+    const int size = tour.size();
+    if (!candidates) {
+        for (int i = firstRow; i < lastRow; ++i) {
+            for (int j = i + 1; j < size - 1; ++j) {
+                for (int k = j + 1; k < size; ++k) {
+                    visit(MoveEvaluator::segmentExchange(i, j, k));
+                }
+            }
+        }
+        return;
+    }
+
+    const int count = candidates->size();
+    for (int i = firstRow; i < std::min(lastRow, size - 2); ++i) {
+        const int* successors = candidates->successors(tour[i]);
+        const int* predecessors = candidates->predecessors(tour[i + 1]);
+        // New arc tour[i] -> tour[j + 1] to a candidate successor
+        for (int r = 0; r < count; ++r) {
+            int j = positions[successors[r]] - 1;
+            if (j <= i || j >= size - 1) continue;
+            // New arc tour[k] -> tour[i + 1] from a candidate predecessor
+            for (int q = 0; q < count; ++q) {
+                int k = positions[predecessors[q]];
+                if (k > j) visit(MoveEvaluator::segmentExchange(i, j, k));
+            }
+        }
+    }
+}
+
+Move SegmentExchangeNeighborhood::uniformMove(int size, RandomGenerator& generator) const {
+    int positions[3];
+    do {
+        for (int& position : positions) position = generator.between(0, size - 1);
+        std::sort(positions, positions + 3);
+    } while (positions[0] == positions[1] || positions[1] == positions[2]);
+    return MoveEvaluator::segmentExchange(positions[0], positions[1], positions[2]);
+}
+
+bool SegmentExchangeNeighborhood::candidateMove(const std::vector<int>& tour, const std::vector<int>& positions,
+                                                RandomGenerator& generator, Move& move) const {
+    const int size = tour.size();
+    const int lastRank = candidates->size() - 1;
+    int i = generator.between(0, size - 3);
+    int j = positions[candidates->successors(tour[i])[generator.between(0, lastRank)]] - 1;
+    int k = positions[candidates->predecessors(tour[i + 1])[generator.between(0, lastRank)]];
+    if (j <= i || k <= j) return false;
+    move = MoveEvaluator::segmentExchange(i, j, k);
+    return true;
+}
@@ -0,0 +1,217 @@
+#include "../headers/PortfolioSolver.h"
+#include "../headers/GreedyAlgorithm.h"
+#include "../headers/TabuSearch.h"
+#include "../headers/SimulatedAnnealing.h"
+#include "../headers/RandomGenerator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Result of one worker together with its tour
+struct WorkerRun {
+    PortfolioSolver::WorkerResult result;
+    std::vector<int> tour;                               // Closed best tour.
+    std::vector<std::pair<double, int>> improvements;    // (seconds since the worker's start, cost).
+};
+
+}
+
+// Constructor
+PortfolioSolver::PortfolioSolver(std::shared_ptr<const DistanceMatrix> matrix, double maxTimeInSeconds, double coolingFactor, ThreadPool* pool,
+                                 const std::vector<NeighborhoodType>& neighborhoodTypes, std::shared_ptr<const CandidateList> candidates)
+    : distanceMatrix(std::move(matrix)), coolingFactor(coolingFactor), threadPool(pool),
+      neighborhoodTypes(neighborhoodTypes), candidateList(std::move(candidates)), workerCount(0), eliteCapacity(DEFAULT_ELITE_CAPACITY),
+      stagnationPeriod(0.0), seed(RandomGenerator::randomSeed()), localSearchEnabled(false),
+      bestCost(std::numeric_limits<int>::max()), bestTimestamp(0.0), eliteAccepted(0), stopReason(StopReason::RUNNING) {
+    stopLimits.seconds = maxTimeInSeconds;
+}
+
+// Run all workers until the common deadline
+void PortfolioSolver::solve() {
+    const int size = distanceMatrix->size();
+    bestTour.clear();
+    bestCost = std::numeric_limits<int>::max();
+    bestTimestamp = 0.0;
+    improvementHistory.clear();
+    workerResults.clear();
+    eliteAccepted = 0;
+    stopReason = StopReason::RUNNING;
+    if (size == 0) return;
+
+    // Workers beyond the pool's threads would only start once the others hit the deadline
+    const int threads = threadPool ? threadPool->size() + 1 : 1;
+    const int workers = workerCount > 0 ? std::min(workerCount, threads) : threads;
+
+    // One deadline for all workers: a worker the busy pool starts late only gets the rest of the budget
+    StopLimits workerLimits = stopLimits;
+    workerLimits.startTime = stopLimits.runStart();
+    GreedyAlgorithm greedySolver(distanceMatrix, threadPool);
+    greedySolver.setStartCities(static_cast<int>(std::max(1LL, SimulatedAnnealing::GREEDY_SCAN_BUDGET / (static_cast<long long>(size) * size))));
+    greedySolver.solve();
+    std::vector<std::vector<int>> startTours(workers);
+    for (int index = 0; index < workers; ++index) {
+        startTours[index] = index == 0 ? greedySolver.getBestTour()
+                                       : greedySolver.solveFromCity(static_cast<int>(static_cast<long long>(index) * size / workers));
+    }
+    const double stagnation = stagnationPeriod > 0.0 ? stagnationPeriod : stopLimits.seconds / 10.0;
+    std::atomic<bool> cancelled{false};
+
+    ElitePool elitePool(eliteCapacity, size);
+    const RandomGenerator root(seed);
+    std::vector<WorkerRun> runs(workers);
+
+    auto runWorker = [&](int index) {
+        RandomGenerator stream = root.stream(index);
+        const std::uint64_t workerSeed = stream();
+        WorkerRun& run = runs[index];
+        if (index % 2 == 0) {
+            TabuSearch solver(distanceMatrix, TabuMemory::REACTIVE_TENURE, workerLimits.seconds, nullptr, neighborhoodTypes, candidateList);
+            solver.setStopLimits(workerLimits, &cancelled);
+            solver.setSeed(workerSeed);
+            solver.setLocalSearch(localSearchEnabled);
+            solver.setStartTour(startTours[index]);
+            solver.setElitePool(&elitePool, stagnation);
+            solver.solve();
+            run.result = WorkerResult{PortfolioWorker::TABU_SEARCH, solver.getOptimalCost(), solver.getBestTourTimestamp(),
+                                      solver.getIterationCount(), solver.getStopReason()};
+            run.tour = solver.getOptimalSolution();
+            run.tour.push_back(run.tour.front());
+            run.improvements = solver.getImprovementHistory();
+        } else {
+            SimulatedAnnealing solver(distanceMatrix, coolingFactor, workerLimits.seconds, neighborhoodTypes, candidateList);
+            solver.setStopLimits(workerLimits, &cancelled);
+            solver.setSeed(workerSeed);
+            solver.setVerbose(false);
+            solver.setLocalSearch(localSearchEnabled);
+            solver.setStartTour(startTours[index]);
+            solver.setElitePool(&elitePool, stagnation);
+            solver.solve();
+            run.result = WorkerResult{PortfolioWorker::SIMULATED_ANNEALING, solver.getBestCost(), solver.getBestSolutionTimestamp(),
+                                      solver.getProposalCount(), solver.getStopReason()};
+            run.tour = solver.getBestSolution();
+            run.improvements = solver.getImprovementHistory();
+        }
+    };
+
+    std::vector<std::future<void>> helpers;
+    for (int index = 1; index < workers; ++index) {
+        helpers.push_back(threadPool->submit([&runWorker, index] { runWorker(index); }));
+    }
+    runWorker(0);
+    for (std::future<void>& helper : helpers) helper.get();
+
+    // Worker clocks count from the common start
+    std::vector<std::pair<double, int>> events;
+    for (WorkerRun& run : runs) {
+        workerResults.push_back(run.result);
+        events.insert(events.end(), run.improvements.begin(), run.improvements.end());
+        if (run.result.bestCost < bestCost) {
+            bestCost = run.result.bestCost;
+            bestTour = run.tour;
+            bestTimestamp = run.result.bestTimestamp;
+            stopReason = run.result.stopReason;
+        }
+    }
+    std::sort(events.begin(), events.end());
+    for (const std::pair<double, int>& event : events) {
+        if (improvementHistory.empty() || event.second < improvementHistory.back().second) improvementHistory.push_back(event);
+    }
+    eliteAccepted = elitePool.getAcceptedCount();
+}
+
+// Set the limits of the run
+void PortfolioSolver::setStopLimits(const StopLimits& limits) {
+    stopLimits = limits;
+}
+
+// Set the number of workers
+void PortfolioSolver::setWorkerCount(int count) {
+    workerCount = std::max(0, count);
+}
+
+// Set the size of the elite pool
+void PortfolioSolver::setEliteCapacity(int capacity) {
+    eliteCapacity = std::max(1, capacity);
+}
+
+// Set the stagnation period of the workers
+void PortfolioSolver::setStagnationPeriod(double seconds) {
+    stagnationPeriod = std::max(0.0, seconds);
+}
+
+// Set the seed of the run
+void PortfolioSolver::setSeed(std::uint64_t value) {
+    seed = value;
+}
+
+// Enable or disable the local search of the workers
+void PortfolioSolver::setLocalSearch(bool enabled) {
+    localSearchEnabled = enabled;
+}
+
+// Get the best tour
+std::vector<int> PortfolioSolver::getBestTour() const {
+    return bestTour;
+}
+
+// Get the best cost
+int PortfolioSolver::getBestCost() const {
+    return bestCost;
+}
+
+// Get the time when the best tour was found
+double PortfolioSolver::getBestTourTimestamp() const {
+    return bestTimestamp;
+}
+
+// Get the improvements over all workers
+std::vector<std::pair<double, int>> PortfolioSolver::getImprovementHistory() const {
+    return improvementHistory;
+}
+
+// Get the outcome of every worker
+std::vector<PortfolioSolver::WorkerResult> PortfolioSolver::getWorkerResults() const {
+    return workerResults;
+}
+
+// Sum of the workers' iterations
+long long PortfolioSolver::getIterationCount() const {
+    long long total = 0;
+    for (const WorkerResult& result : workerResults) total += result.iterations;
+    return total;
+}
+
+// Get the number of accepted elite tours
+long long PortfolioSolver::getEliteAcceptedCount() const {
+    return eliteAccepted;
+}
+
+// Get why the best worker stopped
+StopReason PortfolioSolver::getStopReason() const {
+    return stopReason;
+}
+
+// Save the results to a file
+void PortfolioSolver::saveResultsToFile(const std::string& fileName) const {
+    std::ofstream outFile(fileName);
+    if (!outFile) {
+        throw std::runtime_error("Error: Unable to open file for writing.");
+    }
+
+    outFile << distanceMatrix->size() << std::endl;
+    for (int city : bestTour) {
+        outFile << city << " ";
+    }
+    outFile << std::endl;
+}
+
+// Name of a worker's solver
+std::string PortfolioSolver::workerName(PortfolioWorker solver) {
+    return solver == PortfolioWorker::TABU_SEARCH ? "Tabu Search" : "Simulated Annealing";
+}
@@ -0,0 +1,42 @@
+#include "../headers/RandomGenerator.h"
+
+#include <random>
+
+// Constructor: expand the seed with SplitMix64, which never yields an all-zero state
+RandomGenerator::RandomGenerator(std::uint64_t seed) {
+    for (std::uint64_t& word : state) {
+        seed += 0x9e3779b97f4a7c15ULL;
+        std::uint64_t mixed = seed;
+        mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebULL;
+        word = mixed ^ (mixed >> 31);
+    }
+}
+
+// Seed from the operating system's entropy source
+std::uint64_t RandomGenerator::randomSeed() {
+    std::random_device device;
+    return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+}
+
+// Jump polynomial of xoshiro256**, equivalent to 2^128 calls
+void RandomGenerator::jump() {
+    static const std::uint64_t JUMP[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+    std::uint64_t jumped[4] = {0, 0, 0, 0};
+    for (std::uint64_t word : JUMP) {
+        for (int bit = 0; bit < 64; ++bit) {
+            if (word & (std::uint64_t(1) << bit)) {
+                for (int index = 0; index < 4; ++index) jumped[index] ^= state[index];
+            }
+            (*this)();
+        }
+    }
+    for (int index = 0; index < 4; ++index) state[index] = jumped[index];
+}
+
+// Independent stream for the index-th parallel search
+RandomGenerator RandomGenerator::stream(int index) const {
+    RandomGenerator generator = *this;
+    for (int step = 0; step < index; ++step) generator.jump();
+    return generator;
+}
@@ -1,5 +1,7 @@
 #include "../headers/SimulatedAnnealing.h"
 #include "../headers/GreedyAlgorithm.h"
+#include "../headers/MoveEvaluator.h"
+#include "../headers/TourKernels.h"
 
 #include <fstream>
 #include <iostream>
@@ -9,34 +11,165 @@
 #include <chrono>
 #include <algorithm>
 #include <limits>
+#include <future>
+#include <cstdint>
 
 /**
  * Constructor for SimulatedAnnealing.
  * Initializes the algorithm with the given graph, cooling factor, and maximum time.
- * @param graph - Adjacency matrix representing distances between nodes.
+ * @param graph - Shared matrix of distances between nodes.
  * @param coolingFactor - The cooling rate for the temperature decrease.
- * @param maxTime - The maximum time allowed for the algorithm to run.
+ * @param maxTime - The maximum time allowed for the algorithm to run, in seconds.
+ * @param neighborhoodTypes - Neighbourhoods the random moves are drawn from, each with the same probability.
+ * @param candidates - Candidate lists biasing the random moves towards near-neighbour arcs, nullptr for uniform moves.
  */
-SimulatedAnnealing::SimulatedAnnealing(const std::vector<std::vector<int>>& graph, double coolingFactor, double maxTime)
-    : graph(graph), coolingFactor(coolingFactor), maxTime(maxTime), bestCost(std::numeric_limits<int>::max()), bestSolutionTimestamp(0.0) {
-    graphSize= graph.size();
+SimulatedAnnealing::SimulatedAnnealing(std::shared_ptr<const DistanceMatrix> graph, double coolingFactor, double maxTime,
+                                       const std::vector<NeighborhoodType>& neighborhoodTypes, std::shared_ptr<const CandidateList> candidates)
+    : graph(std::move(graph)), coolingFactor(coolingFactor), schedule(CoolingSchedule::ADAPTIVE), epochFactor(AnnealingSchedule::DEFAULT_EPOCH_FACTOR),
+      cancelFlag(nullptr), stopReason(StopReason::RUNNING), bestCost(std::numeric_limits<int>::max()), bestSolutionTimestamp(0.0), proposalCount(0), epochCount(0), reheatCount(0),
+      candidateList(std::move(candidates)), neighborhoods(Neighborhood::createAll(neighborhoodTypes, candidateList.get())), localSearchPeriod(0.0),
+      chainCount(1), threadPool(nullptr), restartPeriod(0.0), temperingReplicas(1), seed(RandomGenerator::randomSeed()),
+      construction(ConstructionType::NEAREST_NEIGHBOR), elitePool(nullptr), stagnationPeriod(0.0), verbose(true) {
+    graphSize = this->graph->size();
+    stopLimits.seconds = maxTime;
+    if (neighborhoods.empty()) {
+        neighborhoods = Neighborhood::createAll({NeighborhoodType::SWAP, NeighborhoodType::OR_OPT}, candidateList.get());
+    }
 }
 
 /**
  * Solves the ATSP problem using Simulated Annealing.
- * Uses the Greedy Algorithm to generate an initial solution and then improves it using Simulated Annealing.
+ * Uses the selected construction heuristic (the Greedy Algorithm by default) to generate an initial solution
+ * and then improves it using Simulated Annealing.
  */
 void SimulatedAnnealing::solve() {
 
-    GreedyAlgorithm* greedySolver = new GreedyAlgorithm(graph);
-    greedySolver->solve();
+    GreedyAlgorithm greedySolver(graph, threadPool);
+    std::vector<int> startTour;
+    if (static_cast<int>(initialTour.size()) == graphSize + 1 && graphSize > 0) {
+        startTour = initialTour;
+    } else if (construction == ConstructionType::NEAREST_NEIGHBOR) {
+        // Every greedy start scans the whole matrix, so large instances try only a few evenly spread starts
+        if (graphSize > 0) {
+            greedySolver.setStartCities(static_cast<int>(std::max(1LL, GREEDY_SCAN_BUDGET / (static_cast<long long>(graphSize) * graphSize))));
+        }
+        greedySolver.solve();
+        startTour = greedySolver.getBestTour();
+    } else {
+        startTour = ConstructionHeuristic::create(construction, graph, threadPool)->build();
+    }
 
-    currentSolution = greedySolver->getBestTour();
-    currentCost = greedySolver->getBestCost();
+    if (temperingReplicas > 1) {
+        runParallelTempering(greedySolver, startTour);
+        return;
+    }
+
+    if (chainCount > 1 && threadPool) {
+        runParallelChains(greedySolver, startTour);
+        return;
+    }
+
+    currentSolution = startTour;
+    currentSolution.pop_back(); // The annealing works on open tours
+    currentCost = calculateCost(currentSolution, *graph, graphSize);
 
     runSimulatedAnnelingFor(currentSolution);
 }
 
+/**
+ * Selects the schedule changing the temperature between epochs.
+ * @param type - The cooling schedule.
+ * @param proposalsPerCity - Length of an epoch in proposals per city.
+ */
+void SimulatedAnnealing::setSchedule(CoolingSchedule type, int proposalsPerCity) {
+    schedule = type;
+    epochFactor = std::max(1, proposalsPerCity);
+}
+
+/**
+ * Sets the limits ending a run, replacing the time limit given to the constructor.
+ * @param limits - Time limit and optional proposal budget, no-improvement window and target cost.
+ * @param flag - Cancel flag shared with cooperating searches, nullptr to run alone.
+ */
+void SimulatedAnnealing::setStopLimits(const StopLimits& limits, std::atomic<bool>* flag) {
+    stopLimits = limits;
+    cancelFlag = flag;
+}
+
+/**
+ * Enables the multi-start mode running several independent chains in parallel.
+ * @param chains - Number of chains, 1 for the classic single chain.
+ * @param pool - Thread pool running chains 1..chains-1, chain 0 runs on the calling thread.
+ * @param restartSeconds - Interval after which a chain jumps to the global best if it is better, 0 to disable.
+ */
+void SimulatedAnnealing::setParallelChains(int chains, ThreadPool* pool, double restartSeconds) {
+    chainCount = std::max(1, chains);
+    threadPool = pool;
+    restartPeriod = std::max(0.0, restartSeconds);
+}
+
+/**
+ * Enables the replica-exchange mode, which replaces the geometric cooling schedule.
+ * @param replicas - Number of temperature rungs, 1 or less disables the mode.
+ * @param pool - Thread pool sweeping the replicas, nullptr to sweep them on the calling thread.
+ */
+void SimulatedAnnealing::setParallelTempering(int replicas, ThreadPool* pool) {
+    temperingReplicas = std::max(1, replicas);
+    threadPool = pool;
+}
+
+/**
+ * Sets the seed of the random streams. Parallel chains and tempering rungs use independent streams of it.
+ * @param value - The seed.
+ */
+void SimulatedAnnealing::setSeed(std::uint64_t value) {
+    seed = value;
+}
+
+/**
+ * Selects the construction heuristic building the start tour.
+ * @param type - The construction heuristic.
+ */
+void SimulatedAnnealing::setConstruction(ConstructionType type) {
+    construction = type;
+}
+
+/**
+ * Starts the (first) chain from the given tour.
+ * @param tour - The closed start tour.
+ */
+void SimulatedAnnealing::setStartTour(const std::vector<int>& tour) {
+    initialTour = tour;
+}
+
+/**
+ * Shares the chains' best solutions with concurrent solvers through an elite pool.
+ * @param pool - The shared elite pool, nullptr to run alone.
+ * @param stagnationSeconds - Seconds without a new best after which a chain pulls a solution from the pool.
+ */
+void SimulatedAnnealing::setElitePool(ElitePool* pool, double stagnationSeconds) {
+    elitePool = pool;
+    stagnationPeriod = std::max(0.0, stagnationSeconds);
+}
+
+/**
+ * Enables or disables the run statistics printed to std::cout.
+ * @param enabled - Whether to print them.
+ */
+void SimulatedAnnealing::setVerbose(bool enabled) {
+    verbose = enabled;
+}
+
+/**
+ * Enables or disables the local search post-optimisation.
+ * @param enabled - Whether to run the local search.
+ * @param periodSeconds - Interval between local search runs on the current solution, 0 to only polish the final solution.
+ */
+void SimulatedAnnealing::setLocalSearch(bool enabled, double periodSeconds) {
+    localSearch = enabled ? std::make_unique<LocalSearch>(*graph, candidateList.get()) : nullptr;
+    localSearchPeriod = enabled ? std::max(0.0, periodSeconds) : 0.0;
+}
+
 /**
  * Retrieves the best solution found during the search.
  * @return The best solution as a sequence of node indices.
@@ -61,6 +194,54 @@ double SimulatedAnnealing::getBestSolutionTimestamp() const {
     return bestSolutionTimestamp;
 }
 
+/**
+ * Retrieves the number of candidate moves evaluated by the last run.
+ * @return The number of proposals.
+ */
+long long SimulatedAnnealing::getProposalCount() const {
+    return proposalCount;
+}
+
+/**
+ * Retrieves every improvement of the best solution during the last run.
+ * @return Pairs of (seconds since the start, cost) with strictly decreasing cost.
+ */
+std::vector<std::pair<double, int>> SimulatedAnnealing::getImprovementHistory() const {
+    return improvementHistory;
+}
+
+/**
+ * Retrieves the per-epoch trace of the chain that found the best solution.
+ * @return The thinned trace, empty for parallel tempering.
+ */
+std::vector<AnnealingSchedule::EpochRecord> SimulatedAnnealing::getTemperatureTrace() const {
+    return temperatureTrace;
+}
+
+/**
+ * Retrieves the number of epochs completed by all chains during the last run.
+ * @return The number of epochs.
+ */
+long long SimulatedAnnealing::getEpochCount() const {
+    return epochCount;
+}
+
+/**
+ * Retrieves the number of reheats of all chains during the last run.
+ * @return The number of reheats.
+ */
+int SimulatedAnnealing::getReheatCount() const {
+    return reheatCount;
+}
+
+/**
+ * Retrieves why the last run stopped.
+ * @return The stop reason.
+ */
+StopReason SimulatedAnnealing::getStopReason() const {
+    return stopReason;
+}
+
 /**
  * Saves the results (best solution and its cost) to a specified file.
  * @param fileName - The name of the file to save the results to.
@@ -85,101 +266,542 @@ void SimulatedAnnealing::saveResultsToFile(const std::string& fileName) const {
 /**
  * Calculates the total cost of a given solution.
  * @param solution - The current solution represented as a sequence of node indices.
- * @param adjacencyMatrix - The graph's adjacency matrix.
+ * @param adjacencyMatrix - The graph's distance matrix.
  * @param size - The number of nodes in the graph.
  * @return The total cost of the solution.
  */
-int SimulatedAnnealing::calculateCost(const std::vector<int> &solution, std::vector<std::vector<int>> adjacencyMatrix, int size) {
-    int cost = 0;
+int SimulatedAnnealing::calculateCost(const std::vector<int> &solution, const DistanceMatrix& adjacencyMatrix, int size) const {
+    return TourKernels::cycleCost(adjacencyMatrix, solution.data(), size);
+}
 
-    for (int i = 0; i < size - 1; i++) {
-        cost += adjacencyMatrix[solution[i]][solution[i + 1]];
+/**
+ * Draws a random move from one of the enabled neighbourhoods. Position 0 is never moved, so the tour keeps its starting city.
+ * @param solution - The current solution.
+ * @param positions - Position index of the current solution.
+ * @param generator - The random number generator of the run.
+ * @return The proposed move.
+ */
+Move SimulatedAnnealing::generateRandomMove(const std::vector<int>& solution, const std::vector<int>& positions, RandomGenerator& generator) const {
+    if (neighborhoods.size() == 1) {
+        return neighborhoods.front()->randomMove(solution, positions, generator);
     }
-    cost += adjacencyMatrix[solution[size - 1]][solution[0]]; // Powrót do startu
-    return cost;
+    return neighborhoods[generator.below(neighborhoods.size())]->randomMove(solution, positions, generator);
 }
 
 /**
- * Executes the Simulated Annealing algorithm for a given initial solution.
- * @param initialSolution - The starting solution for the algorithm.
+ * Executes the Simulated Annealing algorithm for a given initial solution on the calling thread.
+ * Candidate moves are scored in O(1) by the MoveEvaluator and the tour is only modified when a move is accepted.
+ * @param initialSolution - The starting solution for the algorithm, an open tour without the repeated start city.
  */
 void SimulatedAnnealing::runSimulatedAnnelingFor(std::vector<int> initialSolution) {
+    AnnealingChain chain;
+    chain.currentSolution = std::move(initialSolution);
+    chain.generator = RandomGenerator(seed);
+
+    runChain(chain, stopLimits.runStart(), nullptr);
+
+    if (verbose) {
+        std::cout << "Cooling schedule: " << AnnealingSchedule::scheduleName(schedule) << ", " << chain.epochs << " epochs of "
+                  << static_cast<long long>(epochFactor) * graphSize << " proposals, " << chain.reheats << " reheats" << std::endl;
+        std::cout << "Initial temperature: " << chain.initialTemperature << std::endl;
+        std::cout << "Final Temperature (Tk): " << chain.finalTemperature << std::endl;
+        std::cout << "exp(-1/Tk): " << std::exp(-1.0/chain.finalTemperature) << std::endl;
+        std::cout << "Proposals evaluated: " << chain.proposals << " (" << chain.proposals / std::max(chain.duration, 1e-9) << " per second)" << std::endl;
+        std::cout << "Stopped by: " << StopCriterion::reasonName(chain.stopReason) << std::endl;
+    }
 
-    std::vector<int> currentSolution;
-    std::vector<int> newSolution;
-    int currentCost;
-    int newSolutionCost;
-    double time;
+    bestSolution = std::move(chain.bestSolution);
+    bestCost = chain.bestCost;
+    bestSolutionTimestamp = chain.bestTimestamp;
+    proposalCount = chain.proposals;
+    improvementHistory = std::move(chain.improvements);
+    temperatureTrace = std::move(chain.trace);
+    epochCount = chain.epochs;
+    reheatCount = chain.reheats;
+    stopReason = chain.stopReason;
+    bestSolution.push_back(bestSolution.front());
+}
 
-    auto startTime = std::chrono::high_resolution_clock::now();
+/**
+ * Runs independent annealing chains on the thread pool and the calling thread, each from its own start tour
+ * and with its own random stream, and keeps the best solution over all chains.
+ * Start tours are chosen by buildStartTour.
+ * @param greedySolver - The greedy algorithm providing the start tours of chains 1..chainCount-1.
+ * @param startTour - The constructed closed start tour of chain 0.
+ */
+void SimulatedAnnealing::runParallelChains(const GreedyAlgorithm& greedySolver, const std::vector<int>& startTour) {
+    // Chains beyond the pool's workers would only start once the others hit the deadline
+    const int chainCount = std::min(this->chainCount, threadPool->size() + 1);
+    std::vector<AnnealingChain> chains(chainCount);
+    const RandomGenerator root(seed);
+
+    for (int index = 0; index < chainCount; ++index) {
+        AnnealingChain& chain = chains[index];
+        chain.generator = root.stream(index);
+        chain.currentSolution = buildStartTour(greedySolver, startTour, index, chainCount, chain.generator);
+    }
+
+    SharedBest shared;
+    auto startTime = stopLimits.runStart();
+
+    std::vector<std::future<void>> helpers;
+    for (int index = 1; index < chainCount; ++index) {
+        helpers.push_back(threadPool->submit([this, &chains, &shared, startTime, index] {
+            runChain(chains[index], startTime, &shared);
+        }));
+    }
+    runChain(chains[0], startTime, &shared);
+    for (std::future<void>& helper : helpers) helper.get();
+
+    proposalCount = 0;
+    epochCount = 0;
+    reheatCount = 0;
+    int bestChain = 0;
+    double duration = 0.0;
+    std::vector<std::pair<double, int>> events;
+    for (int index = 0; index < chainCount; ++index) {
+        proposalCount += chains[index].proposals;
+        duration = std::max(duration, chains[index].duration);
+        epochCount += chains[index].epochs;
+        reheatCount += chains[index].reheats;
+        events.insert(events.end(), chains[index].improvements.begin(), chains[index].improvements.end());
+        if (chains[index].bestCost < chains[bestChain].bestCost) bestChain = index;
+    }
 
-    currentSolution = initialSolution;
-    currentCost = calculateCost(currentSolution, graph, graphSize);
-    this->bestSolution = currentSolution;
-    this->bestCost = currentCost;
+    if (verbose) {
+        std::cout << "Parallel chains: " << chainCount << ", best found by chain " << bestChain << std::endl;
+        std::cout << "Cooling schedule: " << AnnealingSchedule::scheduleName(schedule) << ", " << epochCount << " epochs, "
+                  << reheatCount << " reheats" << std::endl;
+        std::cout << "Proposals evaluated: " << proposalCount << " (" << proposalCount / std::max(duration, 1e-9) << " per second)" << std::endl;
+        std::cout << "Stopped by: " << StopCriterion::reasonName(chains[bestChain].stopReason) << std::endl;
+    }
+
+    bestSolution = std::move(chains[bestChain].bestSolution);
+    stopReason = chains[bestChain].stopReason;
+    bestCost = chains[bestChain].bestCost;
+    bestSolutionTimestamp = chains[bestChain].bestTimestamp;
+    temperatureTrace = std::move(chains[bestChain].trace);
+    improvementHistory = mergeImprovements(std::move(events));
+    bestSolution.push_back(bestSolution.front());
+}
+
+/**
+ * Merges the improvements of parallel searches: sorted by time, an event is kept only if it lowers the best cost so far.
+ * @param events - (seconds, cost) pairs of all searches.
+ * @return The improvements of the common best, in order of time.
+ */
+std::vector<std::pair<double, int>> SimulatedAnnealing::mergeImprovements(std::vector<std::pair<double, int>> events) {
+    std::sort(events.begin(), events.end());
+    std::vector<std::pair<double, int>> merged;
+    for (const std::pair<double, int>& event : events) {
+        if (merged.empty() || event.second < merged.back().second) merged.push_back(event);
+    }
+    return merged;
+}
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> randrand(1, graphSize- 2);
+/**
+ * Builds the start tour of one of several parallel searches: index 0 gets the constructed start tour, the others
+ * greedy tours of evenly spread start cities, or random tours when there are more searches than cities.
+ * @param greedySolver - The greedy algorithm.
+ * @param startTour - The constructed closed start tour.
+ * @param index - Index of the search.
+ * @param count - Number of searches.
+ * @param generator - Random stream of the search, used for random tours.
+ * @return The open start tour.
+ */
+std::vector<int> SimulatedAnnealing::buildStartTour(const GreedyAlgorithm& greedySolver, const std::vector<int>& startTour, int index, int count,
+                                                   RandomGenerator& generator) const {
+    std::vector<int> tour;
+    if (index == 0) {
+        tour = startTour;
+    } else if (index < graphSize) {
+        tour = greedySolver.solveFromCity(static_cast<long long>(index) * graphSize / count);
+    } else {
+        tour.resize(graphSize + 1);
+        std::iota(tour.begin(), tour.end() - 1, 0);
+        generator.shuffle(tour.begin(), tour.end() - 1);
+    }
+    tour.pop_back(); // The annealing works on open tours
+    return tour;
+}
 
-    std::vector<int> startedCosts;
-    int newCost;
-    int avg = 0;
-    int firstSwapIndex;
-    int secondSwapIndex;
+/**
+ * Runs one annealing chain from startTime until one of the stop limits is reached.
+ * The chain proposes moves in epochs of epochFactor * n proposals at a constant temperature, accepting every
+ * downhill move and an uphill move of delta with probability exp(-delta / T). Between epochs the schedule sets
+ * the next temperature; when it reheats a frozen chain, the chain continues from its best solution.
+ * The StopCriterion is asked after every proposal, but reads the clock only about once per millisecond.
+ * A chain reaching the target cost raises the cancel flag (the solver's, or the one of shared), which
+ * stops the other chains at their next clock read.
+ * When shared is given, every improvement of the chain's best is published to it, and every restartPeriod
+ * seconds the chain jumps to the global best solution if that is better than its current one. With an elite
+ * pool, new bests are published to it as well and after stagnationPeriod seconds without one the chain
+ * continues from a solution drawn from the pool.
+ * @param chain - The chain, with its start solution and seeded generator; receives the results.
+ * @param startTime - Common start of the run.
+ * @param shared - Global best of all chains, nullptr for a single chain.
+ */
+void SimulatedAnnealing::runChain(AnnealingChain& chain, std::chrono::high_resolution_clock::time_point startTime, SharedBest* shared) const {
 
-    for(int i = 0; i < 50; i++){
-        newSolution = currentSolution;
+    std::vector<int>& currentSolution = chain.currentSolution;
+    std::vector<int> positions;
+    int currentCost;
+    double time = 0.0;
+
+    currentCost = calculateCost(currentSolution, *graph, graphSize);
+    chain.bestSolution = currentSolution;
+    chain.bestCost = currentCost;
+    chain.bestTimestamp = 0.0;
+    chain.proposals = 0;
+    chain.epochs = 0;
+    chain.reheats = 0;
+    chain.trace.clear();
+    chain.improvements.assign(1, {0.0, currentCost});
+    chain.duration = 0.0;
+    chain.stopReason = StopReason::RUNNING;
+
+    StopCriterion stopCriterion(stopLimits, cancelFlag ? cancelFlag : (shared ? &shared->cancelled : nullptr));
+    stopCriterion.start(startTime);
+    stopCriterion.recordImprovement(0, currentCost);
+
+    double lastImprovementTime = stopCriterion.getLastElapsed();
+    auto recordBest = [this, &chain, &currentSolution, &currentCost, &time, &lastImprovementTime, &stopCriterion, shared]() {
+        time = stopCriterion.elapsed();
+        stopCriterion.recordImprovement(chain.proposals, currentCost);
+        chain.bestSolution = currentSolution;
+        chain.bestCost = currentCost;
+        chain.bestTimestamp = time;
+        chain.improvements.emplace_back(time, currentCost);
+        lastImprovementTime = time;
+        if (shared) shared->publish(currentSolution, currentCost);
+        if (elitePool) elitePool->publish(currentSolution, currentCost);
+    };
+    if (elitePool) elitePool->publish(currentSolution, currentCost);
+
+    // Too few movable positions to build any move, the initial tour is the answer
+    if (graphSize < 5) {
+        if (localSearch) chain.bestCost -= localSearch->optimize(chain.bestSolution);
+        chain.improvements.assign(1, {0.0, chain.bestCost});
+        chain.initialTemperature = chain.finalTemperature = 0.0;
+        return;
+    }
 
-        do {
-            firstSwapIndex = randrand(gen);
-            secondSwapIndex = randrand(gen);
-        } while (firstSwapIndex == secondSwapIndex);
+    MoveEvaluator evaluator(*graph);
+    MoveEvaluator::computePositions(currentSolution, positions);
+    RandomGenerator& gen = chain.generator;
 
-        std::swap(newSolution[firstSwapIndex], newSolution[secondSwapIndex]); 
-        newSolutionCost = calculateCost(newSolution, graph, graphSize) - currentCost;
-        avg += newSolutionCost;
+    // Random moves on the start tour calibrate the temperatures
+    std::vector<int> deltas(AnnealingSchedule::CALIBRATION_SAMPLES);
+    for (int& delta : deltas) {
+        delta = evaluator.delta(currentSolution, generateRandomMove(currentSolution, positions, gen));
     }
+    AnnealingSchedule annealing(schedule, coolingFactor, graphSize, epochFactor);
+    annealing.start(deltas);
+    chain.initialTemperature = annealing.getInitialTemperature();
+    const long long epochLength = annealing.getEpochLength();
 
-    double temp = -(avg/50) / log(0.98);
-    std::cout << "Initial temperature: " << temp << std::endl;
+    double nextLocalSearchTime = lastImprovementTime + localSearchPeriod;
+    double nextRestartTime = lastImprovementTime + restartPeriod;
+    bool stopped = false;
 
     while (true) {
 
-        double expo;
-        do {
-            newSolution = currentSolution;
-
-            do {
-                firstSwapIndex = randrand(gen);
-                secondSwapIndex = randrand(gen);
-            } while (firstSwapIndex == secondSwapIndex);
-
-            int vertex= newSolution[firstSwapIndex];
-            newSolution.erase(newSolution.begin() + firstSwapIndex); // Usuń wierzchołek
-            newSolution.insert(newSolution.begin() + secondSwapIndex, vertex); // Wstaw w nowe miejsce
-
-            if(std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count() >= maxTime) {
-                std::cout << "Final Temperature (Tk): " << temp << std::endl;
-                std::cout << "exp(-1/Tk): " << std::exp(-1.0/temp) << std::endl;
-                this->bestSolution = bestSolution;
-                this->bestCost = bestCost;
-                return;
+        const double temperature = annealing.getTemperature();
+        const int epochStartCost = chain.bestCost;
+        long long uphill = 0;
+        long long accepted = 0;
+        for (long long step = 0; step < epochLength; ++step) {
+            if (stopCriterion.shouldStop(chain.proposals)) {
+                stopped = true;
+                break;
+            }
+            ++chain.proposals;
+            Move move = generateRandomMove(currentSolution, positions, gen);
+            int delta = evaluator.delta(currentSolution, move);
+            if (delta > 0) {
+                ++uphill;
+                if (gen.uniform() >= std::exp(-delta / temperature)) continue;
+                ++accepted;
+            }
+
+            evaluator.apply(currentSolution, positions, move);
+            currentCost += delta;
+            if (currentCost < chain.bestCost) recordBest();
+        }
+
+        time = stopCriterion.getLastElapsed();
+        if (stopped) {
+            chain.duration = stopCriterion.elapsed();
+            chain.stopReason = stopCriterion.getReason();
+            chain.finalTemperature = annealing.getTemperature();
+            chain.epochs = annealing.getEpochCount();
+            chain.reheats = annealing.getReheatCount();
+            chain.trace = annealing.getTrace();
+            if (localSearch) {
+                int improvement = localSearch->optimize(chain.bestSolution);
+                if (improvement > 0) {
+                    chain.bestCost -= improvement;
+                    chain.improvements.emplace_back(stopCriterion.elapsed(), chain.bestCost);
+                }
+            }
+            return;
+        }
+
+        // The share of the budget used so far: time or proposals, whichever runs out first
+        double progress = stopLimits.seconds > 0.0 ? time / stopLimits.seconds : 1.0;
+        if (stopLimits.iterations > 0) progress = std::max(progress, static_cast<double>(chain.proposals) / stopLimits.iterations);
+        if (annealing.endEpoch(time, progress, uphill, accepted, chain.bestCost < epochStartCost, currentCost)) {
+            currentSolution = chain.bestSolution;
+            currentCost = chain.bestCost;
+            MoveEvaluator::computePositions(currentSolution, positions);
+        }
+
+        if (localSearch && localSearchPeriod > 0.0 && time >= nextLocalSearchTime) {
+            nextLocalSearchTime = time + localSearchPeriod;
+            int improvement = localSearch->optimize(currentSolution);
+            if (improvement > 0) {
+                currentCost -= improvement;
+                MoveEvaluator::computePositions(currentSolution, positions);
+                if (currentCost < chain.bestCost) recordBest();
+            }
+        }
+
+        // Stagnating, continue from one of the best solutions of all cooperating solvers
+        if (elitePool && time - lastImprovementTime >= stagnationPeriod) {
+            lastImprovementTime = time;
+            int eliteCost;
+            if (elitePool->sample(gen, currentSolution, eliteCost)) {
+                currentCost = eliteCost;
+                MoveEvaluator::computePositions(currentSolution, positions);
+            }
+        }
+
+        if (shared && restartPeriod > 0.0 && time >= nextRestartTime) {
+            nextRestartTime = time + restartPeriod;
+            if (shared->fetchIfBetter(currentSolution, currentCost)) {
+                MoveEvaluator::computePositions(currentSolution, positions);
+            }
+        }
+    }
+}
+
+/**
+ * Replica-exchange (parallel tempering) annealing. Each rung of a geometric temperature ladder holds one replica
+ * that runs Metropolis moves at the rung's fixed temperature; the rungs sweep concurrently on the thread pool.
+ * After every sweep neighbouring rungs attempt to exchange their states with the replica-exchange acceptance
+ * probability min(1, exp((1/Ti - 1/Tj) * (Ei - Ej))), alternating between even and odd pairs.
+ * The ladder spans from a hot rung accepting an average uphill move with probability HOT_ACCEPTANCE to a
+ * cold rung accepting the smallest sampled uphill move with probability COLD_ACCEPTANCE, so coolingFactor is not used.
+ * @param greedySolver - The greedy algorithm providing the start tours of rungs 1..temperingReplicas-1.
+ * @param startTour - The constructed closed start tour of rung 0.
+ */
+void SimulatedAnnealing::runParallelTempering(const GreedyAlgorithm& greedySolver, const std::vector<int>& startTour) {
+    const int rungCount = temperingReplicas;
+    std::vector<TemperingReplica> replicas(rungCount);
+    const RandomGenerator root(seed);
+
+    for (int rung = 0; rung < rungCount; ++rung) {
+        TemperingReplica& replica = replicas[rung];
+        replica.generator = root.stream(rung);
+        replica.solution = buildStartTour(greedySolver, startTour, rung, rungCount, replica.generator);
+        replica.cost = calculateCost(replica.solution, *graph, graphSize);
+        MoveEvaluator::computePositions(replica.solution, replica.positions);
+    }
+
+    bestSolution = replicas[0].solution;
+    bestCost = replicas[0].cost;
+    bestSolutionTimestamp = 0.0;
+    proposalCount = 0;
+    temperatureTrace.clear();
+    epochCount = 0;
+    reheatCount = 0;
+    stopReason = StopReason::RUNNING;
+
+    if (graphSize < 5) {
+        if (localSearch) bestCost -= localSearch->optimize(bestSolution);
+        improvementHistory.assign(1, {0.0, bestCost});
+        bestSolution.push_back(bestSolution.front());
+        return;
+    }
+
+    // Uphill moves sampled on the start tour fix the ends of the ladder
+    MoveEvaluator evaluator(*graph);
+    std::vector<int> deltas(AnnealingSchedule::CALIBRATION_SAMPLES);
+    for (int& delta : deltas) {
+        delta = evaluator.delta(replicas[0].solution, generateRandomMove(replicas[0].solution, replicas[0].positions, replicas[0].generator));
+    }
+    const std::pair<double, double> range = AnnealingSchedule::temperatureRange(deltas, HOT_ACCEPTANCE, COLD_ACCEPTANCE);
+    const double hottest = range.first;
+    const double coldest = range.second;
+    for (int rung = 0; rung < rungCount; ++rung) {
+        double share = rungCount > 1 ? static_cast<double>(rung) / (rungCount - 1) : 0.0;
+        replicas[rung].temperature = coldest * std::pow(hottest / coldest, share);
+    }
+
+    std::vector<long long> exchangeAttempts(std::max(0, rungCount - 1), 0);
+    std::vector<long long> exchangeAccepts(std::max(0, rungCount - 1), 0);
+    RandomGenerator exchangeGenerator = root.stream(rungCount);
+
+    for (TemperingReplica& replica : replicas) {
+        replica.bestCost = replica.cost;
+        replica.bestSolution = replica.solution;
+        replica.improvements.assign(1, {0.0, replica.cost});
+    }
+
+    // Every rung checks the limits after each of its proposals. The rungs sweep in lockstep, so the ladder's
+    // proposal budget and no-improvement window are split evenly over them; a new best of any rung restarts
+    // the window of all of them. A rung reaching the target raises the cancel flag, which stops the others.
+    StopLimits rungLimits = stopLimits;
+    if (rungLimits.iterations > 0) rungLimits.iterations = std::max(1LL, rungLimits.iterations / rungCount);
+    if (rungLimits.stallIterations > 0) rungLimits.stallIterations = std::max(1LL, rungLimits.stallIterations / rungCount);
+    int startCost = std::numeric_limits<int>::max();
+    for (const TemperingReplica& replica : replicas) startCost = std::min(startCost, replica.cost);
+    std::atomic<bool> ladderCancelled{false};
+    std::atomic<int> ladderBestCost{startCost};
+    std::vector<int> knownBestCost(rungCount, startCost);
+    const auto startTime = stopLimits.runStart();
+    std::vector<StopCriterion> stopCriteria;
+    stopCriteria.reserve(rungCount);
+    for (int rung = 0; rung < rungCount; ++rung) {
+        stopCriteria.emplace_back(rungLimits, cancelFlag ? cancelFlag : &ladderCancelled);
+        stopCriteria[rung].start(startTime);
+        stopCriteria[rung].recordImprovement(0, startCost);
+    }
+
+    const long long sweepLength = std::max<long long>(1000, 10LL * graphSize);
+    bool firstPairs = true;
+
+    auto sweep = [&](int rung) {
+        TemperingReplica& replica = replicas[rung];
+        StopCriterion& stopCriterion = stopCriteria[rung];
+        for (long long step = 0; step < sweepLength; ++step) {
+            const int ladderBest = ladderBestCost.load(std::memory_order_relaxed);
+            if (ladderBest < knownBestCost[rung]) {
+                knownBestCost[rung] = ladderBest;
+                stopCriterion.recordImprovement(replica.proposals, ladderBest);
+            }
+            if (stopCriterion.shouldStop(replica.proposals)) return;
+            Move move = generateRandomMove(replica.solution, replica.positions, replica.generator);
+            int delta = evaluator.delta(replica.solution, move);
+            ++replica.proposals;
+            if (delta > 0 && replica.generator.uniform() >= std::exp(-delta / replica.temperature)) continue;
+
+            evaluator.apply(replica.solution, replica.positions, move);
+            replica.cost += delta;
+            ++replica.accepted;
+            if (replica.cost < replica.bestCost) {
+                replica.bestCost = replica.cost;
+                replica.bestSolution = replica.solution;
+                replica.bestTimestamp = stopCriterion.elapsed();
+                replica.improvements.emplace_back(replica.bestTimestamp, replica.bestCost);
+                int known = ladderBestCost.load(std::memory_order_relaxed);
+                while (replica.cost < known && !ladderBestCost.compare_exchange_weak(known, replica.cost, std::memory_order_relaxed)) {}
+            }
+        }
+    };
+
+    auto stoppedRung = [&]() {
+        return std::find_if(stopCriteria.begin(), stopCriteria.end(), [](const StopCriterion& criterion) {
+            return criterion.getReason() != StopReason::RUNNING;
+        });
+    };
+    while (true) {
+        if (threadPool) {
+            threadPool->parallelFor(rungCount, sweep);
+        } else {
+            for (int rung = 0; rung < rungCount; ++rung) sweep(rung);
+        }
+        if (stoppedRung() != stopCriteria.end()) break;
+
+        for (int rung = firstPairs ? 0 : 1; rung + 1 < rungCount; rung += 2) {
+            TemperingReplica& colder = replicas[rung];
+            TemperingReplica& hotter = replicas[rung + 1];
+            double exponent = (1.0 / colder.temperature - 1.0 / hotter.temperature) * (colder.cost - hotter.cost);
+            ++exchangeAttempts[rung];
+            if (exponent >= 0.0 || exchangeGenerator.uniform() < std::exp(exponent)) {
+                std::swap(colder.solution, hotter.solution);
+                std::swap(colder.positions, hotter.positions);
+                std::swap(colder.cost, hotter.cost);
+                ++exchangeAccepts[rung];
             }
+        }
+        firstPairs = !firstPairs;
+    }
+    const double duration = stopCriteria[0].elapsed();
 
-            newCost = calculateCost(newSolution, graph, graphSize);
-            time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
-            temp *= coolingFactor;
-            expo = exp((currentCost - newCost) / temp);
+    // A rung that reached the target stopped the whole ladder, the other reasons are shared by all rungs
+    stopReason = stoppedRung()->getReason();
+    for (const StopCriterion& criterion : stopCriteria) {
+        if (criterion.getReason() == StopReason::TARGET_REACHED) stopReason = StopReason::TARGET_REACHED;
+    }
 
-        } while(newCost >= currentCost || expo <= 0.9);
+    int bestRung = 0;
+    std::vector<std::pair<double, int>> events;
+    for (int rung = 0; rung < rungCount; ++rung) {
+        const TemperingReplica& replica = replicas[rung];
+        proposalCount += replica.proposals;
+        events.insert(events.end(), replica.improvements.begin(), replica.improvements.end());
+        if (replica.bestCost < replicas[bestRung].bestCost) bestRung = rung;
+        if (!verbose) continue;
+
+        std::cout << "Rung " << rung << ": T = " << replica.temperature
+                  << ", move acceptance " << (replica.proposals ? 100.0 * replica.accepted / replica.proposals : 0.0) << "%";
+        if (rung + 1 < rungCount) {
+            std::cout << ", exchange acceptance with rung " << rung + 1 << " "
+                      << (exchangeAttempts[rung] ? 100.0 * exchangeAccepts[rung] / exchangeAttempts[rung] : 0.0) << "%";
+        }
+        std::cout << std::endl;
+    }
+    if (verbose) {
+        std::cout << "Proposals evaluated: " << proposalCount << " (" << proposalCount / std::max(duration, 1e-9) << " per second)" << std::endl;
+        std::cout << "Stopped by: " << StopCriterion::reasonName(stopReason) << std::endl;
+    }
 
-        if (newCost < bestCost) {
-            bestSolution = newSolution;
-            bestCost = newCost;
-            bestSolutionTimestamp = time;
+    bestSolution = std::move(replicas[bestRung].bestSolution);
+    bestCost = replicas[bestRung].bestCost;
+    bestSolutionTimestamp = replicas[bestRung].bestTimestamp;
+    improvementHistory = mergeImprovements(std::move(events));
+    if (localSearch) {
+        int improvement = localSearch->optimize(bestSolution);
+        if (improvement > 0) {
+            bestCost -= improvement;
+            improvementHistory.emplace_back(stopCriteria[0].elapsed(), bestCost);
         }
+    }
+    bestSolution.push_back(bestSolution.front());
+}
 
-        currentSolution = newSolution;
+/**
+ * Publishes a solution if it beats the global best. The cost is checked lock-free first,
+ * so the mutex is only taken for actual improvements.
+ * @param solution - The candidate solution.
+ * @param cost - Its cost.
+ */
+void SimulatedAnnealing::SharedBest::publish(const std::vector<int>& solution, int cost) {
+    int known = bestCost.load(std::memory_order_relaxed);
+    while (cost < known) {
+        if (bestCost.compare_exchange_weak(known, cost, std::memory_order_acq_rel)) {
+            std::lock_guard<std::mutex> lock(solutionMutex);
+            if (cost < solutionCost) {
+                bestSolution = solution;
+                solutionCost = cost;
+            }
+            return;
+        }
     }
 }
+
+/**
+ * Replaces the given solution with the global best if that is strictly better.
+ * @param solution - The chain's current solution, overwritten on success.
+ * @param cost - Its cost, overwritten on success.
+ * @return True if the solution was replaced.
+ */
+bool SimulatedAnnealing::SharedBest::fetchIfBetter(std::vector<int>& solution, int& cost) {
+    if (bestCost.load(std::memory_order_acquire) >= cost) return false;
+    std::lock_guard<std::mutex> lock(solutionMutex);
+    if (solutionCost >= cost) return false;
+    solution = bestSolution;
+    cost = solutionCost;
+    return true;
+}
@@ -0,0 +1,115 @@
+#include "../headers/StopCriterion.h"
+
+#include <algorithm>
+
+// Constructor
+StopCriterion::StopCriterion(const StopLimits& limits, std::atomic<bool>* flag)
+    : limits(limits), startTime(Clock::now()), cancelFlag(flag), nextCheck(0), nextClockCheck(0), checkPeriod(1),
+      lastClockIteration(0), lastImprovement(0), lastElapsed(0.0), clockReads(0), reason(StopReason::RUNNING) {}
+
+// Start the run at iteration 0
+void StopCriterion::start(Clock::time_point start) {
+    startTime = start;
+    checkPeriod = 1;
+    nextClockCheck = 1;
+    lastClockIteration = 0;
+    lastImprovement = 0;
+    lastElapsed = elapsed();
+    clockReads = 1;
+    reason = StopReason::RUNNING;
+    // A search started after the common deadline stops at its first check
+    if (lastElapsed >= limits.seconds) {
+        reason = StopReason::TIME_LIMIT;
+        nextCheck = 0;
+        return;
+    }
+    scheduleNextCheck();
+}
+
+// Evaluate the limits, reading the clock when its period is over
+bool StopCriterion::check(long long iteration) {
+    if (reason != StopReason::RUNNING) return true;
+
+    if (limits.iterations > 0 && iteration >= limits.iterations) {
+        reason = StopReason::ITERATION_LIMIT;
+    } else if (limits.stallIterations > 0 && iteration - lastImprovement >= limits.stallIterations) {
+        reason = StopReason::STALLED;
+    } else if (iteration >= nextClockCheck) {
+        const double now = elapsed();
+        ++clockReads;
+
+        // Aim at CHECK_INTERVAL between reads, at most halving or doubling the period
+        const double interval = now - lastElapsed;
+        const double ideal = interval > 0.0 ? (iteration - lastClockIteration) * CHECK_INTERVAL / interval : 2.0 * checkPeriod;
+        const double lowest = std::max(1LL, checkPeriod / 2);
+        const double highest = std::min(MAX_CHECK_PERIOD, 2 * checkPeriod);
+        checkPeriod = static_cast<long long>(std::clamp(ideal, lowest, highest));
+        lastElapsed = now;
+        lastClockIteration = iteration;
+        nextClockCheck = iteration + checkPeriod;
+
+        if (now >= limits.seconds) reason = StopReason::TIME_LIMIT;
+        else if (cancelFlag && cancelFlag->load(std::memory_order_relaxed)) reason = StopReason::CANCELLED;
+    }
+
+    if (reason != StopReason::RUNNING) return true;
+    scheduleNextCheck();
+    return false;
+}
+
+// First iteration at which a limit or the clock has to be looked at
+void StopCriterion::scheduleNextCheck() {
+    nextCheck = nextClockCheck;
+    if (limits.iterations > 0) nextCheck = std::min(nextCheck, limits.iterations);
+    if (limits.stallIterations > 0) nextCheck = std::min(nextCheck, lastImprovement + limits.stallIterations);
+}
+
+// Restart the no-improvement window and test the target
+void StopCriterion::recordImprovement(long long iteration, long long cost) {
+    lastImprovement = iteration;
+    if (limits.targetCost != StopLimits::NO_TARGET && cost <= limits.targetCost) {
+        reason = StopReason::TARGET_REACHED;
+        if (cancelFlag) cancelFlag->store(true, std::memory_order_relaxed);
+        nextCheck = iteration;
+        return;
+    }
+    if (reason == StopReason::RUNNING) scheduleNextCheck();
+}
+
+// Read the clock
+double StopCriterion::elapsed() const {
+    return std::chrono::duration<double>(Clock::now() - startTime).count();
+}
+
+// Get the time of the last clock read
+double StopCriterion::getLastElapsed() const {
+    return lastElapsed;
+}
+
+// Get why the run stopped
+StopReason StopCriterion::getReason() const {
+    return reason;
+}
+
+// Get the iterations between clock reads
+long long StopCriterion::getCheckPeriod() const {
+    return checkPeriod;
+}
+
+// Get the number of clock reads
+long long StopCriterion::getClockReads() const {
+    return clockReads;
+}
+
+// Description of a stop reason
+std::string StopCriterion::reasonName(StopReason reason) {
+    switch (reason) {
+        case StopReason::RUNNING: return "running";
+        case StopReason::TIME_LIMIT: return "time limit";
+        case StopReason::ITERATION_LIMIT: return "iteration limit";
+        case StopReason::STALLED: return "no improvement";
+        case StopReason::TARGET_REACHED: return "target cost reached";
+        case StopReason::CANCELLED: return "cancelled";
+    }
+    return "running";
+}
@@ -0,0 +1,234 @@
+#include "../headers/TabuMemory.h"
+#include "../headers/RandomGenerator.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Fixed seed of the arc keys, fingerprints only need to be well mixed, not secret
+constexpr std::uint64_t ZOBRIST_SEED = 0x7AB0F1A9E2C4D3B5ULL;
+
+}
+
+// Constructor
+TabuMemory::TabuMemory(int cities, TabuAttribute attribute, int tenure)
+    : citiesCount(std::max(0, cities)), attribute(attribute), fixedTenure(std::max(REACTIVE_TENURE, tenure)),
+      maxTenure(std::max(MIN_TENURE, citiesCount / 2)), fingerprint(0), meanCycleLength(citiesCount), lastTenureChange(0),
+      repetitionCount(0) {
+    tenure = initialTenure();
+
+    std::size_t arcSlots = 16;
+    while (arcSlots < 4 * static_cast<std::size_t>(citiesCount)) arcSlots <<= 1;
+    if (attribute == TabuAttribute::ARC) arcTable.resize(arcSlots);
+    else positionExpiry.assign(citiesCount, 0);
+
+    RandomGenerator generator(ZOBRIST_SEED);
+    tailKeys.resize(citiesCount);
+    headKeys.resize(citiesCount);
+    for (int city = 0; city < citiesCount; ++city) {
+        tailKeys[city] = generator();
+        headKeys[city] = generator();
+    }
+    historyFingerprints.assign(HISTORY_CAPACITY, 0);
+    historyIterations.assign(HISTORY_CAPACITY, -1);
+}
+
+// Key of an arc: the city words combined by the SplitMix64 finaliser
+std::uint64_t TabuMemory::arcKey(int from, int to) const {
+    std::uint64_t key = tailKeys[from] ^ headKeys[to];
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+    return key ^ (key >> 31);
+}
+
+// Arcs removed and added by a move, the same cases as MoveEvaluator::delta()
+int TabuMemory::moveArcs(const std::vector<int>& tour, const Move& move, int removed[][2], int added[][2]) {
+    const int size = tour.size();
+    auto setArcs = [](int arcs[][2], int index, int from, int to) {
+        arcs[index][0] = from;
+        arcs[index][1] = to;
+    };
+
+    if (move.type == MoveType::SEGMENT_EXCHANGE) {
+        int a = tour[move.first],  b = tour[move.first + 1];
+        int c = tour[move.second], d = tour[move.second + 1];
+        int e = tour[move.third],  f = tour[(move.third + 1) % size];
+        setArcs(removed, 0, a, b); setArcs(removed, 1, c, d); setArcs(removed, 2, e, f);
+        setArcs(added, 0, a, d);   setArcs(added, 1, e, b);   setArcs(added, 2, c, f);
+        return 3;
+    }
+
+    int i = move.first, j = move.second;
+    if (size <= 2) return 0;
+
+    int x = tour[i], y = tour[j];
+    if (j == i + 1) {
+        int p = tour[(i - 1 + size) % size], n = tour[(j + 1) % size];
+        setArcs(removed, 0, p, x); setArcs(removed, 1, x, y); setArcs(removed, 2, y, n);
+        setArcs(added, 0, p, y);   setArcs(added, 1, y, x);   setArcs(added, 2, x, n);
+        return 3;
+    }
+    if (i == 0 && j == size - 1) {
+        int p = tour[size - 2], n = tour[1];
+        setArcs(removed, 0, p, y); setArcs(removed, 1, y, x); setArcs(removed, 2, x, n);
+        setArcs(added, 0, p, x);   setArcs(added, 1, x, y);   setArcs(added, 2, y, n);
+        return 3;
+    }
+
+    int prevI = tour[(i - 1 + size) % size], nextI = tour[i + 1];
+    int prevJ = tour[j - 1], nextJ = tour[(j + 1) % size];
+    setArcs(removed, 0, prevI, x); setArcs(removed, 1, x, nextI); setArcs(removed, 2, prevJ, y); setArcs(removed, 3, y, nextJ);
+    setArcs(added, 0, prevI, y);   setArcs(added, 1, y, nextI);   setArcs(added, 2, prevJ, x);   setArcs(added, 3, x, nextJ);
+    return 4;
+}
+
+// A move is identified by its first position and its last modified position
+int TabuMemory::lastPosition(const Move& move) {
+    return move.type == MoveType::SWAP ? move.second : move.third;
+}
+
+// Fixed tenure, or a quarter of the cities to start the reactive one
+int TabuMemory::initialTenure() const {
+    return fixedTenure != REACTIVE_TENURE ? fixedTenure : std::clamp(citiesCount / 4, MIN_TENURE, maxTenure);
+}
+
+// Current tenure, rounded
+int TabuMemory::tenureIterations() const {
+    return static_cast<int>(tenure + 0.5);
+}
+
+// Forget all tenures and returns
+void TabuMemory::reset(const std::vector<int>& tour) {
+    std::fill(positionExpiry.begin(), positionExpiry.end(), 0);
+    std::fill(arcTable.begin(), arcTable.end(), ArcTenure{});
+    std::fill(historyIterations.begin(), historyIterations.end(), -1);
+    tenure = initialTenure();
+    meanCycleLength = citiesCount;
+    lastTenureChange = 0;
+    repetitionCount = 0;
+    setTour(tour);
+}
+
+// Fingerprint of a replaced tour
+void TabuMemory::setTour(const std::vector<int>& tour) {
+    fingerprint = computeFingerprint(tour);
+}
+
+// Check the attributes of a move
+bool TabuMemory::isTabu(const std::vector<int>& tour, const Move& move, int iteration) const {
+    if (attribute == TabuAttribute::POSITION) {
+        return positionExpiry[move.first] > iteration && positionExpiry[lastPosition(move)] > iteration;
+    }
+
+    int removed[4][2];
+    int added[4][2];
+    const int arcCount = moveArcs(tour, move, removed, added);
+    const std::size_t mask = arcTable.size() - 1;
+    for (int arc = 0; arc < arcCount; ++arc) {
+        const std::size_t home = arcKey(added[arc][0], added[arc][1]) & mask;
+        for (int probe = 0; probe < ARC_PROBES; ++probe) {
+            const ArcTenure& entry = arcTable[(home + probe) & mask];
+            if (entry.from == added[arc][0] && entry.to == added[arc][1]) {
+                if (entry.expiry > iteration) return true;
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+// Forbid the attributes of an applied move and update the fingerprint
+void TabuMemory::recordMove(const std::vector<int>& tour, const Move& move, int iteration) {
+    int removed[4][2];
+    int added[4][2];
+    const int arcCount = moveArcs(tour, move, removed, added);
+    for (int arc = 0; arc < arcCount; ++arc) {
+        fingerprint ^= arcKey(removed[arc][0], removed[arc][1]) ^ arcKey(added[arc][0], added[arc][1]);
+    }
+
+    const int expiry = iteration + tenureIterations();
+    if (attribute == TabuAttribute::POSITION) {
+        positionExpiry[move.first] = expiry;
+        positionExpiry[lastPosition(move)] = expiry;
+        return;
+    }
+
+    // Removed arcs may not come back; an arc takes its own slot, a free one or the one expiring first
+    const std::size_t mask = arcTable.size() - 1;
+    for (int arc = 0; arc < arcCount; ++arc) {
+        const int from = removed[arc][0];
+        const int to = removed[arc][1];
+        const std::size_t home = arcKey(from, to) & mask;
+        std::size_t target = home;
+        for (int probe = 0; probe < ARC_PROBES; ++probe) {
+            const std::size_t slot = (home + probe) & mask;
+            const ArcTenure& entry = arcTable[slot];
+            if (entry.from == from && entry.to == to) {
+                target = slot;
+                break;
+            }
+            if (entry.expiry < arcTable[target].expiry) target = slot;
+        }
+        arcTable[target] = ArcTenure{from, to, expiry};
+    }
+}
+
+// Detect returns to earlier tours and adapt the reactive tenure
+bool TabuMemory::registerVisit(int iteration) {
+    const std::size_t slot = fingerprint & (HISTORY_CAPACITY - 1);
+    const bool repeated = historyIterations[slot] >= 0 && historyFingerprints[slot] == fingerprint;
+
+    if (repeated) {
+        ++repetitionCount;
+        meanCycleLength = 0.9 * meanCycleLength + 0.1 * (iteration - historyIterations[slot]);
+        if (fixedTenure == REACTIVE_TENURE) {
+            tenure = std::min<double>(maxTenure, tenure * 1.1 + 1.0);
+            lastTenureChange = iteration;
+        }
+    } else if (fixedTenure == REACTIVE_TENURE && iteration - lastTenureChange > 2.0 * meanCycleLength) {
+        tenure = std::max<double>(MIN_TENURE, tenure * 0.9);
+        lastTenureChange = iteration;
+    }
+
+    historyFingerprints[slot] = fingerprint;
+    historyIterations[slot] = iteration;
+    return repeated;
+}
+
+// Get the fingerprint of the current tour
+std::uint64_t TabuMemory::getFingerprint() const {
+    return fingerprint;
+}
+
+// Get the current tenure
+int TabuMemory::getTenure() const {
+    return tenureIterations();
+}
+
+// Get the number of returns to earlier tours
+long long TabuMemory::getRepetitionCount() const {
+    return repetitionCount;
+}
+
+// XOR of the keys of all arcs of a tour
+std::uint64_t TabuMemory::computeFingerprint(const std::vector<int>& tour) const {
+    const int size = tour.size();
+    std::uint64_t result = 0;
+    for (int position = 0; position < size; ++position) {
+        result ^= arcKey(tour[position], tour[(position + 1) % size]);
+    }
+    return result;
+}
+
+// Parse an attribute name
+TabuAttribute TabuMemory::parseAttribute(const std::string& name) {
+    if (name == "position") return TabuAttribute::POSITION;
+    if (name == "arc") return TabuAttribute::ARC;
+    throw std::invalid_argument("Error: Unknown tabu attribute '" + name + "'.");
+}
+
+// Short name of an attribute
+std::string TabuMemory::attributeName(TabuAttribute attribute) {
+    return attribute == TabuAttribute::POSITION ? "position" : "arc";
+}
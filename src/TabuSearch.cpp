@@ -1,118 +1,406 @@
 #include "../headers/TabuSearch.h"
+#include "../headers/TourKernels.h"
+#include "../headers/GreedyAlgorithm.h"
 
 #include <algorithm>
 #include <fstream>
-#include <random>
-#include <chrono>
-#include <unordered_set>
 #include <numeric>
+#include <limits>
+#include <stdexcept>
 
 // Constructor
-TabuSearch::TabuSearch(const std::vector<std::vector<int>>& matrix, int tabuLimit, double maxDuration) 
-    : distanceMatrix(matrix), tabuLimit(tabuLimit), maxDuration(maxDuration) {
+TabuSearch::TabuSearch(std::shared_ptr<const DistanceMatrix> matrix, int tenure, double maxDuration, ThreadPool* pool,
+                       const std::vector<NeighborhoodType>& neighborhoodTypes, std::shared_ptr<const CandidateList> candidates) 
+    : distanceMatrix(std::move(matrix)), moveEvaluator(*distanceMatrix), tabuTenure(std::max(TabuMemory::REACTIVE_TENURE, tenure)),
+      tabuAttribute(TabuAttribute::ARC), tabuMemory(distanceMatrix->size(), tabuAttribute, tabuTenure), cancelFlag(nullptr), stopReason(StopReason::RUNNING), threadPool(pool),
+      candidateList(std::move(candidates)), neighborhoods(Neighborhood::createAll(neighborhoodTypes, candidateList.get())) {
+    if (neighborhoods.empty()) {
+        neighborhoods = Neighborhood::createAll({NeighborhoodType::SWAP}, candidateList.get());
+    }
+    stopLimits.seconds = maxDuration;
     optimalCost = std::numeric_limits<int>::max();
     currentSolutionCost = 0;
     iterationCounter = 0;
     noImprovementCount = 0;
     bestSolutionTimestamp = 0.0;
+    runDuration = 0.0;
+    localSearchPeriod = 0.0;
+    seed = RandomGenerator::randomSeed();
+    constructedStart = false;
+    construction = ConstructionType::NEAREST_NEIGHBOR;
+    elitePool = nullptr;
+    stagnationPeriod = 0.0;
+    reactive = false;
+    stagnationIterations = 0;
+    phase = TabuPhase::SEARCH;
+    phaseBestCost = 0;
+    phaseStatistics.resize(3);
+    aspirationCount = 0;
 
-    currentSolution.resize(matrix.size());
-    optimalSolution.resize(matrix.size());
+    currentSolution.resize(distanceMatrix->size());
+    optimalSolution.resize(distanceMatrix->size());
 }
 
 // Calculate the cost of a tour
 int TabuSearch::computeSolutionCost(const std::vector<int>& solution) const {
-    int cost = 0;
+    return TourKernels::cycleCost(*distanceMatrix, solution.data(), solution.size());
+}
+
+// Calculate the delta change for swapping two cities
+int TabuSearch::computeSwapDelta(const std::vector<int>& solution, int i, int j) const {
+    return moveEvaluator.delta(solution, MoveEvaluator::swap(i, j));
+}
+
+// Find the best admissible move of one block
+TabuSearch::NeighborCandidate TabuSearch::evaluateNeighbors(const ScanBlock& block) const {
+    NeighborCandidate best{MoveEvaluator::swap(0, 1), std::numeric_limits<int>::max(), false, false, 0};
 
-    for (size_t i = 0; i < solution.size() - 1; ++i) {
-        cost += distanceMatrix[solution[i]][solution[i + 1]];
+    const Neighborhood& neighborhood = *neighborhoods[block.neighborhood];
+    // A tabu move is admitted if it leads to a new best tour
+    const long long aspirationDelta = static_cast<long long>(optimalCost) - currentSolutionCost;
+
+    long long evaluations = 0;
+
+    // The full swap neighbourhood is scored a whole row at a time by the vector kernels
+    if (neighborhood.getType() == NeighborhoodType::SWAP && !candidateList) {
+        const int size = currentSolution.size();
+        std::vector<int> rowDeltas(size);
+        for (int i = block.firstRow; i < block.lastRow; ++i) {
+            moveEvaluator.swapRowDeltas(currentSolution, arcWeights, i, rowDeltas.data());
+            for (int j = i + 1; j < size; ++j) {
+                const int delta = rowDeltas[j - i - 1];
+                if (delta < best.delta) {
+                    const bool tabu = isTabu(MoveEvaluator::swap(i, j));
+                    if (!tabu || delta < aspirationDelta) {
+                        best = NeighborCandidate{MoveEvaluator::swap(i, j), delta, true, tabu, 0};
+                    }
+                }
+            }
+            evaluations += size - i - 1;
+        }
+        best.evaluations = evaluations;
+        return best;
     }
 
-    cost += distanceMatrix[solution.back()][solution[0]]; // Return to starting node
-    return cost;
+    neighborhood.forEachMove(currentSolution, positions, block.firstRow, block.lastRow, [this, &best, &evaluations, aspirationDelta](const Move& move) {
+        int delta = moveEvaluator.delta(currentSolution, move);
+        ++evaluations;
+
+        if (delta < best.delta) {
+            const bool tabu = isTabu(move);
+            if (!tabu || delta < aspirationDelta) {
+                best = NeighborCandidate{move, delta, true, tabu, 0};
+            }
+        }
+    });
+    best.evaluations = evaluations;
+    return best;
 }
 
-// Calculate the delta change for swapping two cities
-int TabuSearch::computeSwapDelta(const std::vector<int>& solution, int i, int j) const {
-    int size = solution.size();
-    int prevI = (i - 1 + size) % size, nextI = (i + 1) % size;
-    int prevJ = (j - 1 + size) % size, nextJ = (j + 1) % size;
+// Strictly lower delta wins, ties keep the earlier move
+bool TabuSearch::isBetterCandidate(const NeighborCandidate& candidate, const NeighborCandidate& incumbent) {
+    if (!candidate.found) return false;
+    if (!incumbent.found) return true;
+    return candidate.delta < incumbent.delta;
+}
+
+// Ask the tabu memory about the current tour
+bool TabuSearch::isTabu(const Move& move) const {
+    return tabuMemory.isTabu(currentSolution, move, iterationCounter);
+}
 
-    int delta = 0;
-    if (prevI != j && nextI != j) {
-        delta -= distanceMatrix[solution[prevI]][solution[i]] + distanceMatrix[solution[i]][solution[nextI]];
-        delta += distanceMatrix[solution[prevI]][solution[j]] + distanceMatrix[solution[j]][solution[nextI]];
+// Scan the whole neighbourhood, block by block
+TabuSearch::NeighborCandidate TabuSearch::findBestNeighbor() {
+    const int blockCount = scanBlocks.size();
+    std::vector<NeighborCandidate> blockResults(blockCount);
+    moveEvaluator.computeArcWeights(currentSolution, arcWeights);
 
-        delta -= distanceMatrix[solution[prevJ]][solution[j]] + distanceMatrix[solution[j]][solution[nextJ]];
-        delta += distanceMatrix[solution[prevJ]][solution[i]] + distanceMatrix[solution[i]][solution[nextJ]];
+    if (!threadPool || threadPool->size() <= 1 || blockCount <= 1) {
+        for (int block = 0; block < blockCount; ++block) {
+            blockResults[block] = evaluateNeighbors(scanBlocks[block]);
+        }
     } else {
-        delta -= distanceMatrix[solution[prevI]][solution[i]] + distanceMatrix[solution[i]][solution[j]] + distanceMatrix[solution[j]][solution[nextJ]];
-        delta += distanceMatrix[solution[prevI]][solution[j]] + distanceMatrix[solution[j]][solution[i]] + distanceMatrix[solution[i]][solution[nextJ]];
+        threadPool->parallelFor(blockCount, [this, &blockResults](int block) {
+            blockResults[block] = evaluateNeighbors(scanBlocks[block]);
+        });
+    }
+
+    NeighborCandidate best{MoveEvaluator::swap(0, 1), std::numeric_limits<int>::max(), false, false, 0};
+    long long evaluations = 0;
+    for (const NeighborCandidate& candidate : blockResults) {
+        if (isBetterCandidate(candidate, best)) best = candidate;
+        evaluations += candidate.evaluations;
+    }
+    best.evaluations = evaluations;
+    return best;
+}
+
+// Split the rows of every neighbourhood into blocks with similar move counts
+void TabuSearch::computeScanBlocks(int size) {
+    const int targetBlocks = threadPool ? 4 * (threadPool->size() + 1) : 1;
+
+    scanBlocks.clear();
+    for (int index = 0; index < static_cast<int>(neighborhoods.size()); ++index) {
+        const Neighborhood& neighborhood = *neighborhoods[index];
+
+        long long totalMoves = 0;
+        for (int row = 0; row < size; ++row) {
+            totalMoves += neighborhood.countMovesInRow(size, row);
+        }
+        const long long movesPerBlock = std::max(1LL, totalMoves / targetBlocks);
+
+        int firstRow = 0;
+        long long movesInBlock = 0;
+        for (int row = 0; row < size; ++row) {
+            movesInBlock += neighborhood.countMovesInRow(size, row);
+            if (movesInBlock >= movesPerBlock || row + 1 == size) {
+                scanBlocks.push_back(ScanBlock{index, firstRow, row + 1});
+                firstRow = row + 1;
+                movesInBlock = 0;
+            }
+        }
     }
-    return delta;
 }
 
 // Generate random permutation
-std::vector<int> TabuSearch::generateRandomSolution(int size) const {
+std::vector<int> TabuSearch::generateRandomSolution(int size) {
     std::vector<int> permutation(size);
     std::iota(permutation.begin(), permutation.end(), 0);
-    std::shuffle(permutation.begin(), permutation.end(), std::mt19937(std::random_device{}()));
+    generator.shuffle(permutation.begin(), permutation.end());
     return permutation;
 }
 
+// Restart from a randomized greedy tour of a random start city
+void TabuSearch::initializeRandomizedGreedySolution() {
+    const int size = distanceMatrix->size();
+    GreedyAlgorithm greedySolver(distanceMatrix);
+    currentSolution = greedySolver.solveRandomizedFromCity(generator.below(size), generator);
+    currentSolution.pop_back(); // The search works on open tours
+    currentSolutionCost = computeSolutionCost(currentSolution);
+    MoveEvaluator::computePositions(currentSolution, positions);
+    tabuMemory.setTour(currentSolution);
+}
+
+// Shuffle a random segment of about a tenth of the tour
+void TabuSearch::diversifyWithPartialShuffle() {
+    const int size = currentSolution.size();
+    if (size < 4) return;
+    const int length = std::clamp(size / 10, 3, size);
+    const int start = generator.below(size - length + 1);
+    generator.shuffle(currentSolution.begin() + start, currentSolution.begin() + start + length);
+    currentSolutionCost = computeSolutionCost(currentSolution);
+    MoveEvaluator::computePositions(currentSolution, positions);
+    tabuMemory.setTour(currentSolution);
+}
+
+// A B C D -> A C B D with random cut points
+void TabuSearch::diversifyWithDoubleBridge() {
+    const int size = currentSolution.size();
+    if (size < 4) return;
+    const int first = 1 + generator.below(size - 3);
+    const int second = first + 1 + generator.below(size - 2 - first);
+    const int third = second + 1 + generator.below(size - 1 - second);
+    std::rotate(currentSolution.begin() + first, currentSolution.begin() + second, currentSolution.begin() + third);
+    currentSolutionCost = computeSolutionCost(currentSolution);
+    MoveEvaluator::computePositions(currentSolution, positions);
+    tabuMemory.setTour(currentSolution);
+}
+
+// Store the phase's best tour and continue from an elite or a perturbed tour
+void TabuSearch::changePhase(bool forceDiversification) {
+    phaseElite->publish(phaseBestTour, phaseBestCost);
+
+    int eliteCost;
+    if (!forceDiversification && phase != TabuPhase::INTENSIFICATION && phaseElite->sample(generator, currentSolution, eliteCost)) {
+        phase = TabuPhase::INTENSIFICATION;
+        currentSolutionCost = eliteCost;
+        MoveEvaluator::computePositions(currentSolution, positions);
+        tabuMemory.setTour(currentSolution);
+    } else {
+        phase = TabuPhase::DIVERSIFICATION;
+        if (generator.below(2) == 0) {
+            diversifyWithDoubleBridge();
+        } else {
+            diversifyWithPartialShuffle();
+        }
+    }
+
+    ++phaseStatistics[static_cast<int>(phase)].entries;
+    phaseBestTour = currentSolution;
+    phaseBestCost = currentSolutionCost;
+    noImprovementCount = 0;
+}
+
 // Solve using Tabu Search
 void TabuSearch::solve() {
-    const int size = distanceMatrix.size();
-    std::vector<std::vector<int>> tabuMatrix(size, std::vector<int>(size, 0));
+    const int size = distanceMatrix->size();
+    computeScanBlocks(size);
 
-    currentSolution = generateRandomSolution(size);
+    generator = RandomGenerator(seed);
+    if (static_cast<int>(startTour.size()) == size + 1 && size > 0) {
+        currentSolution = startTour;
+        currentSolution.pop_back(); // The search works on open tours
+    } else if (constructedStart && size > 0) {
+        currentSolution = ConstructionHeuristic::create(construction, distanceMatrix, threadPool)->build();
+        currentSolution.pop_back(); // The search works on open tours
+    } else {
+        currentSolution = generateRandomSolution(size);
+    }
     currentSolutionCost = computeSolutionCost(currentSolution);
+    MoveEvaluator::computePositions(currentSolution, positions);
     optimalSolution = currentSolution;
-    optimalCost = computeSolutionCost(currentSolution); 
+    optimalCost = currentSolutionCost;
+    iterationCounter = 0;
+    tabuMemory = TabuMemory(size, tabuAttribute, tabuTenure);
+    tabuMemory.reset(currentSolution);
+    improvementHistory.assign(1, {0.0, optimalCost});
 
-    auto startTime = std::chrono::high_resolution_clock::now();
+    phase = TabuPhase::SEARCH;
+    phaseStatistics.assign(3, PhaseStatistics{});
+    phaseStatistics[static_cast<int>(TabuPhase::SEARCH)].entries = 1;
+    phaseBestTour = currentSolution;
+    phaseBestCost = currentSolutionCost;
+    phaseElite = reactive ? std::make_unique<ElitePool>(ELITE_TOURS, size) : nullptr;
+    noImprovementCount = 0;
+    aspirationCount = 0;
+    const int stagnationLimit = stagnationIterations > 0 ? stagnationIterations : 2 * size;
 
-    while (true) {
-        int bestNeighborCost = std::numeric_limits<int>::max();
-        std::vector<int> bestNeighbor = currentSolution;
-        int swapX = -1, swapY = -1;
+    StopCriterion stopCriterion(stopLimits, cancelFlag);
+    stopCriterion.start(stopLimits.runStart());
+    stopCriterion.recordImprovement(0, optimalCost); // The start tour may already meet the target
+    double lastIterationTime = stopCriterion.getLastElapsed();
+    double nextLocalSearchTime = lastIterationTime + localSearchPeriod;
+    double lastImprovementTime = lastIterationTime;
+    if (elitePool) elitePool->publish(optimalSolution, optimalCost);
 
-        for (int i = 0; i < size; ++i) {
-            for (int j = i + 1; j < size; ++j) {
-                int delta = computeSwapDelta(currentSolution, i, j);
-                int neighborCost = currentSolutionCost + delta;
-
-                if (neighborCost < bestNeighborCost && tabuMatrix[i][j] <= iterationCounter) {
-                    bestNeighborCost = neighborCost;
-                    bestNeighbor = currentSolution;
-                    swapX = i;
-                    swapY = j;
-                }
-            }
-        }
+    while (true) {
+        NeighborCandidate bestNeighbor = findBestNeighbor();
+        PhaseStatistics& statistics = phaseStatistics[static_cast<int>(phase)];
+        statistics.evaluations += bestNeighbor.evaluations;
+        ++statistics.iterations;
 
-        if (swapX != -1 && swapY != -1) {
-            std::swap(bestNeighbor[swapX], bestNeighbor[swapY]);
-            tabuMatrix[swapX][swapY] = iterationCounter + size;
+        if (bestNeighbor.found) {
+            if (bestNeighbor.aspirated) ++aspirationCount;
+            tabuMemory.recordMove(currentSolution, bestNeighbor.move, iterationCounter);
+            moveEvaluator.apply(currentSolution, positions, bestNeighbor.move);
+            currentSolutionCost += bestNeighbor.delta;
+            tabuMemory.registerVisit(iterationCounter);
+        } else if (reactive) {
+            // Every move is tabu, perturb instead of throwing the tour away
+            changePhase(true);
         } else {
-            bestNeighbor = generateRandomSolution(size); 
+            initializeRandomizedGreedySolution();
         }
 
-        currentSolution = bestNeighbor;
-        currentSolutionCost = computeSolutionCost(currentSolution); 
+        iterationCounter++;
+
+        // Time of the last clock read, the clock is only read every few iterations
+        const double elapsedTime = stopCriterion.getLastElapsed();
+        statistics.seconds += elapsedTime - lastIterationTime;
+        lastIterationTime = elapsedTime;
+
+        if (localSearch && localSearchPeriod > 0.0 && elapsedTime >= nextLocalSearchTime) {
+            nextLocalSearchTime = elapsedTime + localSearchPeriod;
+            int improvement = localSearch->optimize(currentSolution);
+            if (improvement > 0) {
+                currentSolutionCost -= improvement;
+                MoveEvaluator::computePositions(currentSolution, positions);
+                tabuMemory.setTour(currentSolution);
+            }
+        }
 
         if (currentSolutionCost < optimalCost) {
             optimalCost = currentSolutionCost;
             optimalSolution = currentSolution;
-            bestSolutionTimestamp = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+            bestSolutionTimestamp = stopCriterion.elapsed();
+            improvementHistory.emplace_back(bestSolutionTimestamp, optimalCost);
+            lastImprovementTime = elapsedTime;
+            ++statistics.improvements;
+            stopCriterion.recordImprovement(iterationCounter, optimalCost);
+            if (elitePool) elitePool->publish(optimalSolution, optimalCost);
         }
 
-        iterationCounter++;
+        if (reactive) {
+            if (currentSolutionCost < phaseBestCost) {
+                phaseBestCost = currentSolutionCost;
+                phaseBestTour = currentSolution;
+                noImprovementCount = 0;
+            } else if (++noImprovementCount >= stagnationLimit) {
+                changePhase(false);
+            }
+        }
+
+        // Stagnating, continue from one of the best tours of all cooperating solvers
+        if (elitePool && elapsedTime - lastImprovementTime >= stagnationPeriod) {
+            lastImprovementTime = elapsedTime;
+            int eliteCost;
+            if (elitePool->sample(generator, currentSolution, eliteCost)) {
+                currentSolutionCost = eliteCost;
+                MoveEvaluator::computePositions(currentSolution, positions);
+                tabuMemory.setTour(currentSolution);
+            }
+        }
 
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        double elapsedTime = std::chrono::duration<double>(currentTime - startTime).count();
-        if (elapsedTime >= maxDuration) break;
+        if (stopCriterion.shouldStop(iterationCounter)) {
+            runDuration = stopCriterion.elapsed();
+            stopReason = stopCriterion.getReason();
+            break;
+        }
     }
+
+    if (localSearch) {
+        int improvement = localSearch->optimize(optimalSolution);
+        if (improvement > 0) {
+            optimalCost -= improvement;
+            improvementHistory.emplace_back(runDuration, optimalCost);
+        }
+    }
+}
+
+// Enable or disable the local search post-optimisation
+void TabuSearch::setLocalSearch(bool enabled, double periodSeconds) {
+    localSearch = enabled ? std::make_unique<LocalSearch>(*distanceMatrix, candidateList.get()) : nullptr;
+    localSearchPeriod = enabled ? std::max(0.0, periodSeconds) : 0.0;
+}
+
+// Set the limits ending a run
+void TabuSearch::setStopLimits(const StopLimits& limits, std::atomic<bool>* flag) {
+    stopLimits = limits;
+    cancelFlag = flag;
+}
+
+// Enable or disable the phases of the reactive mode
+void TabuSearch::setReactive(bool enabled, int stagnationLimit) {
+    reactive = enabled;
+    stagnationIterations = std::max(0, stagnationLimit);
+}
+
+// Configure the tabu memory
+void TabuSearch::setTabuMemory(TabuAttribute attribute, int tenure) {
+    tabuAttribute = attribute;
+    tabuTenure = std::max(TabuMemory::REACTIVE_TENURE, tenure);
+}
+
+// Set the seed of the run
+void TabuSearch::setSeed(std::uint64_t value) {
+    seed = value;
+}
+
+// Start from a constructed tour
+void TabuSearch::setConstruction(ConstructionType type) {
+    constructedStart = true;
+    construction = type;
+}
+
+// Start from a given tour
+void TabuSearch::setStartTour(const std::vector<int>& tour) {
+    startTour = tour;
+}
+
+// Cooperate through a shared elite pool
+void TabuSearch::setElitePool(ElitePool* pool, double stagnationSeconds) {
+    elitePool = pool;
+    stagnationPeriod = std::max(0.0, stagnationSeconds);
 }
 
 // Get the best tour
@@ -130,6 +418,56 @@ double TabuSearch::getBestTourTimestamp() const {
     return bestSolutionTimestamp;
 }
 
+// Get the improvements of the best tour
+std::vector<std::pair<double, int>> TabuSearch::getImprovementHistory() const {
+    return improvementHistory;
+}
+
+// Get the number of iterations of the last run
+int TabuSearch::getIterationCount() const {
+    return iterationCounter;
+}
+
+// Get the tenure at the end of the last run
+int TabuSearch::getTabuTenure() const {
+    return tabuMemory.getTenure();
+}
+
+// Get the number of returns to earlier tours
+long long TabuSearch::getRepetitionCount() const {
+    return tabuMemory.getRepetitionCount();
+}
+
+// Get the statistics of every phase
+std::vector<TabuSearch::PhaseStatistics> TabuSearch::getPhaseStatistics() const {
+    return phaseStatistics;
+}
+
+// Get the number of moves admitted by aspiration
+long long TabuSearch::getAspirationCount() const {
+    return aspirationCount;
+}
+
+// Name of a phase
+std::string TabuSearch::phaseName(TabuPhase phase) {
+    switch (phase) {
+        case TabuPhase::SEARCH: return "Search";
+        case TabuPhase::INTENSIFICATION: return "Intensification";
+        case TabuPhase::DIVERSIFICATION: return "Diversification";
+    }
+    return "Unknown";
+}
+
+// Get why the last run stopped
+StopReason TabuSearch::getStopReason() const {
+    return stopReason;
+}
+
+// Get the iteration throughput of the last run
+double TabuSearch::getIterationsPerSecond() const {
+    return runDuration > 0.0 ? iterationCounter / runDuration : 0.0;
+}
+
 // Save the results to a file
 void TabuSearch::saveResultsToFile(const std::string& fileName) const {
     std::ofstream outFile(fileName);
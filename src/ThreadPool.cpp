@@ -0,0 +1,121 @@
+#include "../headers/ThreadPool.h"
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <algorithm>
+
+namespace {
+
+/**
+ * Shared state of one parallelFor() call. Helpers keep it alive through a shared_ptr, so a helper
+ * that only starts after all blocks were claimed finds nothing to do and never touches the task.
+ */
+struct ParallelForState {
+    const std::function<void(int)>* task;
+    int blockCount;
+    std::atomic<int> nextBlock{0};
+    int finishedBlocks = 0;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable done;
+
+    void run() {
+        while (true) {
+            int block = nextBlock.fetch_add(1);
+            if (block >= blockCount) return;
+
+            std::exception_ptr blockError;
+            try {
+                (*task)(block);
+            } catch (...) {
+                blockError = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (blockError && !error) error = blockError;
+            if (++finishedBlocks == blockCount) done.notify_all();
+        }
+    }
+};
+
+}
+
+// Constructor
+ThreadPool::ThreadPool(int threadCount) : stopping(false) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+// Destructor
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// Worker main loop
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) return;
+            job = std::move(jobs.front());
+            jobs.pop();
+        }
+        job();
+    }
+}
+
+// Queue a job
+void ThreadPool::enqueue(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        jobs.push(std::move(job));
+    }
+    queueCondition.notify_one();
+}
+
+// Get the number of workers
+int ThreadPool::size() const {
+    return workers.size();
+}
+
+// Submit an independent job
+std::future<void> ThreadPool::submit(std::function<void()> job) {
+    auto packagedJob = std::make_shared<std::packaged_task<void()>>(std::move(job));
+    std::future<void> result = packagedJob->get_future();
+    enqueue([packagedJob] { (*packagedJob)(); });
+    return result;
+}
+
+// Run blocks of work on the workers and the calling thread
+void ThreadPool::parallelFor(int blockCount, const std::function<void(int)>& task) {
+    if (blockCount <= 0) return;
+
+    auto state = std::make_shared<ParallelForState>();
+    state->task = &task;
+    state->blockCount = blockCount;
+
+    int helpers = std::min(size(), blockCount - 1);
+    for (int i = 0; i < helpers; ++i) {
+        enqueue([state] { state->run(); });
+    }
+    state->run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&state] { return state->finishedBlocks == state->blockCount; });
+    if (state->error) std::rethrow_exception(state->error);
+}
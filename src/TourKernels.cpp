@@ -0,0 +1,278 @@
+#include "../headers/TourKernels.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TOUR_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Constant operands of a row of swaps (i, j): the rows and columns of the cities around position i
+struct SwapRow {
+    const int* fromPrevious; ///< Weights leaving tour[i - 1].
+    const int* fromCity;     ///< Weights leaving tour[i].
+    const int* intoNext;     ///< Weights entering tour[i + 1] (transposed copy).
+    const int* intoCity;     ///< Weights entering tour[i] (transposed copy).
+    int removed;             ///< Weight of the two arcs around tour[i].
+};
+
+using PathCostKernel = int (*)(const int* weights, int stride, const int* cities, std::size_t count);
+using ArgminKernel = int (*)(const int* row, const int* mask, int count);
+using SwapRowKernel = void (*)(const SwapRow& row, const int* tour, const int* arcWeights, int first, int last, int* out);
+
+// Kernels of one instruction set
+struct KernelTable {
+    const char* name;
+    PathCostKernel pathCost;
+    ArgminKernel maskedArgmin;
+    SwapRowKernel swapDeltas;
+};
+
+// ---------------------------------------------------------------------------
+// Scalar fallback
+// ---------------------------------------------------------------------------
+
+int pathCostScalar(const int* weights, int stride, const int* cities, std::size_t count) {
+    int cost = 0;
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+        cost += weights[static_cast<std::size_t>(cities[i]) * stride + cities[i + 1]];
+    }
+    return cost;
+}
+
+// First allowed index at the minimum, scanning from start
+int firstAtMinimum(const int* row, const int* mask, int start, int count, int minimum) {
+    for (int i = start; i < count; ++i) {
+        if (mask[i] == INT_MIN && row[i] == minimum) return i;
+    }
+    return -1;
+}
+
+int maskedArgminScalar(const int* row, const int* mask, int count) {
+    int minimum = INT_MAX;
+    for (int i = 0; i < count; ++i) {
+        minimum = std::min(minimum, std::max(row[i], mask[i]));
+    }
+    return firstAtMinimum(row, mask, 0, count, minimum);
+}
+
+// Swapping a = tour[i] with b = tour[j] replaces prev(i)->a->next(i) and prev(j)->b->next(j)
+// by prev(i)->b->next(i) and prev(j)->a->next(j)
+void swapDeltasScalar(const SwapRow& row, const int* tour, const int* arcWeights, int first, int last, int* out) {
+    for (int j = first; j < last; ++j) {
+        const int added = row.fromPrevious[tour[j]] + row.intoNext[tour[j]] + row.intoCity[tour[j - 1]] + row.fromCity[tour[j + 1]];
+        out[j - first] = added - row.removed - arcWeights[j - 1] - arcWeights[j];
+    }
+}
+
+#ifdef TOUR_KERNELS_X86
+
+// ---------------------------------------------------------------------------
+// AVX2: 8 lanes, 32-bit gathers
+// ---------------------------------------------------------------------------
+
+__attribute__((target("avx2"))) int horizontalSumAvx2(__m256i sums) {
+    __m128i folded = _mm_add_epi32(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+    folded = _mm_add_epi32(folded, _mm_shuffle_epi32(folded, _MM_SHUFFLE(1, 0, 3, 2)));
+    folded = _mm_add_epi32(folded, _mm_shuffle_epi32(folded, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(folded);
+}
+
+__attribute__((target("avx2"))) int pathCostAvx2(const int* weights, int stride, const int* cities, std::size_t count) {
+    const __m256i strides = _mm256_set1_epi32(stride);
+    __m256i sums = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 8 < count; i += 8) {
+        __m256i from = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cities + i));
+        __m256i to = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cities + i + 1));
+        __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(from, strides), to);
+        sums = _mm256_add_epi32(sums, _mm256_i32gather_epi32(weights, index, 4));
+    }
+    return horizontalSumAvx2(sums) + pathCostScalar(weights, stride, cities + i, count - i);
+}
+
+__attribute__((target("avx2"))) int maskedArgminAvx2(const int* row, const int* mask, int count) {
+    __m256i minima = _mm256_set1_epi32(INT_MAX);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        __m256i masks = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i));
+        minima = _mm256_min_epi32(minima, _mm256_max_epi32(weights, masks));
+    }
+    __m128i folded = _mm_min_epi32(_mm256_castsi256_si128(minima), _mm256_extracti128_si256(minima, 1));
+    folded = _mm_min_epi32(folded, _mm_shuffle_epi32(folded, _MM_SHUFFLE(1, 0, 3, 2)));
+    folded = _mm_min_epi32(folded, _mm_shuffle_epi32(folded, _MM_SHUFFLE(2, 3, 0, 1)));
+    int minimum = _mm_cvtsi128_si32(folded);
+    for (; i < count; ++i) {
+        minimum = std::min(minimum, std::max(row[i], mask[i]));
+    }
+
+    const __m256i target = _mm256_set1_epi32(minimum);
+    const __m256i allowed = _mm256_set1_epi32(INT_MIN);
+    for (i = 0; i + 8 <= count; i += 8) {
+        __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        __m256i masks = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i));
+        __m256i hits = _mm256_and_si256(_mm256_cmpeq_epi32(weights, target), _mm256_cmpeq_epi32(masks, allowed));
+        int bits = _mm256_movemask_ps(_mm256_castsi256_ps(hits));
+        if (bits) return i + __builtin_ctz(bits);
+    }
+    return firstAtMinimum(row, mask, i, count, minimum);
+}
+
+__attribute__((target("avx2"))) void swapDeltasAvx2(const SwapRow& row, const int* tour, const int* arcWeights, int first, int last, int* out) {
+    const __m256i removed = _mm256_set1_epi32(row.removed);
+    int j = first;
+    for (; j + 8 <= last; j += 8) {
+        __m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tour + j - 1));
+        __m256i cities = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tour + j));
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tour + j + 1));
+        __m256i added = _mm256_add_epi32(_mm256_i32gather_epi32(row.fromPrevious, cities, 4),
+                                         _mm256_i32gather_epi32(row.intoNext, cities, 4));
+        added = _mm256_add_epi32(added, _mm256_add_epi32(_mm256_i32gather_epi32(row.intoCity, previous, 4),
+                                                         _mm256_i32gather_epi32(row.fromCity, next, 4)));
+        __m256i arcs = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(arcWeights + j - 1)),
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arcWeights + j)));
+        __m256i deltas = _mm256_sub_epi32(added, _mm256_add_epi32(arcs, removed));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j - first), deltas);
+    }
+    swapDeltasScalar(row, tour, arcWeights, j, last, out + j - first);
+}
+
+// ---------------------------------------------------------------------------
+// AVX-512: 16 lanes, mask registers
+// ---------------------------------------------------------------------------
+
+__attribute__((target("avx512f"))) int pathCostAvx512(const int* weights, int stride, const int* cities, std::size_t count) {
+    const __m512i strides = _mm512_set1_epi32(stride);
+    __m512i sums = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 16 < count; i += 16) {
+        __m512i from = _mm512_loadu_si512(cities + i);
+        __m512i to = _mm512_loadu_si512(cities + i + 1);
+        __m512i index = _mm512_add_epi32(_mm512_mullo_epi32(from, strides), to);
+        sums = _mm512_add_epi32(sums, _mm512_i32gather_epi32(index, weights, 4));
+    }
+    return _mm512_reduce_add_epi32(sums) + pathCostScalar(weights, stride, cities + i, count - i);
+}
+
+__attribute__((target("avx512f"))) int maskedArgminAvx512(const int* row, const int* mask, int count) {
+    __m512i minima = _mm512_set1_epi32(INT_MAX);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512i weights = _mm512_loadu_si512(row + i);
+        __m512i masks = _mm512_loadu_si512(mask + i);
+        minima = _mm512_min_epi32(minima, _mm512_max_epi32(weights, masks));
+    }
+    int minimum = _mm512_reduce_min_epi32(minima);
+    for (; i < count; ++i) {
+        minimum = std::min(minimum, std::max(row[i], mask[i]));
+    }
+
+    const __m512i target = _mm512_set1_epi32(minimum);
+    const __m512i allowed = _mm512_set1_epi32(INT_MIN);
+    for (i = 0; i + 16 <= count; i += 16) {
+        __m512i weights = _mm512_loadu_si512(row + i);
+        __m512i masks = _mm512_loadu_si512(mask + i);
+        __mmask16 hits = _mm512_mask_cmpeq_epi32_mask(_mm512_cmpeq_epi32_mask(masks, allowed), weights, target);
+        if (hits) return i + __builtin_ctz(hits);
+    }
+    return firstAtMinimum(row, mask, i, count, minimum);
+}
+
+__attribute__((target("avx512f"))) void swapDeltasAvx512(const SwapRow& row, const int* tour, const int* arcWeights, int first, int last, int* out) {
+    const __m512i removed = _mm512_set1_epi32(row.removed);
+    int j = first;
+    for (; j + 16 <= last; j += 16) {
+        __m512i previous = _mm512_loadu_si512(tour + j - 1);
+        __m512i cities = _mm512_loadu_si512(tour + j);
+        __m512i next = _mm512_loadu_si512(tour + j + 1);
+        __m512i added = _mm512_add_epi32(_mm512_i32gather_epi32(cities, row.fromPrevious, 4),
+                                         _mm512_i32gather_epi32(cities, row.intoNext, 4));
+        added = _mm512_add_epi32(added, _mm512_add_epi32(_mm512_i32gather_epi32(previous, row.intoCity, 4),
+                                                         _mm512_i32gather_epi32(next, row.fromCity, 4)));
+        __m512i arcs = _mm512_add_epi32(_mm512_loadu_si512(arcWeights + j - 1), _mm512_loadu_si512(arcWeights + j));
+        _mm512_storeu_si512(out + j - first, _mm512_sub_epi32(added, _mm512_add_epi32(arcs, removed)));
+    }
+    swapDeltasScalar(row, tour, arcWeights, j, last, out + j - first);
+}
+
+#endif
+
+const KernelTable SCALAR_KERNELS = {"scalar", pathCostScalar, maskedArgminScalar, swapDeltasScalar};
+
+// Widest supported instruction set, capped by ATSP_KERNELS
+KernelTable selectKernels() {
+#ifdef TOUR_KERNELS_X86
+    const char* cap = std::getenv("ATSP_KERNELS");
+    if (cap && !*cap) cap = nullptr;
+    const bool allowAvx512 = !cap || std::strcmp(cap, "avx512") == 0;
+    const bool allowAvx2 = allowAvx512 || std::strcmp(cap, "avx2") == 0;
+    __builtin_cpu_init();
+    if (allowAvx512 && __builtin_cpu_supports("avx512f")) {
+        return {"avx512", pathCostAvx512, maskedArgminAvx512, swapDeltasAvx512};
+    }
+    if (allowAvx2 && __builtin_cpu_supports("avx2")) {
+        return {"avx2", pathCostAvx2, maskedArgminAvx2, swapDeltasAvx2};
+    }
+#endif
+    return SCALAR_KERNELS;
+}
+
+const KernelTable& kernels() {
+    static const KernelTable table = selectKernels();
+    return table;
+}
+
+// Gathers use 32-bit element offsets, larger matrices take the scalar path
+const KernelTable& kernelsFor(const DistanceMatrix& matrix) {
+    if (static_cast<long long>(matrix.size()) * matrix.stride() > INT_MAX) return SCALAR_KERNELS;
+    return kernels();
+}
+
+}
+
+// Cost of a path
+int TourKernels::pathCost(const DistanceMatrix& matrix, const int* cities, std::size_t count) {
+    if (count < 2) return 0;
+    return kernelsFor(matrix).pathCost(matrix.row(0), matrix.stride(), cities, count);
+}
+
+// Cost of an open tour including the closing arc
+int TourKernels::cycleCost(const DistanceMatrix& matrix, const int* cities, std::size_t count) {
+    if (count == 0) return 0;
+    return pathCost(matrix, cities, count) + matrix(cities[count - 1], cities[0]);
+}
+
+// Cheapest allowed entry of a row
+int TourKernels::maskedArgmin(const int* row, const int* mask, int count) {
+    return kernels().maskedArgmin(row, mask, count);
+}
+
+// Cost changes of the swaps (i, j) of one row
+void TourKernels::swapDeltas(const DistanceMatrix& matrix, const int* tour, const int* arcWeights, int size, int i,
+                             int first, int last, int* deltas) {
+    if (first >= last) return;
+    const int previous = tour[(i - 1 + size) % size];
+    const int city = tour[i];
+    const int next = tour[i + 1];
+    if (!matrix.hasTransposed()) {
+        for (int j = first; j < last; ++j) {
+            const int added = matrix(previous, tour[j]) + matrix(tour[j], next) + matrix(tour[j - 1], city) + matrix(city, tour[j + 1]);
+            deltas[j - first] = added - arcWeights[(i - 1 + size) % size] - arcWeights[i] - arcWeights[j - 1] - arcWeights[j];
+        }
+        return;
+    }
+    const SwapRow row{matrix.row(previous), matrix.row(city), matrix.column(next), matrix.column(city),
+                      arcWeights[(i - 1 + size) % size] + arcWeights[i]};
+    kernels().swapDeltas(row, tour, arcWeights, first, last, deltas);
+}
+
+// Name of the selected instruction set
+std::string TourKernels::instructionSet() {
+    return kernels().name;
+}
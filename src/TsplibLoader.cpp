@@ -0,0 +1,283 @@
+#include "../headers/TsplibLoader.h"
+#include "../headers/MappedFile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+bool isBlank(char character) {
+    return character == ' ' || character == '\t' || character == '\r';
+}
+
+bool isWhitespace(char character) {
+    return isBlank(character) || character == '\n' || character == '\f' || character == '\v';
+}
+
+bool isKeywordCharacter(char character) {
+    return (character >= 'A' && character <= 'Z') || (character >= 'a' && character <= 'z')
+        || (character >= '0' && character <= '9') || character == '_';
+}
+
+// Nearest integer, as the TSPLIB nint()
+int nearestInteger(double value) {
+    return static_cast<int>(value + 0.5);
+}
+
+// Latitude or longitude in radians from the TSPLIB DDD.MM notation
+double geoRadians(double value) {
+    const double PI = 3.141592;
+    int degrees = static_cast<int>(value);
+    double minutes = value - degrees;
+    return PI * (degrees + 5.0 * minutes / 3.0) / 180.0;
+}
+
+}
+
+// Skip whitespace including line breaks
+bool TsplibLoader::Scanner::skipWhitespace() {
+    while (position < end && isWhitespace(*position)) ++position;
+    return position < end;
+}
+
+// Read the rest of the line
+std::string TsplibLoader::Scanner::readLine() {
+    while (position < end && isBlank(*position)) ++position;
+    const char* start = position;
+    while (position < end && *position != '\n') ++position;
+    const char* last = position;
+    while (last > start && isBlank(last[-1])) --last;
+    if (position < end) ++position;
+    return std::string(start, last);
+}
+
+// Hand-rolled integer scanner, falling back to from_chars for decimal values
+long long TsplibLoader::Scanner::readInteger() {
+    skipWhitespace();
+    const char* start = position;
+    const char* cursor = position;
+    bool negative = false;
+    if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+        negative = *cursor == '-';
+        ++cursor;
+    }
+    const char* digits = cursor;
+    long long value = 0;
+    while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+        value = value * 10 + (*cursor - '0');
+        ++cursor;
+    }
+    if (cursor < end && (*cursor == '.' || *cursor == 'e' || *cursor == 'E')) {
+        position = start;
+        return std::llround(readDouble());
+    }
+    if (cursor == digits) {
+        throw std::runtime_error("Error: The file ended or contains a non-numeric token before all DIMENSION entries were read.");
+    }
+    position = cursor;
+    return negative ? -value : value;
+}
+
+// Decimal number scanner
+double TsplibLoader::Scanner::readDouble() {
+    skipWhitespace();
+    if (position < end && *position == '+') ++position; // from_chars does not accept a leading plus
+    double value = 0.0;
+    auto result = std::from_chars(position, end, value);
+    if (result.ec != std::errc()) {
+        throw std::runtime_error("Error: The file ended or contains a non-numeric token before all DIMENSION entries were read.");
+    }
+    position = result.ptr;
+    return value;
+}
+
+// Fill the matrix from an EDGE_WEIGHT_SECTION
+void TsplibLoader::readExplicitWeights(Scanner& scanner, const std::string& format, DistanceMatrix& matrix) {
+    const int dimension = matrix.size();
+
+    if (format.empty() || format == "FULL_MATRIX") {
+        for (int from = 0; from < dimension; ++from) {
+            int* row = matrix.rowData(from);
+            for (int to = 0; to < dimension; ++to) {
+                row[to] = static_cast<int>(scanner.readInteger());
+            }
+        }
+        return;
+    }
+
+    // Column formats of a symmetric matrix list the same sequence as the mirrored row format
+    bool upper, diagonal;
+    if (format == "UPPER_ROW" || format == "LOWER_COL") {
+        upper = true;
+        diagonal = false;
+    } else if (format == "UPPER_DIAG_ROW" || format == "LOWER_DIAG_COL") {
+        upper = true;
+        diagonal = true;
+    } else if (format == "LOWER_ROW" || format == "UPPER_COL") {
+        upper = false;
+        diagonal = false;
+    } else if (format == "LOWER_DIAG_ROW" || format == "UPPER_DIAG_COL") {
+        upper = false;
+        diagonal = true;
+    } else {
+        throw std::runtime_error("Error: Unsupported EDGE_WEIGHT_FORMAT " + format + ".");
+    }
+
+    for (int from = 0; from < dimension; ++from) {
+        int first = upper ? (diagonal ? from : from + 1) : 0;
+        int last = upper ? dimension : (diagonal ? from + 1 : from);
+        int* row = matrix.rowData(from);
+        for (int to = first; to < last; ++to) {
+            int weight = static_cast<int>(scanner.readInteger());
+            row[to] = weight;
+            matrix.rowData(to)[from] = weight;
+        }
+    }
+}
+
+// Compute the matrix from a NODE_COORD_SECTION
+void TsplibLoader::readCoordinates(Scanner& scanner, const std::string& weightType, DistanceMatrix& matrix) {
+    const int dimension = matrix.size();
+    const bool threeDimensional = weightType == "EUC_3D" || weightType == "MAN_3D" || weightType == "MAX_3D";
+    const std::vector<std::string> supported = {"EUC_2D", "EUC_3D", "CEIL_2D", "MAN_2D", "MAN_3D", "MAX_2D", "MAX_3D", "ATT", "GEO"};
+    if (std::find(supported.begin(), supported.end(), weightType) == supported.end()) {
+        throw std::runtime_error("Error: Unsupported EDGE_WEIGHT_TYPE " + weightType + ".");
+    }
+
+    std::vector<double> x(dimension), y(dimension), z(dimension, 0.0);
+    for (int node = 0; node < dimension; ++node) {
+        long long id = scanner.readInteger();
+        if (id < 1 || id > dimension) {
+            throw std::runtime_error("Error: Node number " + std::to_string(id) + " is outside of DIMENSION.");
+        }
+        x[id - 1] = scanner.readDouble();
+        y[id - 1] = scanner.readDouble();
+        if (threeDimensional) z[id - 1] = scanner.readDouble();
+    }
+
+    if (weightType == "GEO") {
+        const double RRR = 6378.388;
+        std::vector<double> latitude(dimension), longitude(dimension);
+        for (int node = 0; node < dimension; ++node) {
+            latitude[node] = geoRadians(x[node]);
+            longitude[node] = geoRadians(y[node]);
+        }
+        for (int from = 0; from < dimension; ++from) {
+            int* row = matrix.rowData(from);
+            for (int to = 0; to < dimension; ++to) {
+                if (from == to) {
+                    row[to] = 0;
+                    continue;
+                }
+                double q1 = std::cos(longitude[from] - longitude[to]);
+                double q2 = std::cos(latitude[from] - latitude[to]);
+                double q3 = std::cos(latitude[from] + latitude[to]);
+                row[to] = static_cast<int>(RRR * std::acos(0.5 * ((1.0 + q1) * q2 - (1.0 - q1) * q3)) + 1.0);
+            }
+        }
+        return;
+    }
+
+    for (int from = 0; from < dimension; ++from) {
+        int* row = matrix.rowData(from);
+        for (int to = 0; to < dimension; ++to) {
+            double dx = std::fabs(x[from] - x[to]);
+            double dy = std::fabs(y[from] - y[to]);
+            double dz = std::fabs(z[from] - z[to]);
+            int weight;
+            if (weightType == "EUC_2D" || weightType == "EUC_3D") {
+                weight = nearestInteger(std::sqrt(dx * dx + dy * dy + dz * dz));
+            } else if (weightType == "CEIL_2D") {
+                weight = static_cast<int>(std::ceil(std::sqrt(dx * dx + dy * dy)));
+            } else if (weightType == "MAN_2D" || weightType == "MAN_3D") {
+                weight = nearestInteger(dx + dy + dz);
+            } else if (weightType == "MAX_2D" || weightType == "MAX_3D") {
+                weight = std::max({nearestInteger(dx), nearestInteger(dy), nearestInteger(dz)});
+            } else {
+                // ATT pseudo-Euclidean distance
+                double distance = std::sqrt((dx * dx + dy * dy) / 10.0);
+                int rounded = nearestInteger(distance);
+                weight = rounded < distance ? rounded + 1 : rounded;
+            }
+            row[to] = weight;
+        }
+    }
+}
+
+// Map the file and parse the keywords and the data section
+TsplibInstance TsplibLoader::load(const std::string& path) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    MappedFile file(path);
+    Scanner scanner{file.data(), file.data() + file.size()};
+    TsplibInstance instance;
+    instance.edgeWeightType = "EXPLICIT";
+
+    try {
+        while (!instance.matrix && scanner.skipWhitespace()) {
+            const char* keywordStart = scanner.position;
+            while (scanner.position < scanner.end && isKeywordCharacter(*scanner.position)) ++scanner.position;
+            std::string keyword(keywordStart, scanner.position);
+            if (keyword.empty()) {
+                scanner.readLine(); // Data of a section that is not used
+                continue;
+            }
+            while (scanner.position < scanner.end && isBlank(*scanner.position)) ++scanner.position;
+            if (scanner.position < scanner.end && *scanner.position == ':') ++scanner.position;
+
+            if (keyword == "EOF") break;
+            if (keyword == "EDGE_WEIGHT_SECTION" || keyword == "NODE_COORD_SECTION") {
+                if (instance.dimension <= 0) {
+                    throw std::runtime_error("Error: DIMENSION must be given before " + keyword + ".");
+                }
+                bool coordinates = keyword == "NODE_COORD_SECTION";
+                if (coordinates == (instance.edgeWeightType == "EXPLICIT")) {
+                    scanner.readLine(); // Display coordinates of an explicit instance
+                    continue;
+                }
+                auto matrix = std::make_shared<DistanceMatrix>(instance.dimension);
+                if (coordinates) {
+                    readCoordinates(scanner, instance.edgeWeightType, *matrix);
+                } else {
+                    readExplicitWeights(scanner, instance.edgeWeightFormat, *matrix);
+                }
+                instance.matrix = matrix;
+
+                // Only a keyword may follow the data, surplus numbers mean DIMENSION is too small
+                if (scanner.skipWhitespace()) {
+                    const char* tokenEnd = scanner.position;
+                    while (tokenEnd < scanner.end && isKeywordCharacter(*tokenEnd)) ++tokenEnd;
+                    std::string next(scanner.position, tokenEnd);
+                    bool section = next.size() > 8 && next.compare(next.size() - 8, 8, "_SECTION") == 0;
+                    if (next != "EOF" && !section) {
+                        throw std::runtime_error("Error: " + keyword + " contains more entries than DIMENSION.");
+                    }
+                }
+                continue;
+            }
+            if (keyword.size() > 8 && keyword.compare(keyword.size() - 8, 8, "_SECTION") == 0) {
+                scanner.readLine(); // Sections that do not define the weights, their numbers are skipped above
+                continue;
+            }
+
+            std::string value = scanner.readLine();
+            if (keyword == "NAME") instance.name = value;
+            else if (keyword == "TYPE") instance.type = value;
+            else if (keyword == "DIMENSION") instance.dimension = std::stoi(value);
+            else if (keyword == "EDGE_WEIGHT_TYPE") instance.edgeWeightType = value;
+            else if (keyword == "EDGE_WEIGHT_FORMAT") instance.edgeWeightFormat = value;
+        }
+    } catch (const std::invalid_argument&) {
+        throw std::runtime_error("Error: Invalid DIMENSION in file " + path);
+    } catch (const std::runtime_error& error) {
+        throw std::runtime_error(std::string(error.what()) + " (" + path + ")");
+    }
+
+    if (!instance.matrix) {
+        throw std::runtime_error("Error: File " + path + " contains no weight or coordinate section.");
+    }
+    instance.parseSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+    return instance;
+}
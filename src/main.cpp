@@ -4,7 +4,8 @@
  * This application solves the Asymmetric Traveling Salesman Problem (ATSP) using
  * three algorithms: Greedy Algorithm, Tabu Search, and Simulated Annealing. Users
  * can interact via a menu interface to load data, configure parameters, execute
- * algorithms, and save results.
+ * algorithms, and save results. Started with command line options, it runs a batch
+ * of experiments instead and writes their results as CSV.
  */
 
 
@@ -15,35 +16,110 @@
 #include <string>
 #include <algorithm>
 #include <stdexcept>
+#include <memory>
+#include <chrono>
 
 #include "../headers/Option.h"
+#include "../headers/DistanceMatrix.h"
+#include "../headers/TsplibLoader.h"
+#include "../headers/MatrixCache.h"
 #include "../headers/TabuSearch.h"
 #include "../headers/GreedyAlgorithm.h"
+#include "../headers/HeldKarp.h"
+#include "../headers/BranchAndBound.h"
 #include "../headers/SimulatedAnnealing.h"
+#include "../headers/PortfolioSolver.h"
+#include "../headers/MemeticAlgorithm.h"
+#include "../headers/ThreadPool.h"
+#include "../headers/Neighborhood.h"
+#include "../headers/CandidateList.h"
+#include "../headers/ConstructionHeuristic.h"
+#include "../headers/TourKernels.h"
+#include "../headers/ExperimentRunner.h"
 
 
 
 /**
  * Global Variables
  * ----------------
- * distanceMatrix : A 2D vector storing the adjacency matrix for the ATSP.
+ * distanceMatrix : Shared, read-only distance matrix of the loaded ATSP instance.
  * maxRunTime : Maximum computation time for algorithms in seconds (default: 60 seconds).
  * temperatureChangeFactor : Cooling rate for Simulated Annealing (default: 0.85).
  * greedySolver : Pointer to an instance of the GreedyAlgorithm class.
  * tabuSolver : Pointer to an instance of the TabuSearch class.
  * simulatedAnnealingSolver : Pointer to an instance of the SimulatedAnnealing class.
+ * heldKarpSolver : Pointer to an instance of the HeldKarp class.
+ * branchAndBoundSolver : Pointer to an instance of the BranchAndBound class.
+ * portfolioSolver : Pointer to an instance of the PortfolioSolver class.
+ * memeticSolver : Pointer to an instance of the MemeticAlgorithm class.
  * resultsFilePath : Default path to save results ("results.txt").
+ * threadCount : Number of worker threads for the parallel algorithms (0: one per hardware thread).
+ * threadPool : Persistent worker pool shared by the solvers, created on first use.
+ * neighborhoodTypes : Move types used by Tabu Search and Simulated Annealing (default: swap and or-opt).
+ * candidateListSize : Nearest successors/predecessors kept per city (default: 10, 0 disables pruning).
+ * candidateList : Candidate lists of the loaded matrix, rebuilt when the matrix or the size changes.
+ * localSearchEnabled : Whether solver tours are polished with the VND local search (default: off).
+ * localSearchPeriod : Seconds between local search runs inside Tabu Search and Simulated Annealing (0: only at the end).
+ * annealingChainCount : Independent Simulated Annealing chains run in parallel (default: 1, 0: one per worker thread).
+ * annealingRestartPeriod : Seconds after which a chain restarts from the best tour of all chains (0: never).
+ * temperingReplicas : Rungs of the parallel tempering ladder replacing the cooling schedule (default: 1, disabled).
+ * exactMemoryLimitMB : Memory the exact solvers may use, in MiB (default: 1024).
+ * randomSeed : Seed of Tabu Search and Simulated Annealing (default: 0, a new random seed for every run).
+ * constructionSelected : Whether Tabu Search and Simulated Annealing start from constructionType (default: off,
+ *                        Tabu Search starts from a random tour and Simulated Annealing from the nearest neighbour tour).
+ * constructionType : Construction heuristic building their start tours.
+ * populationSize : Number of tours of the memetic algorithm (default: 30).
+ * crossoverType : Crossover of the memetic algorithm (default: edge assembly).
+ * tabuAttribute : Move attribute made tabu by Tabu Search (default: arcs).
+ * tabuTenure : Tabu tenure in iterations (default: 0, the reactive tenure).
+ * reactiveTabu : Whether Tabu Search runs in intensification and diversification phases (default: off).
+ * tabuStagnation : Iterations without improvement that end a phase of the reactive Tabu Search (default: 0, twice the cities).
+ * coolingSchedule : Schedule changing the Simulated Annealing temperature between epochs (default: adaptive).
+ * epochFactor : Proposals per city in one Simulated Annealing epoch (default: 10).
+ * iterationLimit : Iterations (Simulated Annealing: proposals) ending Tabu Search, Simulated Annealing and the portfolio (default: 0, none).
+ * stallIterationLimit : Iterations without a new best tour ending them (default: 0, none).
+ * targetCost : Tour cost ending them once reached (default: -1, none).
  */
-std::vector<std::vector<int>> distanceMatrix;
+std::shared_ptr<const DistanceMatrix> distanceMatrix;
 long maxRunTime = 60L; // Default run time in seconds
 float temperatureChangeFactor = 0.85;
 
 GreedyAlgorithm* greedySolver = nullptr;
 TabuSearch* tabuSolver = nullptr;
 SimulatedAnnealing* simulatedAnnealingSolver = nullptr;
+HeldKarp* heldKarpSolver = nullptr;
+BranchAndBound* branchAndBoundSolver = nullptr;
+PortfolioSolver* portfolioSolver = nullptr;
+MemeticAlgorithm* memeticSolver = nullptr;
 
 std::string resultsFilePath = "/home/ciamcio/workspace/cppPrograming/ATSPalgorithms/results.txt";
 
+int threadCount = 0;
+ThreadPool* threadPool = nullptr;
+std::vector<NeighborhoodType> neighborhoodTypes = {NeighborhoodType::SWAP, NeighborhoodType::OR_OPT};
+int candidateListSize = 10;
+std::shared_ptr<const CandidateList> candidateList;
+bool localSearchEnabled = false;
+double localSearchPeriod = 0.0;
+int annealingChainCount = 1;
+double annealingRestartPeriod = 0.0;
+int temperingReplicas = 1;
+long exactMemoryLimitMB = 1024L;
+unsigned long long randomSeed = 0;
+bool constructionSelected = false;
+ConstructionType constructionType = ConstructionType::NEAREST_NEIGHBOR;
+int populationSize = MemeticAlgorithm::DEFAULT_POPULATION_SIZE;
+CrossoverType crossoverType = CrossoverType::EDGE_ASSEMBLY;
+TabuAttribute tabuAttribute = TabuAttribute::ARC;
+int tabuTenure = TabuMemory::REACTIVE_TENURE;
+bool reactiveTabu = false;
+int tabuStagnation = 0;
+CoolingSchedule coolingSchedule = CoolingSchedule::ADAPTIVE;
+int epochFactor = AnnealingSchedule::DEFAULT_EPOCH_FACTOR;
+long long iterationLimit = 0;
+long long stallIterationLimit = 0;
+long long targetCost = StopLimits::NO_TARGET;
+
 
 // Function Declarations
 void displayMainMenu();
@@ -53,19 +129,31 @@ void handleMenuOption(Option selectedOption);
 void pressEnterToContinue();
 void clearScreen();
 
-std::vector<std::vector<int>> loadMatrixFromFile(const std::string& path);
+TsplibInstance loadMatrixFromFile(const std::string& path);
+bool isMatrixLoaded();
 
 void setMaxRunTime(long seconds);
+long long convertStringToLimit(const std::string& input);
+StopLimits getStopLimits();
 void setTemperatureChangeFactor(float factor);
+void setThreadCount(int count);
+ThreadPool* getThreadPool();
+void setNeighborhoodTypes(const std::string& selection);
+void setCandidateListSize(int size);
+void rebuildCandidateList();
 void loadCostTable();
+int runExperiments(int argc, char* argv[]);
 
 /**
  * Main Function
  * -------------
- * Loops indefinitely, displaying a menu to the user. Handles user input
+ * With command line arguments, runs the batch experiments they describe and exits.
+ * Otherwise loops indefinitely, displaying a menu to the user. Handles user input
  * and invokes appropriate methods based on menu selection.
  */
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1) return runExperiments(argc, argv);
+
     while (true) {
         displayMainMenu();
         std::string inputString;
@@ -85,13 +173,30 @@ int main() {
 void displayMainMenu() {
     std::cout << "Application solving the ATSP problem using Tabu Search and Simulated Annealing\n";
     std::cout << "1. Load dataset\n";
-    std::cout << "2. Set maximum calculation time (stop criterion)\n";
+    std::cout << "2. Set the stop criterion (time, iterations, target cost)\n";
     std::cout << "3. Solve problem using Greedy Algorithm\n";
     std::cout << "4. Solve problem using Tabu Search\n";
     std::cout << "5. Set temperature change factor for Simulated Annealing\n";
     std::cout << "6. Solve problem using Simulated Annealing\n";
     std::cout << "7. Save results to file\n";
     std::cout << "8. Load cost tables\n";
+    std::cout << "9. Set number of worker threads\n";
+    std::cout << "10. Select neighbourhoods for Tabu Search and Simulated Annealing\n";
+    std::cout << "11. Set candidate list size (nearest neighbours per city)\n";
+    std::cout << "12. Configure local search post-optimisation\n";
+    std::cout << "13. Configure parallel Simulated Annealing chains\n";
+    std::cout << "14. Configure parallel tempering for Simulated Annealing\n";
+    std::cout << "15. Solve problem exactly using Held-Karp (small instances)\n";
+    std::cout << "16. Set memory limit for exact solvers\n";
+    std::cout << "17. Solve problem using Branch and Bound (seeded with the best tour so far)\n";
+    std::cout << "18. Set random seed\n";
+    std::cout << "19. Select construction heuristic for start tours\n";
+    std::cout << "20. Solve problem using the portfolio (Tabu Search and Simulated Annealing sharing elite tours)\n";
+    std::cout << "21. Solve problem using the memetic algorithm\n";
+    std::cout << "22. Configure the memetic algorithm (population size and crossover)\n";
+    std::cout << "23. Configure the tabu memory (attribute and tenure)\n";
+    std::cout << "24. Configure reactive Tabu Search (intensification and diversification phases)\n";
+    std::cout << "25. Configure the cooling schedule of Simulated Annealing\n";
     std::cout << "0. Exit\n";
     std::cout << "Enter the number corresponding to your choice: ";
 }
@@ -112,6 +217,23 @@ Option validateInput(const std::string& input) {
         case 6: return Option::RUN_SIMULATED_ANNEALING;
         case 7: return Option::SAVE_TO_FILE;
         case 8: return Option::LOAD_COST_TABELS;
+        case 9: return Option::SET_THREAD_COUNT;
+        case 10: return Option::SET_NEIGHBORHOODS;
+        case 11: return Option::SET_CANDIDATE_LIST_SIZE;
+        case 12: return Option::SET_LOCAL_SEARCH;
+        case 13: return Option::SET_ANNEALING_CHAINS;
+        case 14: return Option::SET_PARALLEL_TEMPERING;
+        case 15: return Option::RUN_HELD_KARP;
+        case 16: return Option::SET_EXACT_MEMORY_LIMIT;
+        case 17: return Option::RUN_BRANCH_AND_BOUND;
+        case 18: return Option::SET_RANDOM_SEED;
+        case 19: return Option::SET_CONSTRUCTION;
+        case 20: return Option::RUN_PORTFOLIO;
+        case 21: return Option::RUN_MEMETIC;
+        case 22: return Option::SET_MEMETIC;
+        case 23: return Option::SET_TABU_MEMORY;
+        case 24: return Option::SET_REACTIVE_TABU;
+        case 25: return Option::SET_ANNEALING_SCHEDULE;
         case 0: return Option::EXIT;
         default: return Option::INVALID_INPUT;
     }
@@ -129,9 +251,14 @@ void handleMenuOption(Option selectedOption) {
             std::cout << "Enter the path to the data file: ";
             std::cin >> filePath;
             try {
-                distanceMatrix = loadMatrixFromFile(filePath);
+                TsplibInstance instance = loadMatrixFromFile(filePath);
+                distanceMatrix = instance.matrix;
+                rebuildCandidateList();
                 std::cout << "Data loaded successfully.\n";
-                std::cout << "Matrix size: " << distanceMatrix.size() << " x " << distanceMatrix.size() << "\n";
+                std::cout << "Instance: " << instance.name << " (" << instance.edgeWeightType
+                          << (instance.edgeWeightFormat.empty() ? "" : ", " + instance.edgeWeightFormat) << ")\n";
+                std::cout << "Matrix size: " << distanceMatrix->size() << " x " << distanceMatrix->size() << "\n";
+                std::cout << (instance.fromCache ? "Cache load time: " : "Parse time: ") << instance.parseSeconds << " s\n";
             } catch (const std::exception& e) {
                 std::cerr << e.what() << std::endl;
             }
@@ -144,18 +271,32 @@ void handleMenuOption(Option selectedOption) {
             std::cin >> input;
             int seconds = convertStringToInt(input);
             setMaxRunTime(seconds);
-            std::cout << "Stop criterion set to " << maxRunTime << " seconds.\n";
+            std::cout << "Enter the maximum number of iterations (0 = no limit): ";
+            std::cin >> input;
+            iterationLimit = std::max(0LL, convertStringToLimit(input));
+            std::cout << "Enter the number of iterations without improvement (0 = no limit): ";
+            std::cin >> input;
+            stallIterationLimit = std::max(0LL, convertStringToLimit(input));
+            std::cout << "Enter the target cost (-1 = none): ";
+            std::cin >> input;
+            targetCost = std::max(StopLimits::NO_TARGET, convertStringToLimit(input));
+            std::cout << "Stop criterion set to " << maxRunTime << " seconds";
+            if (iterationLimit > 0) std::cout << ", " << iterationLimit << " iterations";
+            if (stallIterationLimit > 0) std::cout << ", " << stallIterationLimit << " iterations without improvement";
+            if (targetCost != StopLimits::NO_TARGET) std::cout << ", target cost " << targetCost;
+            std::cout << ".\n";
             break;
         }
 
         case Option::GREEDY_ALGORITHM: {
-            if (distanceMatrix.empty()) {
+            if (!isMatrixLoaded()) {
                 std::cerr << "Error: Distance matrix is empty.\n";
                 break;
             }
             if (greedySolver) delete greedySolver;
-            greedySolver = new GreedyAlgorithm(distanceMatrix);
+            greedySolver = new GreedyAlgorithm(distanceMatrix, getThreadPool());
             greedySolver->solve();
+            if (localSearchEnabled) greedySolver->improveWithLocalSearch(candidateList.get());
             std::cout << "Greedy Algorithm Results:\n";
             std::cout << "Number of vertices: " << greedySolver->getMatrixSize() << "\n";
             std::cout << "Best cost: " << greedySolver->getBestCost() << "\n";
@@ -168,12 +309,18 @@ void handleMenuOption(Option selectedOption) {
         }
 
         case Option::RUN_TABU_SEARCH: {
-            if (distanceMatrix.empty()) {
+            if (!isMatrixLoaded()) {
                 std::cerr << "Error: Distance matrix is empty.\n";
                 break;
             }
             if (tabuSolver) delete tabuSolver;
-            tabuSolver = new TabuSearch(distanceMatrix, 2, maxRunTime);
+            tabuSolver = new TabuSearch(distanceMatrix, tabuTenure, maxRunTime, getThreadPool(), neighborhoodTypes, candidateList);
+            tabuSolver->setTabuMemory(tabuAttribute, tabuTenure);
+            tabuSolver->setReactive(reactiveTabu, tabuStagnation);
+            tabuSolver->setStopLimits(getStopLimits());
+            tabuSolver->setLocalSearch(localSearchEnabled, localSearchPeriod);
+            if (randomSeed != 0) tabuSolver->setSeed(randomSeed);
+            if (constructionSelected) tabuSolver->setConstruction(constructionType);
             tabuSolver->solve();
             std::cout << "Tabu Search Results:\n";
             std::cout << "Best cost: " << tabuSolver->getOptimalCost() << "\n";
@@ -182,7 +329,21 @@ void handleMenuOption(Option selectedOption) {
                 std::cout << city << " ";
             }
             std::cout << std::endl;
-            std::cout << "Tiem stamp when found: " << tabuSolver->getBestTourTimestamp();
+            std::cout << "Tiem stamp when found: " << tabuSolver->getBestTourTimestamp() << "\n";
+            std::cout << "Iterations: " << tabuSolver->getIterationCount()
+                      << " (" << tabuSolver->getIterationsPerSecond() << " per second)" << std::endl;
+            std::cout << "Stopped by: " << StopCriterion::reasonName(tabuSolver->getStopReason()) << std::endl;
+            std::cout << "Final tabu tenure: " << tabuSolver->getTabuTenure()
+                      << ", returns to earlier tours: " << tabuSolver->getRepetitionCount()
+                      << ", tabu moves taken by aspiration: " << tabuSolver->getAspirationCount() << std::endl;
+            if (reactiveTabu) {
+                const std::vector<TabuSearch::PhaseStatistics> phases = tabuSolver->getPhaseStatistics();
+                for (std::size_t index = 0; index < phases.size(); ++index) {
+                    std::cout << TabuSearch::phaseName(static_cast<TabuPhase>(index)) << ": " << phases[index].entries << " phases, "
+                              << phases[index].iterations << " iterations, " << phases[index].evaluations << " evaluated moves, "
+                              << phases[index].seconds << " s, " << phases[index].improvements << " new best tours\n";
+                }
+            }
             break;
         }
 
@@ -196,12 +357,24 @@ void handleMenuOption(Option selectedOption) {
         }
 
         case Option::RUN_SIMULATED_ANNEALING: {
-            if (distanceMatrix.empty()) {
+            if (!isMatrixLoaded()) {
                 std::cerr << "Error: Distance matrix is empty.\n";
                 break;
             }
             if (simulatedAnnealingSolver) delete simulatedAnnealingSolver;
-            simulatedAnnealingSolver = new SimulatedAnnealing(distanceMatrix, temperatureChangeFactor, maxRunTime);
+            simulatedAnnealingSolver = new SimulatedAnnealing(distanceMatrix, temperatureChangeFactor, maxRunTime, neighborhoodTypes, candidateList);
+            simulatedAnnealingSolver->setStopLimits(getStopLimits());
+            simulatedAnnealingSolver->setLocalSearch(localSearchEnabled, localSearchPeriod);
+            simulatedAnnealingSolver->setSchedule(coolingSchedule, epochFactor);
+            if (randomSeed != 0) simulatedAnnealingSolver->setSeed(randomSeed);
+            if (constructionSelected) simulatedAnnealingSolver->setConstruction(constructionType);
+            if (annealingChainCount != 1) {
+                int chains = annealingChainCount > 0 ? annealingChainCount : getThreadPool()->size();
+                simulatedAnnealingSolver->setParallelChains(chains, getThreadPool(), annealingRestartPeriod);
+            }
+            if (temperingReplicas > 1) {
+                simulatedAnnealingSolver->setParallelTempering(temperingReplicas, getThreadPool());
+            }
             simulatedAnnealingSolver->solve();
             std::cout << "Best cost: " << simulatedAnnealingSolver->getBestCost() << "\n";
             std::cout << "Best tour: ";
@@ -210,12 +383,23 @@ void handleMenuOption(Option selectedOption) {
             }
             std::cout << std::endl;
             std::cout << "Tiem stamp when found: " << simulatedAnnealingSolver->getBestSolutionTimestamp() << std::endl; 
+            // About ten evenly spaced epochs of the temperature trace
+            const std::vector<AnnealingSchedule::EpochRecord> trace = simulatedAnnealingSolver->getTemperatureTrace();
+            const std::size_t step = std::max<std::size_t>(1, trace.size() / 10);
+            for (std::size_t index = 0; index < trace.size(); index += step) {
+                std::cout << "t = " << trace[index].time << " s: T = " << trace[index].temperature << ", uphill acceptance "
+                          << 100.0 * trace[index].acceptanceRate << "%, cost " << trace[index].cost << "\n";
+            }
             break;
         }
 
         case Option::SAVE_TO_FILE: {
             if (greedySolver) greedySolver->saveResultToFile(resultsFilePath);
             if (tabuSolver) tabuSolver->saveResultsToFile(resultsFilePath);
+            if (heldKarpSolver) heldKarpSolver->saveResultToFile(resultsFilePath);
+            if (branchAndBoundSolver) branchAndBoundSolver->saveResultToFile(resultsFilePath);
+            if (portfolioSolver) portfolioSolver->saveResultsToFile(resultsFilePath);
+            if (memeticSolver) memeticSolver->saveResultsToFile(resultsFilePath);
             std::cout << "Results saved to " << resultsFilePath << ".\n";
             break;
         }
@@ -225,6 +409,316 @@ void handleMenuOption(Option selectedOption) {
             break;
         }
 
+        case Option::SET_THREAD_COUNT: {
+            std::string input;
+            std::cout << "Enter the number of worker threads (0 = all hardware threads): ";
+            std::cin >> input;
+            setThreadCount(convertStringToInt(input));
+            std::cout << "Worker threads set to " << getThreadPool()->size() << ".\n";
+            break;
+        }
+
+        case Option::SET_NEIGHBORHOODS: {
+            std::string input;
+            std::cout << "Enter the neighbourhoods to use (1 = swap, 2 = or-opt, 3 = segment exchange), e.g. 12: ";
+            std::cin >> input;
+            setNeighborhoodTypes(input);
+            std::cout << "Neighbourhoods set to:";
+            for (NeighborhoodType type : neighborhoodTypes) {
+                std::cout << " " << Neighborhood::create(type)->getName();
+            }
+            std::cout << ".\n";
+            break;
+        }
+
+        case Option::SET_CANDIDATE_LIST_SIZE: {
+            std::string input;
+            std::cout << "Enter the number of nearest neighbours kept per city (0 = full neighbourhoods): ";
+            std::cin >> input;
+            setCandidateListSize(convertStringToInt(input));
+            std::cout << "Candidate list size set to " << candidateListSize << ".\n";
+            break;
+        }
+
+        case Option::SET_LOCAL_SEARCH: {
+            std::string input;
+            std::cout << "Polish tours with local search? (1 = yes, 0 = no): ";
+            std::cin >> input;
+            localSearchEnabled = convertStringToInt(input) == 1;
+            if (localSearchEnabled) {
+                std::cout << "Enter the local search period during Tabu Search/Simulated Annealing in seconds (0 = only at the end): ";
+                std::cin >> input;
+                localSearchPeriod = std::max(0, convertStringToInt(input));
+            }
+            std::cout << "Local search " << (localSearchEnabled ? "enabled" : "disabled") << ".\n";
+            break;
+        }
+
+        case Option::SET_ANNEALING_CHAINS: {
+            std::string input;
+            std::cout << "Enter the number of parallel Simulated Annealing chains (1 = single chain, 0 = one per worker thread): ";
+            std::cin >> input;
+            annealingChainCount = std::max(0, convertStringToInt(input));
+            if (annealingChainCount != 1) {
+                std::cout << "Enter the restart period in seconds, after which a chain continues from the best tour of all chains (0 = never): ";
+                std::cin >> input;
+                annealingRestartPeriod = std::max(0, convertStringToInt(input));
+            }
+            std::cout << "Simulated Annealing chains set to " << annealingChainCount << ".\n";
+            break;
+        }
+
+        case Option::SET_PARALLEL_TEMPERING: {
+            std::string input;
+            std::cout << "Enter the number of parallel tempering replicas (1 = geometric cooling schedule): ";
+            std::cin >> input;
+            temperingReplicas = std::max(1, convertStringToInt(input));
+            std::cout << "Parallel tempering " << (temperingReplicas > 1 ? "enabled with " + std::to_string(temperingReplicas) + " replicas" : "disabled") << ".\n";
+            break;
+        }
+
+        case Option::RUN_HELD_KARP: {
+            if (!isMatrixLoaded()) {
+                std::cerr << "Error: Distance matrix is empty.\n";
+                break;
+            }
+            if (heldKarpSolver) delete heldKarpSolver;
+            heldKarpSolver = new HeldKarp(distanceMatrix, getThreadPool(), static_cast<std::size_t>(exactMemoryLimitMB) << 20);
+            try {
+                heldKarpSolver->solve();
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+                delete heldKarpSolver;
+                heldKarpSolver = nullptr;
+                break;
+            }
+            std::cout << "Held-Karp Results:\n";
+            std::cout << "Optimal cost: " << heldKarpSolver->getBestCost() << "\n";
+            std::cout << "Optimal tour: ";
+            for (int city : heldKarpSolver->getBestTour()) {
+                std::cout << city << " ";
+            }
+            std::cout << std::endl;
+            break;
+        }
+
+        case Option::RUN_BRANCH_AND_BOUND: {
+            if (!isMatrixLoaded()) {
+                std::cerr << "Error: Distance matrix is empty.\n";
+                break;
+            }
+            if (branchAndBoundSolver) delete branchAndBoundSolver;
+            branchAndBoundSolver = new BranchAndBound(distanceMatrix, maxRunTime, getThreadPool(), static_cast<std::size_t>(exactMemoryLimitMB) << 20);
+            // Seed with the tours of the heuristics run on this matrix, the best one wins
+            if (greedySolver && greedySolver->getMatrixSize() == distanceMatrix->size()) {
+                branchAndBoundSolver->setIncumbent(greedySolver->getBestTour(), greedySolver->getBestCost());
+            }
+            if (tabuSolver && tabuSolver->getOptimalSolution().size() == static_cast<size_t>(distanceMatrix->size())) {
+                branchAndBoundSolver->setIncumbent(tabuSolver->getOptimalSolution(), tabuSolver->getOptimalCost());
+            }
+            if (simulatedAnnealingSolver && simulatedAnnealingSolver->getBestSolution().size() == static_cast<size_t>(distanceMatrix->size()) + 1) {
+                branchAndBoundSolver->setIncumbent(simulatedAnnealingSolver->getBestSolution(), simulatedAnnealingSolver->getBestCost());
+            }
+            if (portfolioSolver && portfolioSolver->getBestTour().size() == static_cast<size_t>(distanceMatrix->size()) + 1) {
+                branchAndBoundSolver->setIncumbent(portfolioSolver->getBestTour(), portfolioSolver->getBestCost());
+            }
+            if (memeticSolver && memeticSolver->getBestTour().size() == static_cast<size_t>(distanceMatrix->size()) + 1) {
+                branchAndBoundSolver->setIncumbent(memeticSolver->getBestTour(), memeticSolver->getBestCost());
+            }
+            branchAndBoundSolver->solve();
+            std::cout << "Branch and Bound Results:\n";
+            std::cout << "Best cost: " << branchAndBoundSolver->getBestCost()
+                      << (branchAndBoundSolver->isOptimal() ? " (proven optimal)" : "") << "\n";
+            std::cout << "Lower bound: " << branchAndBoundSolver->getLowerBound()
+                      << ", gap: " << branchAndBoundSolver->getGap() << "%\n";
+            std::cout << "Best tour: ";
+            for (int city : branchAndBoundSolver->getBestTour()) {
+                std::cout << city << " ";
+            }
+            std::cout << std::endl;
+            std::cout << "Tiem stamp when found: " << branchAndBoundSolver->getBestTourTimestamp() << "\n";
+            std::cout << "Nodes: " << branchAndBoundSolver->getNodeCount() << std::endl;
+            break;
+        }
+
+        case Option::SET_EXACT_MEMORY_LIMIT: {
+            std::string input;
+            std::cout << "Enter the memory limit of the exact solvers in MiB: ";
+            std::cin >> input;
+            int megabytes = convertStringToInt(input);
+            if (megabytes > 0) exactMemoryLimitMB = megabytes;
+            std::cout << "Exact solver memory limit set to " << exactMemoryLimitMB << " MiB.\n";
+            break;
+        }
+
+        case Option::SET_RANDOM_SEED: {
+            std::string input;
+            std::cout << "Enter the random seed (0 = new random seed for every run): ";
+            std::cin >> input;
+            try {
+                randomSeed = std::stoull(input);
+            } catch (...) {
+                randomSeed = 0;
+            }
+            std::cout << "Random seed " << (randomSeed != 0 ? "set to " + std::to_string(randomSeed) : "disabled") << ".\n";
+            break;
+        }
+
+        case Option::SET_CONSTRUCTION: {
+            static const ConstructionType types[] = {ConstructionType::NEAREST_NEIGHBOR, ConstructionType::GREEDY_EDGE,
+                                                     ConstructionType::CHEAPEST_INSERTION, ConstructionType::FARTHEST_INSERTION,
+                                                     ConstructionType::PATCHING};
+            std::string input;
+            std::cout << "Start tours of Tabu Search and Simulated Annealing:\n"
+                      << "0. Solver default (random tour for Tabu Search, nearest neighbour for Simulated Annealing)\n"
+                      << "1. Nearest neighbour\n2. Greedy edge\n3. Cheapest insertion\n4. Farthest insertion\n5. Karp patching\n"
+                      << "Enter your choice: ";
+            std::cin >> input;
+            int choice = convertStringToInt(input);
+            if (choice < 0 || choice > 5) {
+                std::cerr << "Error: Invalid choice.\n";
+                break;
+            }
+            constructionSelected = choice > 0;
+            if (!constructionSelected) {
+                std::cout << "Solvers use their default start tours.\n";
+                break;
+            }
+            constructionType = types[choice - 1];
+            std::cout << "Start tours built with " << ConstructionHeuristic::typeName(constructionType) << ".\n";
+            if (isMatrixLoaded()) {
+                std::unique_ptr<ConstructionHeuristic> heuristic = ConstructionHeuristic::create(constructionType, distanceMatrix, getThreadPool());
+                auto start = std::chrono::high_resolution_clock::now();
+                std::vector<int> tour = heuristic->build();
+                double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+                std::cout << "Start tour cost on the loaded instance: " << heuristic->tourCost(tour) << " (built in " << seconds << " s)\n";
+            }
+            break;
+        }
+
+        case Option::RUN_PORTFOLIO: {
+            if (!isMatrixLoaded()) {
+                std::cerr << "Error: Distance matrix is empty.\n";
+                break;
+            }
+            if (portfolioSolver) delete portfolioSolver;
+            portfolioSolver = new PortfolioSolver(distanceMatrix, maxRunTime, temperatureChangeFactor, getThreadPool(), neighborhoodTypes, candidateList);
+            portfolioSolver->setStopLimits(getStopLimits());
+            portfolioSolver->setLocalSearch(localSearchEnabled);
+            if (randomSeed != 0) portfolioSolver->setSeed(randomSeed);
+            portfolioSolver->solve();
+            std::cout << "Portfolio Results:\n";
+            std::cout << "Best cost: " << portfolioSolver->getBestCost() << "\n";
+            std::cout << "Best tour: ";
+            for (int city : portfolioSolver->getBestTour()) {
+                std::cout << city << " ";
+            }
+            std::cout << std::endl;
+            std::cout << "Tiem stamp when found: " << portfolioSolver->getBestTourTimestamp() << "\n";
+            const std::vector<PortfolioSolver::WorkerResult> workers = portfolioSolver->getWorkerResults();
+            for (std::size_t index = 0; index < workers.size(); ++index) {
+                std::cout << "Worker " << index << " (" << PortfolioSolver::workerName(workers[index].solver) << "): best "
+                          << workers[index].bestCost << " at " << workers[index].bestTimestamp << " s, "
+                          << workers[index].iterations << " iterations, stopped by "
+                          << StopCriterion::reasonName(workers[index].stopReason) << "\n";
+            }
+            std::cout << "Tours accepted by the elite pool: " << portfolioSolver->getEliteAcceptedCount() << std::endl;
+            break;
+        }
+
+        case Option::RUN_MEMETIC: {
+            if (!isMatrixLoaded()) {
+                std::cerr << "Error: Distance matrix is empty.\n";
+                break;
+            }
+            if (memeticSolver) delete memeticSolver;
+            memeticSolver = new MemeticAlgorithm(distanceMatrix, maxRunTime, getThreadPool(), candidateList);
+            memeticSolver->setPopulationSize(populationSize);
+            memeticSolver->setCrossover(crossoverType);
+            if (randomSeed != 0) memeticSolver->setSeed(randomSeed);
+            memeticSolver->solve();
+            std::cout << "Memetic Algorithm Results:\n";
+            std::cout << "Best cost: " << memeticSolver->getBestCost() << "\n";
+            std::cout << "Best tour: ";
+            for (int city : memeticSolver->getBestTour()) {
+                std::cout << city << " ";
+            }
+            std::cout << std::endl;
+            std::cout << "Tiem stamp when found: " << memeticSolver->getBestTourTimestamp() << "\n";
+            std::cout << "Offspring: " << memeticSolver->getOffspringCount() << ", accepted into the population: "
+                      << memeticSolver->getAcceptedCount() << std::endl;
+            break;
+        }
+
+        case Option::SET_MEMETIC: {
+            std::string input;
+            std::cout << "Enter the population size (at least 2): ";
+            std::cin >> input;
+            int size = convertStringToInt(input);
+            if (size >= 2) populationSize = size;
+            std::cout << "Crossover (eax = edge assembly, ox = order crossover): ";
+            std::cin >> input;
+            try {
+                crossoverType = MemeticAlgorithm::parseCrossover(input);
+            } catch (const std::invalid_argument& e) {
+                std::cerr << e.what() << std::endl;
+            }
+            std::cout << "Memetic algorithm: population " << populationSize << ", crossover "
+                      << MemeticAlgorithm::crossoverName(crossoverType) << ".\n";
+            break;
+        }
+
+        case Option::SET_TABU_MEMORY: {
+            std::string input;
+            std::cout << "Tabu attribute (arc = removed arcs may not return, position = moved positions may not move again): ";
+            std::cin >> input;
+            try {
+                tabuAttribute = TabuMemory::parseAttribute(input);
+            } catch (const std::invalid_argument& e) {
+                std::cerr << e.what() << std::endl;
+            }
+            std::cout << "Enter the tabu tenure in iterations (0 = reactive tenure): ";
+            std::cin >> input;
+            int tenure = convertStringToInt(input);
+            if (tenure >= 0) tabuTenure = tenure;
+            std::cout << "Tabu memory: " << TabuMemory::attributeName(tabuAttribute) << " attributes, "
+                      << (tabuTenure == TabuMemory::REACTIVE_TENURE ? std::string("reactive tenure") : "tenure " + std::to_string(tabuTenure)) << ".\n";
+            break;
+        }
+
+        case Option::SET_REACTIVE_TABU: {
+            std::string input;
+            std::cout << "Run Tabu Search in intensification and diversification phases? (1 = yes, 0 = no): ";
+            std::cin >> input;
+            reactiveTabu = convertStringToInt(input) == 1;
+            if (reactiveTabu) {
+                std::cout << "Enter the iterations without improvement that end a phase (0 = twice the number of cities): ";
+                std::cin >> input;
+                int iterations = convertStringToInt(input);
+                if (iterations >= 0) tabuStagnation = iterations;
+            }
+            std::cout << "Reactive Tabu Search " << (reactiveTabu ? "enabled" : "disabled") << ".\n";
+            break;
+        }
+
+        case Option::SET_ANNEALING_SCHEDULE: {
+            std::string input;
+            std::cout << "Cooling schedule (geometric = T times the cooling factor per epoch, lundy-mees, adaptive = acceptance rate targeting): ";
+            std::cin >> input;
+            try {
+                coolingSchedule = AnnealingSchedule::parseSchedule(input);
+            } catch (const std::invalid_argument& e) {
+                std::cerr << e.what() << std::endl;
+            }
+            std::cout << "Enter the proposals per city in one epoch at a constant temperature (default " << AnnealingSchedule::DEFAULT_EPOCH_FACTOR << "): ";
+            std::cin >> input;
+            int proposals = convertStringToInt(input);
+            if (proposals > 0) epochFactor = proposals;
+            std::cout << "Cooling schedule: " << AnnealingSchedule::scheduleName(coolingSchedule) << ", epochs of "
+                      << epochFactor << " proposals per city.\n";
+            break;
+        }
+
         case Option::INVALID_INPUT:
             std::cerr << "Invalid input. Please try again.\n";
             break;
@@ -235,44 +729,60 @@ void handleMenuOption(Option selectedOption) {
 }
 
 /**
- * Loads the adjacency matrix from a specified file. The file must follow the ATSP format.
- * @param filePath - The path to the file containing the matrix data.
- * @return The loaded matrix as a 2D vector.
+ * Loads an instance from its binary cache, or parses the TSPLIB file with the memory-mapped TsplibLoader
+ * and creates the cache for the next load. A cache that cannot be written is reported and skipped.
+ * @param filePath - The path to the file containing the instance.
+ * @return The loaded instance, its matrix stored flat and with the transposed copy built.
  */
-std::vector<std::vector<int>> loadMatrixFromFile(const std::string& filePath) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        throw std::runtime_error("Error: Unable to open file " + filePath);
-    }
-
-    std::string line;
-    std::vector<int> weights;
-    int dimension = 0;
+TsplibInstance loadMatrixFromFile(const std::string& filePath) {
+    return MatrixCache::loadOrParse(filePath);
+}
 
-    while (std::getline(file, line)) {
-        if (line.find("DIMENSION") != std::string::npos) {
-            dimension = std::stoi(line.substr(line.find(":") + 1));
-        } else if (line.find("EDGE_WEIGHT_SECTION") != std::string::npos) {
-            break;
-        }
+/**
+ * Runs the batch experiments described by the command line and writes the results as CSV,
+ * to the --out file or to standard output.
+ * @param argc - Number of command line arguments.
+ * @param argv - The command line arguments.
+ * @return The process exit code: 0 on success, 1 on invalid arguments or a failed experiment.
+ */
+int runExperiments(int argc, char* argv[]) {
+    ExperimentConfig config;
+    try {
+        config = ExperimentRunner::parseArguments(argc, argv);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n\n" << ExperimentRunner::usage();
+        return 1;
     }
-
-    while (std::getline(file, line)) {
-        if (line == "EOF") break;
-        std::istringstream iss(line);
-        int weight;
-        while (iss >> weight) {
-            weights.push_back(weight);
-        }
+    if (config.showHelp) {
+        std::cout << ExperimentRunner::usage();
+        return 0;
     }
 
-    std::vector<std::vector<int>> matrix(dimension, std::vector<int>(dimension));
-    for (int i = 0; i < dimension; ++i) {
-        for (int j = 0; j < dimension; ++j) {
-            matrix[i][j] = weights[i * dimension + j];
+    try {
+        std::ofstream outFile;
+        if (!config.outputPath.empty()) {
+            outFile.open(config.outputPath);
+            if (!outFile.is_open()) {
+                throw std::runtime_error("Error: Could not open file " + config.outputPath + " for writing.");
+            }
         }
+        ExperimentRunner runner(config);
+        std::vector<ExperimentResult> results = runner.run();
+        ExperimentRunner::writeCsv(config.outputPath.empty() ? std::cout : outFile, results);
+        if (!config.outputPath.empty()) std::cerr << "Results written to " << config.outputPath << ".\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
     }
-    return matrix;
+    return 0;
+}
+
+/**
+ * Checks whether a non-empty distance matrix has been loaded.
+ * @return True if the solvers can be run.
+ */
+bool isMatrixLoaded() {
+    return distanceMatrix && !distanceMatrix->empty();
 }
 
 /**
@@ -293,7 +803,7 @@ int convertStringToInt(const std::string& input) {
  * Ensures the data matches the loaded distance matrix.
  */
 void loadCostTable() {
-    if (distanceMatrix.empty()) {
+    if (!isMatrixLoaded()) {
         std::cerr << "Error: Distance matrix is not loaded. Please load a dataset first.\n";
         return;
     }
@@ -329,21 +839,23 @@ void loadCostTable() {
 
         inFile.close();
 
-        if (numberOfVertices != static_cast<int>(distanceMatrix.size())) {
+        const DistanceMatrix& matrix = *distanceMatrix;
+        if (numberOfVertices != matrix.size()) {
             throw std::runtime_error("Error: Number of vertices in the file does not match the loaded distance matrix.");
         }
         if (tour.empty()) {
             throw std::runtime_error("Error: Tour information is missing or invalid in the file.");
         }
 
-        int totalCost = 0;
-        for (size_t i = 0; i < tour.size() - 1; ++i) {
-            if (tour[i] >= numberOfVertices || tour[i + 1] >= numberOfVertices) {
+        for (int vertex : tour) {
+            if (vertex < 0 || vertex >= numberOfVertices) {
                 throw std::runtime_error("Error: Invalid vertex in the tour.");
             }
-            totalCost += distanceMatrix[tour[i]][tour[i + 1]];
         }
-        totalCost += distanceMatrix[tour[distanceMatrix.size()-1]][tour[0]];
+        // Greedy, Simulated Annealing and the exact solvers save closed tours, Tabu Search saves open ones
+        bool closed = tour.size() > 1 && tour.front() == tour.back();
+        int totalCost = closed ? TourKernels::pathCost(matrix, tour.data(), tour.size())
+                               : TourKernels::cycleCost(matrix, tour.data(), tour.size());
 
         std::cout << "Loaded Tour Cost: " << totalCost << "\n";
         std::cout << "Tour: ";
@@ -366,6 +878,32 @@ void setMaxRunTime(long seconds) {
     maxRunTime = (seconds > 0 && seconds <= 36000) ? seconds : 60;
 }
 
+/**
+ * Converts a string to an iteration count or cost.
+ * @param input - The input string.
+ * @return The value, or 0 if the input is not a number.
+ */
+long long convertStringToLimit(const std::string& input) {
+    try {
+        return std::stoll(input);
+    } catch (...) {
+        return 0;
+    }
+}
+
+/**
+ * Collects the stop criterion of Tabu Search, Simulated Annealing and the portfolio.
+ * @return The time limit, iteration limits and target cost set in the menu.
+ */
+StopLimits getStopLimits() {
+    StopLimits limits;
+    limits.seconds = static_cast<double>(maxRunTime);
+    limits.iterations = iterationLimit;
+    limits.stallIterations = stallIterationLimit;
+    limits.targetCost = targetCost;
+    return limits;
+}
+
 /**
  * Sets the cooling factor for Simulated Annealing.
  * Ensures the value is within the range [0.8, 0.99].
@@ -375,6 +913,73 @@ void setTemperatureChangeFactor(float factor) {
     temperatureChangeFactor = (factor >= 0.8 && factor < 1) ? factor : 0.85;
 }
 
+/**
+ * Sets the number of worker threads and drops the current pool, so the next run uses the new size.
+ * Values outside [0, 1024] fall back to 0 (one thread per hardware thread).
+ * @param count - Number of worker threads.
+ */
+void setThreadCount(int count) {
+    threadCount = (count >= 0 && count <= 1024) ? count : 0;
+    delete threadPool;
+    threadPool = nullptr;
+}
+
+/**
+ * Selects the neighbourhoods from a string of digits (1 = swap, 2 = or-opt, 3 = segment exchange).
+ * An empty or invalid selection falls back to swap and or-opt.
+ * @param selection - Digits of the selected neighbourhoods.
+ */
+void setNeighborhoodTypes(const std::string& selection) {
+    std::vector<NeighborhoodType> selected;
+    for (char digit : selection) {
+        NeighborhoodType type;
+        switch (digit) {
+            case '1': type = NeighborhoodType::SWAP; break;
+            case '2': type = NeighborhoodType::OR_OPT; break;
+            case '3': type = NeighborhoodType::SEGMENT_EXCHANGE; break;
+            default: continue;
+        }
+        if (std::find(selected.begin(), selected.end(), type) == selected.end()) {
+            selected.push_back(type);
+        }
+    }
+    neighborhoodTypes = selected.empty()
+        ? std::vector<NeighborhoodType>{NeighborhoodType::SWAP, NeighborhoodType::OR_OPT}
+        : selected;
+}
+
+/**
+ * Sets the number of nearest neighbours kept per city and rebuilds the candidate lists.
+ * Values outside [0, 1000] fall back to 10.
+ * @param size - Number of candidates per city, 0 disables the candidate lists.
+ */
+void setCandidateListSize(int size) {
+    candidateListSize = (size >= 0 && size <= 1000) ? size : 10;
+    rebuildCandidateList();
+}
+
+/**
+ * Builds the candidate lists of the loaded matrix, or drops them if they are disabled.
+ */
+void rebuildCandidateList() {
+    if (isMatrixLoaded() && candidateListSize > 0) {
+        candidateList = std::make_shared<const CandidateList>(*distanceMatrix, candidateListSize);
+    } else {
+        candidateList.reset();
+    }
+}
+
+/**
+ * Returns the shared worker pool, creating it with the configured number of threads on first use.
+ * @return The thread pool.
+ */
+ThreadPool* getThreadPool() {
+    if (!threadPool) {
+        threadPool = new ThreadPool(threadCount);
+    }
+    return threadPool;
+}
+
 /**
  * Waits for the user to press "Enter" to continue.
  */